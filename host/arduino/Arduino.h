@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * @file    Arduino.h
+ * @brief   Arduino core API of the Linux host build.
+ *
+ *          Enough of the AVR core for the sketch and its libraries to
+ *          compile unchanged. Time is virtual: every call below costs about
+ *          what it does on a 16 MHz Mega and moves the simulated clock of
+ *          sim.h forward, delay() jumps it.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Before the min()/max() macros below, the C++ headers would not parse after
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include <avr/pgmspace.h>
+
+// The build passes ARDUINO, F_CPU and the board on the command line as the
+// IDE does, these cover a file compiled without them
+#ifndef ARDUINO
+#define ARDUINO               10819
+#endif
+#ifndef F_CPU
+#define F_CPU                 16000000UL
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH                  0x1
+#define LOW                   0x0
+
+#define INPUT                 0x0
+#define OUTPUT                0x1
+#define INPUT_PULLUP          0x2
+
+#define CHANGE                1
+#define FALLING               2
+#define RISING                3
+
+// An enum as in the newer cores, Adafruit_BusIO takes a BitOrder
+enum BitOrder
+{
+  LSBFIRST = 0,
+  MSBFIRST = 1
+};
+
+#define PI                    3.1415926535897932384626433832795
+#define HALF_PI               1.5707963267948966192313216916398
+#define TWO_PI                6.283185307179586476925286766559
+#define DEG_TO_RAD            0.017453292519943295769236907684886
+#define RAD_TO_DEG            57.295779513082320876798154814105
+
+#define NUM_DIGITAL_PINS      70
+#define NUM_ANALOG_INPUTS     16
+
+#define PIN_A0                54
+static const uint8_t A0 = 54, A1 = 55, A2 = 56, A3 = 57, A4 = 58, A5 = 59,
+                     A6 = 60, A7 = 61, A8 = 62, A9 = 63, A10 = 64, A11 = 65,
+                     A12 = 66, A13 = 67, A14 = 68, A15 = 69;
+static const uint8_t SS = 53, MOSI = 51, MISO = 50, SCK = 52;
+static const uint8_t SDA = 20, SCL = 21;
+#define LED_BUILTIN           13
+
+// External interrupts of the Mega
+#define digitalPinToInterrupt(p) \
+  ((p) == 2 ? 0 : ((p) == 3 ? 1 : ((p) >= 18 && (p) <= 21 ? 23 - (p) : -1)))
+#define NOT_AN_INTERRUPT      -1
+
+#define min(a, b)             ((a) < (b) ? (a) : (b))
+#define max(a, b)             ((a) > (b) ? (a) : (b))
+#define constrain(x, lo, hi)  ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#define sq(x)                 ((x) * (x))
+#define radians(deg)          ((deg) * DEG_TO_RAD)
+#define degrees(rad)          ((rad) * RAD_TO_DEG)
+
+#define lowByte(w)            ((uint8_t)((w) & 0xff))
+#define highByte(w)           ((uint8_t)((w) >> 8))
+#define bitRead(value, bit)   (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)    ((value) |= (1UL << (bit)))
+#define bitClear(value, bit)  ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b)                (1UL << (b))
+#ifndef _BV
+#define _BV(b)                (1 << (b))
+#endif
+
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000L)
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReference(uint8_t mode);
+void analogWrite(uint8_t pin, int value);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000L);
+
+void attachInterrupt(uint8_t irq, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t irq);
+
+void cli(void);
+void sei(void);
+#define interrupts()          sei()
+#define noInterrupts()        cli()
+
+void yield(void);
+
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+void setup(void);
+void loop(void);
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+
+#endif  // Arduino_h
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * @file    HardwareSerial.cpp
+ * @brief   The four UARTs of the Mega with the timing of the AVR core driver.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "Arduino.h"
+#include "HardwareSerial.h"
+#include "sim.h"
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+HardwareSerial Serial3(3);
+
+HardwareSerial::HardwareSerial(uint8_t index)
+    : index(index), baud(0), tx_done(0), rx_head(0), rx_tail(0)
+{
+}
+
+// Start, 8 data bits and stop
+uint64_t HardwareSerial::byte_time()
+{
+  return 10ULL * SIM_S / baud;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint8_t config)
+{
+  this->baud = baud;
+  tx_done = sim_now();
+  rx_head = rx_tail = 0;
+}
+
+void HardwareSerial::end()
+{
+  flush();
+  baud = 0;
+}
+
+int HardwareSerial::available(void)
+{
+  sim_advance(SIM_COST_UART_READ);
+  return (SERIAL_RX_BUFFER_SIZE + rx_head - rx_tail) % SERIAL_RX_BUFFER_SIZE;
+}
+
+int HardwareSerial::peek(void)
+{
+  sim_advance(SIM_COST_UART_READ);
+  return rx_head == rx_tail ? -1 : rx_buffer[rx_tail];
+}
+
+int HardwareSerial::read(void)
+{
+  sim_advance(SIM_COST_UART_READ);
+  if (rx_head == rx_tail)
+    return -1;
+
+  uint8_t data = rx_buffer[rx_tail];
+  rx_tail = (rx_tail + 1) % SERIAL_RX_BUFFER_SIZE;
+  return data;
+}
+
+int HardwareSerial::availableForWrite(void)
+{
+  if (!baud)
+    return 0;
+
+  uint64_t now = sim_now();
+  uint64_t queued = tx_done > now ? (tx_done - now) / byte_time() : 0;
+
+  return queued >= SERIAL_TX_BUFFER_SIZE - 1 ? 0 : SERIAL_TX_BUFFER_SIZE - 1 - queued;
+}
+
+void HardwareSerial::flush(void)
+{
+  if (baud && tx_done > sim_now())
+    sim_advance_to(tx_done);
+}
+
+size_t HardwareSerial::write(uint8_t data)
+{
+  if (!baud)
+    return 0;
+
+  sim_advance(SIM_COST_UART_WRITE);
+
+  // The buffer holds SERIAL_TX_BUFFER_SIZE - 1 bytes on top of the one
+  // being shifted out, wait for room like the core's busy loop
+  uint64_t limit = (SERIAL_TX_BUFFER_SIZE - 1) * byte_time();
+
+  if (tx_done > sim_now() + limit)
+    sim_advance_to(tx_done - limit);
+
+  tx_done = max(tx_done, sim_now()) + byte_time();
+
+  if (index == 0)
+  {
+    sim_stats.serial_tx_bytes++;
+    if (sim_console)
+      fputc(data, sim_console);
+  }
+  return 1;
+}
+
+void HardwareSerial::sim_receive(uint8_t data)
+{
+  uint8_t head = (rx_head + 1) % SERIAL_RX_BUFFER_SIZE;
+
+  if (!baud)
+    return;
+
+  if (head == rx_tail)
+  {
+    sim_stats.serial_rx_overruns++;
+    return;
+  }
+
+  rx_buffer[rx_head] = data;
+  rx_head = head;
+}
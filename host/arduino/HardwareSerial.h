@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * @file    HardwareSerial.h
+ * @brief   The four UARTs of the Mega with the timing of the AVR core driver.
+ *
+ *          Writes queue into a 64 byte TX buffer that drains at the baud
+ *          rate and block while it is full. Bytes of a simulated device
+ *          arrive into a 64 byte RX buffer and are lost when it is full.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include <stdio.h>
+
+#include "Stream.h"
+
+#define SERIAL_TX_BUFFER_SIZE 64
+#define SERIAL_RX_BUFFER_SIZE 64
+
+#define SERIAL_8N1            0x06
+
+class HardwareSerial : public Stream
+{
+  public:
+    HardwareSerial(uint8_t index);
+
+    void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
+    void begin(unsigned long baud, uint8_t config);
+    void end();
+
+    virtual int available(void);
+    virtual int peek(void);
+    virtual int read(void);
+    virtual int availableForWrite(void);
+    virtual void flush(void);
+    virtual size_t write(uint8_t data);
+
+    using Print::write;
+
+    operator bool() { return true; }
+
+    // A byte from the simulated device on the other end has arrived
+    void sim_receive(uint8_t data);
+
+  private:
+    uint64_t byte_time();
+
+    uint8_t index;
+    unsigned long baud;
+    uint64_t tx_done;
+    uint8_t rx_buffer[SERIAL_RX_BUFFER_SIZE];
+    uint8_t rx_head;
+    uint8_t rx_tail;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
+
+#endif  // HardwareSerial_h
@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * @file    Print.cpp
+ * @brief   Print of the Arduino AVR core.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <math.h>
+
+#include "Arduino.h"
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+
+  while (size--)
+  {
+    if (write(*buffer++))
+      n++;
+    else
+      break;
+  }
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *ifsh)
+{
+  return print(reinterpret_cast<const char *>(ifsh));
+}
+
+size_t Print::print(const String &s)
+{
+  return write(s.c_str(), s.length());
+}
+
+size_t Print::print(const char str[])
+{
+  return write(str);
+}
+
+size_t Print::print(char c)
+{
+  return write(c);
+}
+
+size_t Print::print(unsigned char b, int base)
+{
+  return print((unsigned long)b, base);
+}
+
+size_t Print::print(int n, int base)
+{
+  return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+  if (base == 0)
+    return write(n);
+
+  if (base == 10 && n < 0)
+  {
+    int t = print('-');
+    return printNumber(-(unsigned long)n, 10) + t;
+  }
+  // Same as the 32-bit long of the AVR core for the other bases
+  return printNumber((uint32_t)n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  if (base == 0)
+    return write(n);
+  return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+  return printFloat(n, digits);
+}
+
+size_t Print::print(const Printable &x)
+{
+  return x.printTo(*this);
+}
+
+size_t Print::println(void)
+{
+  return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *ifsh)
+{
+  size_t n = print(ifsh);
+  return n + println();
+}
+
+size_t Print::println(const String &s)
+{
+  size_t n = print(s);
+  return n + println();
+}
+
+size_t Print::println(const char c[])
+{
+  size_t n = print(c);
+  return n + println();
+}
+
+size_t Print::println(char c)
+{
+  size_t n = print(c);
+  return n + println();
+}
+
+size_t Print::println(unsigned char b, int base)
+{
+  size_t n = print(b, base);
+  return n + println();
+}
+
+size_t Print::println(int num, int base)
+{
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned int num, int base)
+{
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(long num, int base)
+{
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned long num, int base)
+{
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(double num, int digits)
+{
+  size_t n = print(num, digits);
+  return n + println();
+}
+
+size_t Print::println(const Printable &x)
+{
+  size_t n = print(x);
+  return n + println();
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+
+  *str = '\0';
+
+  if (base < 2)
+    base = 10;
+
+  do
+  {
+    char c = n % base;
+    n /= base;
+
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+
+  return write(str);
+}
+
+// The AVR core rounds in float, a double is a float on the Mega
+size_t Print::printFloat(double number, uint8_t digits)
+{
+  float value = number;
+  size_t n = 0;
+
+  if (isnan(value))
+    return print("nan");
+  if (isinf(value))
+    return print("inf");
+  if (value > 4294967040.0f)
+    return print("ovf");
+  if (value < -4294967040.0f)
+    return print("ovf");
+
+  if (value < 0.0f)
+  {
+    n += print('-');
+    value = -value;
+  }
+
+  float rounding = 0.5f;
+  for (uint8_t i = 0; i < digits; ++i)
+    rounding /= 10.0f;
+
+  value += rounding;
+
+  unsigned long int_part = (unsigned long)value;
+  float remainder = value - (float)int_part;
+  n += print(int_part);
+
+  if (digits > 0)
+    n += print('.');
+
+  while (digits-- > 0)
+  {
+    remainder *= 10.0f;
+    unsigned int to_print = (unsigned int)remainder;
+    n += print(to_print);
+    remainder -= to_print;
+  }
+
+  return n;
+}
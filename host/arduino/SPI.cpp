@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * @file    SPI.cpp
+ * @brief   SPIClass of the AVR core over the simulated SPI bus.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "SPI.h"
+#include "bus.h"
+
+// Loop and SPDR handling around each byte
+#define SPI_BYTE_OVERHEAD_NS  250
+
+SPIClass SPI;
+uint32_t SPIClass::clock = 4000000;
+
+void SPIClass::begin()
+{
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+  clock = min(settings.clock, F_CPU / 2);
+  sim_stats.spi_transactions++;
+}
+
+void SPIClass::endTransaction()
+{
+}
+
+void SPIClass::setClockDivider(uint8_t clockDiv)
+{
+  static const uint8_t dividers[] = {4, 16, 64, 128, 2, 8, 32, 128};
+
+  clock = F_CPU / dividers[clockDiv & 0x07];
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  Sim_SPI_Device *device = sim_spi_selected();
+  uint8_t in = 0xFF;
+
+  sim_advance(8ULL * SIM_S / clock + SPI_BYTE_OVERHEAD_NS);
+  sim_stats.spi_bytes++;
+
+  if (device)
+  {
+    in = device->spi_transfer(data);
+    device->bytes++;
+  }
+  return in;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data)
+{
+  uint16_t in = transfer(data >> 8) << 8;
+
+  return in | transfer(data & 0xFF);
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+  uint8_t *p = (uint8_t *)buf;
+
+  while (count--)
+  {
+    *p = transfer(*p);
+    p++;
+  }
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * @file    SPI.h
+ * @brief   SPIClass of the AVR core over the simulated SPI bus.
+ *
+ *          A byte goes to the device whose chip select pin is low. It takes
+ *          8 clocks at the transaction's rate, capped at F_CPU / 2 as on the
+ *          Mega, plus the loop around the SPDR access.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include <Arduino.h>
+
+#define SPI_HAS_TRANSACTION   1
+#define SPI_HAS_NOTUSINGINTERRUPT 1
+
+#define SPI_MODE0             0x00
+#define SPI_MODE1             0x04
+#define SPI_MODE2             0x08
+#define SPI_MODE3             0x0C
+
+#define SPI_CLOCK_DIV4        0x00
+#define SPI_CLOCK_DIV16       0x01
+#define SPI_CLOCK_DIV64       0x02
+#define SPI_CLOCK_DIV128      0x03
+#define SPI_CLOCK_DIV2        0x04
+#define SPI_CLOCK_DIV8        0x05
+#define SPI_CLOCK_DIV32       0x06
+
+class SPISettings
+{
+  public:
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+        : clock(clock), bit_order(bitOrder), data_mode(dataMode) {}
+    SPISettings() : clock(4000000), bit_order(MSBFIRST), data_mode(SPI_MODE0) {}
+
+    uint32_t clock;
+    uint8_t bit_order;
+    uint8_t data_mode;
+};
+
+class SPIClass
+{
+  public:
+    static void begin();
+    static void end();
+
+    static void beginTransaction(SPISettings settings);
+    static void endTransaction();
+    static void usingInterrupt(uint8_t interruptNumber) {}
+    static void notUsingInterrupt(uint8_t interruptNumber) {}
+
+    static uint8_t transfer(uint8_t data);
+    static uint16_t transfer16(uint16_t data);
+    static void transfer(void *buf, size_t count);
+
+    static void setBitOrder(uint8_t bitOrder) {}
+    static void setDataMode(uint8_t dataMode) {}
+    static void setClockDivider(uint8_t clockDiv);
+
+  private:
+    static uint32_t clock;
+};
+
+extern SPIClass SPI;
+
+#endif  // _SPI_H_INCLUDED
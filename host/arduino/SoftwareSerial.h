@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * @file    SoftwareSerial.h
+ * @brief   SoftwareSerial without a device behind it, the GPS is not simulated.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef SoftwareSerial_h
+#define SoftwareSerial_h
+
+#include <Arduino.h>
+
+class SoftwareSerial : public Stream
+{
+  public:
+    SoftwareSerial(uint8_t rx_pin, uint8_t tx_pin, bool inverse = false) {}
+
+    void begin(long speed) {}
+    void end() {}
+    bool listen() { return true; }
+    bool isListening() { return true; }
+    bool overflow() { return false; }
+
+    virtual size_t write(uint8_t byte) { return 1; }
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+
+    operator bool() { return true; }
+
+    using Print::write;
+};
+
+#endif  // SoftwareSerial_h
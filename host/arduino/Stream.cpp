@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * @file    Stream.cpp
+ * @brief   Stream of the Arduino AVR core.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "Arduino.h"
+#include "Stream.h"
+
+int Stream::timedRead()
+{
+  int c;
+
+  start_millis = millis();
+  do
+  {
+    c = read();
+    if (c >= 0)
+      return c;
+    yield();
+  } while (millis() - start_millis < timeout);
+
+  return -1;
+}
+
+bool Stream::find(const char *target)
+{
+  return find(target, strlen(target));
+}
+
+bool Stream::find(const char *target, size_t length)
+{
+  size_t index = 0;
+
+  if (length == 0)
+    return true;
+
+  int c;
+  while ((c = timedRead()) >= 0)
+  {
+    if (c == target[index])
+    {
+      if (++index >= length)
+        return true;
+    }
+    else
+    {
+      index = (c == target[0]) ? 1 : 0;
+    }
+  }
+  return false;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+
+  while (count < length)
+  {
+    int c = timedRead();
+    if (c < 0)
+      break;
+    *buffer++ = (char)c;
+    count++;
+  }
+  return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+  size_t index = 0;
+
+  while (index < length)
+  {
+    int c = timedRead();
+    if (c < 0 || c == terminator)
+      break;
+    *buffer++ = (char)c;
+    index++;
+  }
+  return index;
+}
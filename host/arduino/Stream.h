@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * @file    Stream.h
+ * @brief   Stream of the Arduino AVR core, timeouts run on virtual time.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print
+{
+  public:
+    Stream() : timeout(1000), start_millis(0) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    unsigned long getTimeout(void) { return timeout; }
+
+    bool find(const char *target);
+    bool find(const char *target, size_t length);
+
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length)
+    {
+      return readBytes((char *)buffer, length);
+    }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length);
+
+  protected:
+    int timedRead();
+
+    unsigned long timeout;
+    unsigned long start_millis;
+};
+
+#endif  // Stream_h
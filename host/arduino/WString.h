@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * @file    WString.h
+ * @brief   The part of the Arduino String class the libraries use.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef String_class_h
+#define String_class_h
+
+#include <string>
+
+class __FlashStringHelper;
+#define F(string_literal)     (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+#ifndef PSTR
+#define PSTR(s)               (s)
+#endif
+
+class String
+{
+  public:
+    String(const char *cstr = "") : value(cstr ? cstr : "") {}
+    String(const __FlashStringHelper *str) : value(reinterpret_cast<const char *>(str)) {}
+    String(char c) : value(1, c) {}
+    String(int n) : value(std::to_string(n)) {}
+    String(unsigned int n) : value(std::to_string(n)) {}
+    String(long n) : value(std::to_string(n)) {}
+    String(unsigned long n) : value(std::to_string(n)) {}
+
+    const char *c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.length(); }
+    char operator[](unsigned int index) const { return value[index]; }
+
+    bool concat(const String &s) { value += s.value; return true; }
+    bool concat(const char *s) { value += s; return true; }
+    bool concat(char c) { value += c; return true; }
+    String &operator+=(const String &s) { concat(s); return *this; }
+    String &operator+=(const char *s) { concat(s); return *this; }
+    String &operator+=(char c) { concat(c); return *this; }
+
+    bool operator==(const String &s) const { return value == s.value; }
+    bool operator==(const char *s) const { return value == s; }
+    bool operator!=(const String &s) const { return value != s.value; }
+
+  private:
+    std::string value;
+};
+
+inline String operator+(const String &a, const String &b)
+{
+  String s(a);
+  s += b;
+  return s;
+}
+
+#endif  // String_class_h
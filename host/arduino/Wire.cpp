@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * @file    Wire.cpp
+ * @brief   TwoWire of the AVR core over the simulated I2C bus.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "Wire.h"
+#include "bus.h"
+
+// Time the twi driver spends around a transaction (start, stop, ISR calls)
+#define WIRE_OVERHEAD_NS      12000
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : clock(100000), tx_address(0), tx_length(0), transmitting(false),
+      rx_index(0), rx_length(0)
+{
+}
+
+void TwoWire::begin()
+{
+  rx_index = rx_length = 0;
+  tx_length = 0;
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+  this->clock = clock;
+}
+
+// Start, address, bytes and stop: 9 bits per byte plus about 2 bits framing
+void TwoWire::charge(uint8_t bytes)
+{
+  sim_advance(WIRE_OVERHEAD_NS + (9ULL * (bytes + 1) + 2) * SIM_S / clock);
+  sim_stats.i2c_transactions++;
+  sim_stats.i2c_bytes += bytes;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  tx_address = address;
+  tx_length = 0;
+  transmitting = true;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t stop)
+{
+  transmitting = false;
+
+  if (tx_address == 0x00)
+  {
+    charge(tx_length);
+    for (Sim_I2C_Device *d = sim_i2c_devices(); d; d = d->next_on_bus)
+    {
+      if (!d->unplugged)
+        d->i2c_general_call(tx_buffer, tx_length);
+    }
+    return 0;
+  }
+
+  Sim_I2C_Device *device = sim_i2c_find(tx_address);
+
+  if (!device || !device->i2c_write(tx_buffer, tx_length))
+  {
+    charge(0);
+    sim_stats.i2c_nacks++;
+    return 2;
+  }
+
+  charge(tx_length);
+  device->transactions++;
+  device->bytes += tx_length;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t stop)
+{
+  if (quantity > BUFFER_LENGTH)
+    quantity = BUFFER_LENGTH;
+
+  rx_index = 0;
+  rx_length = 0;
+
+  Sim_I2C_Device *device = sim_i2c_find(address);
+
+  if (!device)
+  {
+    charge(0);
+    sim_stats.i2c_nacks++;
+    return 0;
+  }
+
+  memset(rx_buffer, 0xFF, quantity);
+  device->i2c_read(rx_buffer, quantity);
+  device->transactions++;
+  device->bytes += quantity;
+  charge(quantity);
+
+  rx_length = quantity;
+  return quantity;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (!transmitting || tx_length >= BUFFER_LENGTH)
+  {
+    setWriteError();
+    return 0;
+  }
+
+  tx_buffer[tx_length++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  for (size_t i = 0; i < quantity; i++)
+  {
+    if (!write(data[i]))
+      return i;
+  }
+  return quantity;
+}
+
+int TwoWire::available()
+{
+  return rx_length - rx_index;
+}
+
+int TwoWire::read()
+{
+  return rx_index < rx_length ? rx_buffer[rx_index++] : -1;
+}
+
+int TwoWire::peek()
+{
+  return rx_index < rx_length ? rx_buffer[rx_index] : -1;
+}
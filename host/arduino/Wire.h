@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * @file    Wire.h
+ * @brief   TwoWire of the AVR core over the simulated I2C bus.
+ *
+ *          Same 32 byte buffers and return codes as the twi driver. A
+ *          transaction takes its bit time at the bus clock plus the driver
+ *          overhead, see sim/bus.h for the devices.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH         32
+#define WIRE_HAS_END          1
+
+class TwoWire : public Stream
+{
+  public:
+    TwoWire();
+
+    void begin();
+    void end();
+    void setClock(uint32_t clock);
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(uint8_t stop);
+    uint8_t endTransmission() { return endTransmission(true); }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t stop);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity)
+    {
+      return requestFrom(address, quantity, (uint8_t)true);
+    }
+    uint8_t requestFrom(int address, int quantity)
+    {
+      return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)true);
+    }
+    uint8_t requestFrom(int address, int quantity, int stop)
+    {
+      return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)stop);
+    }
+
+    virtual size_t write(uint8_t data);
+    virtual size_t write(const uint8_t *data, size_t quantity);
+    virtual int available();
+    virtual int read();
+    virtual int peek();
+    virtual void flush() {}
+
+    using Print::write;
+
+  private:
+    void charge(uint8_t bytes);
+
+    uint32_t clock;
+    uint8_t tx_address;
+    uint8_t tx_buffer[BUFFER_LENGTH];
+    uint8_t tx_length;
+    bool transmitting;
+    uint8_t rx_buffer[BUFFER_LENGTH];
+    uint8_t rx_index;
+    uint8_t rx_length;
+};
+
+extern TwoWire Wire;
+
+#endif  // TwoWire_h
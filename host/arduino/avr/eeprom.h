@@ -0,0 +1,19 @@
+/*******************************************************************************
+ * @file    avr/eeprom.h
+ * @brief   EEPROM of the host build, see sim_eeprom_open() to keep it in a
+ *          file between runs.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_EEPROM_H
+#define _HOST_EEPROM_H
+
+#include <stdint.h>
+
+#define E2END                 0x0FFF
+
+uint32_t eeprom_read_dword(const uint32_t *address);
+void eeprom_update_dword(uint32_t *address, uint32_t value);
+
+#endif  // _HOST_EEPROM_H
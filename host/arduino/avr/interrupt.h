@@ -0,0 +1,18 @@
+/*******************************************************************************
+ * @file    avr/interrupt.h
+ * @brief   Interrupt vectors of the host build, called by the simulation.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_AVR_INTERRUPT_H
+#define _HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)      extern "C" void vector(void); extern "C" void vector(void)
+
+void cli(void);
+void sei(void);
+
+#endif  // _HOST_AVR_INTERRUPT_H
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * @file    avr/io.h
+ * @brief   The few ATmega2560 registers the sketch touches directly.
+ *
+ *          USART0 is emulated by sim/usart0.cpp, UDR0 and UCSR0A are proxies
+ *          so that writes reach the emulation.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_AVR_IO_H
+#define _HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#ifndef _BV
+#define _BV(b)                (1 << (b))
+#endif
+#define bit_is_set(sfr, b)    ((sfr) & _BV(b))
+#define bit_is_clear(sfr, b)  (!((sfr) & _BV(b)))
+
+// UCSR0A
+#define MPCM0                 0
+#define U2X0                  1
+#define UPE0                  2
+#define DOR0                  3
+#define FE0                   4
+#define UDRE0                 5
+#define TXC0                  6
+#define RXC0                  7
+// UCSR0B
+#define TXB80                 0
+#define RXB80                 1
+#define UCSZ02                2
+#define TXEN0                 3
+#define RXEN0                 4
+#define UDRIE0                5
+#define TXCIE0                6
+#define RXCIE0                7
+// UCSR0C
+#define UCPOL0                0
+#define UCSZ00                1
+#define UCSZ01                2
+
+#define SREG_I                7
+
+struct Usart0_Status_Reg
+{
+    Usart0_Status_Reg &operator=(uint8_t value);
+    operator uint8_t() const;
+};
+
+struct Usart0_Data_Reg
+{
+    Usart0_Data_Reg &operator=(uint8_t value);
+    operator uint8_t() const;
+};
+
+extern Usart0_Status_Reg UCSR0A;
+extern Usart0_Data_Reg UDR0;
+extern volatile uint8_t UCSR0B;
+extern volatile uint8_t UCSR0C;
+extern volatile uint8_t UBRR0H;
+extern volatile uint8_t UBRR0L;
+extern volatile uint8_t SREG;
+
+#endif  // _HOST_AVR_IO_H
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * @file    avr/pgmspace.h
+ * @brief   Flash access of the host build, flash is ordinary memory here.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_PGMSPACE_H
+#define _HOST_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                 const char *
+#define PGM_VOID_P            const void *
+#define PSTR(s)               (s)
+
+typedef char prog_char;
+typedef uint8_t prog_uchar;
+
+#define pgm_read_byte(addr)   (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)  (*(const uint32_t *)(addr))
+#define pgm_read_float(addr)  (*(const float *)(addr))
+#define pgm_read_ptr(addr)    (*(void *const *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#define memcpy_P              memcpy
+#define memcmp_P              memcmp
+#define strlen_P              strlen
+#define strcpy_P              strcpy
+#define strncpy_P             strncpy
+#define strcmp_P              strcmp
+#define strncmp_P             strncmp
+#define strcasecmp_P          strcasecmp
+#define strstr_P              strstr
+#define sprintf_P             sprintf
+#define snprintf_P            snprintf
+
+#endif  // _HOST_PGMSPACE_H
@@ -0,0 +1,28 @@
+/*******************************************************************************
+ * @file    avr/sleep.h
+ * @brief   Sleep modes of the host build, sleep_cpu() moves the clock to the
+ *          next interrupt.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_SLEEP_H
+#define _HOST_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE       0
+#define SLEEP_MODE_ADC        1
+#define SLEEP_MODE_PWR_DOWN   2
+#define SLEEP_MODE_PWR_SAVE   3
+#define SLEEP_MODE_STANDBY    6
+#define SLEEP_MODE_EXT_STANDBY 7
+
+void sim_sleep();
+
+static inline void set_sleep_mode(uint8_t mode) {}
+static inline void sleep_enable(void) {}
+static inline void sleep_disable(void) {}
+static inline void sleep_cpu(void) { sim_sleep(); }
+
+#endif  // _HOST_SLEEP_H
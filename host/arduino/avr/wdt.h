@@ -0,0 +1,28 @@
+/*******************************************************************************
+ * @file    avr/wdt.h
+ * @brief   Watchdog of the host build, a timeout aborts the simulation.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_WDT_H
+#define _HOST_WDT_H
+
+#include <stdint.h>
+
+#define WDTO_15MS             0
+#define WDTO_30MS             1
+#define WDTO_60MS             2
+#define WDTO_120MS            3
+#define WDTO_250MS            4
+#define WDTO_500MS            5
+#define WDTO_1S               6
+#define WDTO_2S               7
+#define WDTO_4S               8
+#define WDTO_8S               9
+
+void wdt_enable(uint8_t timeout);
+void wdt_disable(void);
+void wdt_reset(void);
+
+#endif  // _HOST_WDT_H
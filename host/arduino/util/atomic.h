@@ -0,0 +1,31 @@
+/*******************************************************************************
+ * @file    util/atomic.h
+ * @brief   ATOMIC_BLOCK of avr-libc over the simulated SREG.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _HOST_UTIL_ATOMIC_H
+#define _HOST_UTIL_ATOMIC_H
+
+#include <avr/interrupt.h>
+
+static inline uint8_t __iCliRetVal(void)
+{
+  cli();
+  return 1;
+}
+
+static inline void __iRestore(const uint8_t *sreg)
+{
+  if (*sreg & _BV(SREG_I))
+    sei();
+  else
+    cli();
+}
+
+#define ATOMIC_RESTORESTATE   uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = SREG
+#define ATOMIC_FORCEON        uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = _BV(SREG_I)
+#define ATOMIC_BLOCK(type)    for (type, __ToDo = __iCliRetVal(); __ToDo; __ToDo = 0)
+
+#endif  // _HOST_UTIL_ATOMIC_H
@@ -0,0 +1,97 @@
+# Runs the simulated pod and checks that a host tool gives back the text log
+# of the run, line for line:
+#
+#   cmake -DHOST=xpod_host -DTOOL=xpod_logcheck -DINPUT=text -DWORK=dir
+#         [-DBIN_HOST=...] [-DTELEMETRY_HOST=...] [-DFROM=... -DTO=...]
+#         -P round_trip.cmake
+#
+# INPUT is what the tool reads:
+#   text     the day's CSV log; with FROM and TO (xpod_extract) only the
+#            records of [FROM, TO) are expected
+#   bin      the day's .bin of a BIN_HOST run, the same cycles as the HOST
+#            run that writes the text log: the sim is deterministic
+#   console  the console of a TELEMETRY_HOST run, compared with that run's
+#            text log less its Seq and CRC columns
+cmake_minimum_required(VERSION 3.10)
+
+# Past a keyframe of the binary log and a minute of the index
+set(CYCLES 70)
+
+# A fresh card and EEPROM per run, --get leaves the card's files in dir/card
+function(run_pod host dir)
+  file(REMOVE_RECURSE ${dir})
+  file(MAKE_DIRECTORY ${dir}/card)
+  execute_process(
+    COMMAND ${host} --cycles ${CYCLES} --image ${dir}/sd.img --serial ${dir}/console
+            --get ${dir}/card
+    OUTPUT_QUIET RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${host} failed: ${result}")
+  endif()
+endfunction()
+
+# The day's file with extension ext, not the summaries next to it
+function(day_file dir ext var)
+  file(GLOB files ${dir}/card/*.${ext})
+  list(FILTER files INCLUDE REGEX "_[0-9]+_[0-9]+_[0-9]+\\.${ext}$")
+  list(LENGTH files count)
+  if(NOT count EQUAL 1)
+    message(FATAL_ERROR "expected one daily .${ext} on the card, found: ${files}")
+  endif()
+  set(${var} ${files} PARENT_SCOPE)
+endfunction()
+
+# The lines of a file as a list, the log's "\r\n" in front of each record and
+# the tools' after each line read the same
+function(read_lines path var)
+  file(READ ${path} text)
+  string(REPLACE "\r\n" "\n" text "${text}")
+  string(REGEX REPLACE "^\n+" "" text "${text}")
+  string(REGEX REPLACE "\n+$" "" text "${text}")
+  string(REPLACE "\n" ";" lines "${text}")
+  set(${var} "${lines}" PARENT_SCOPE)
+endfunction()
+
+run_pod(${HOST} ${WORK}/text)
+day_file(${WORK}/text txt log)
+set(args ${log})
+
+if(INPUT STREQUAL "bin")
+  run_pod(${BIN_HOST} ${WORK}/bin)
+  day_file(${WORK}/bin bin args)
+elseif(INPUT STREQUAL "console")
+  run_pod(${TELEMETRY_HOST} ${WORK}/text)
+  day_file(${WORK}/text txt log)
+  set(args ${WORK}/text/console)
+elseif(DEFINED FROM)
+  list(APPEND args ${FROM} ${TO})
+endif()
+
+execute_process(COMMAND ${TOOL} ${args} OUTPUT_FILE ${WORK}/tool.csv RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${TOOL} failed: ${result}")
+endif()
+
+read_lines(${log} lines)
+set(expected)
+foreach(line ${lines})
+  if(INPUT STREQUAL "console")
+    string(REGEX REPLACE ",[^,]*,[^,]*$" "" line "${line}")
+  endif()
+  # Records start with their time, the header does not
+  if(DEFINED FROM AND line MATCHES "^[0-9]" AND
+     (line STRLESS FROM OR NOT line STRLESS TO))
+    continue()
+  endif()
+  list(APPEND expected "${line}")
+endforeach()
+
+read_lines(${WORK}/tool.csv actual)
+list(LENGTH expected count)
+if(count LESS 10)
+  message(FATAL_ERROR "only ${count} lines in ${log}")
+endif()
+if(NOT actual STREQUAL expected)
+  message(FATAL_ERROR "${TOOL} output ${WORK}/tool.csv differs from ${log}")
+endif()
+message(STATUS "${count} lines as in ${log}")
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * @file    ads1115.cpp
+ * @brief   ADS1115 model: pointer, config and conversion registers.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "devices.h"
+
+#define ADS_REG_CONVERSION    0
+#define ADS_REG_CONFIG        1
+
+#define ADS_CONFIG_OS         0x8000
+#define ADS_CONFIG_MODE       0x0100
+#define ADS_CONFIG_DEFAULT    0x8583
+
+// The oscillator wakes up before a single shot conversion
+#define ADS_WAKEUP_NS         25000
+
+static const uint16_t data_rates[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+static const float full_scale[8] = {6.144, 4.096, 2.048, 1.024, 0.512, 0.256, 0.256, 0.256};
+
+Sim_ADS1115::Sim_ADS1115(const char *name, uint8_t address, float ain0, float ain1, float ain2, float ain3)
+    : Sim_I2C_Device(name, address), pointer(0), config(ADS_CONFIG_DEFAULT),
+      conversion(0), conv_done(SIM_NEVER)
+{
+  ain[0] = ain0;
+  ain[1] = ain1;
+  ain[2] = ain2;
+  ain[3] = ain3;
+  threshold[0] = 0x8000;
+  threshold[1] = 0x7FFF;
+}
+
+bool Sim_ADS1115::i2c_write(const uint8_t *data, uint8_t length)
+{
+  if (length == 0)
+    return true;
+
+  pointer = data[0] & 0x03;
+
+  if (length >= 3)
+  {
+    uint16_t value = (data[1] << 8) | data[2];
+
+    if (pointer == ADS_REG_CONFIG)
+      write_config(value);
+    else if (pointer > ADS_REG_CONFIG)
+      threshold[pointer - 2] = value;
+  }
+  return true;
+}
+
+uint8_t Sim_ADS1115::i2c_read(uint8_t *data, uint8_t length)
+{
+  uint16_t value;
+
+  switch (pointer)
+  {
+    case ADS_REG_CONVERSION:
+      value = conversion;
+      break;
+    case ADS_REG_CONFIG:
+      // OS reads 0 while a conversion is running
+      value = conv_done == SIM_NEVER || !(config & ADS_CONFIG_MODE) ? config | ADS_CONFIG_OS : config & ~ADS_CONFIG_OS;
+      break;
+    default:
+      value = threshold[pointer - 2];
+      break;
+  }
+
+  if (length > 0)
+    data[0] = value >> 8;
+  if (length > 1)
+    data[1] = value;
+  return min(length, (uint8_t)2);
+}
+
+void Sim_ADS1115::write_config(uint16_t value)
+{
+  sim_time_t period = SIM_S / data_rates[(value >> 5) & 0x07];
+
+  config = value & ~ADS_CONFIG_OS;
+
+  if (!(value & ADS_CONFIG_MODE))
+    conv_done = sim_now() + period;
+  else if (value & ADS_CONFIG_OS)
+    conv_done = sim_now() + ADS_WAKEUP_NS + period;
+}
+
+int16_t Sim_ADS1115::convert()
+{
+  float volts;
+
+  switch ((config >> 12) & 0x07)
+  {
+    case 0: volts = ain[0] - ain[1]; break;
+    case 1: volts = ain[0] - ain[3]; break;
+    case 2: volts = ain[1] - ain[3]; break;
+    case 3: volts = ain[2] - ain[3]; break;
+    default: volts = ain[((config >> 12) & 0x07) - 4]; break;
+  }
+
+  volts += 0.02f * volts * sim_wave(600) + sim_noise(0.0005f);
+
+  float code = volts / full_scale[(config >> 9) & 0x07] * 32768.0f;
+  return (int16_t)constrain(code, -32768.0f, 32767.0f);
+}
+
+void Sim_ADS1115::service(sim_time_t now)
+{
+  conversion = convert();
+
+  if (config & ADS_CONFIG_MODE)
+    conv_done = SIM_NEVER;
+  else
+    conv_done = now + SIM_S / data_rates[(config >> 5) & 0x07];
+}
@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * @file    bme680.cpp
+ * @brief   BME680 model: register map, calibration and forced measurements.
+ *
+ *          The calibration words are those of a typical part. The raw ADC
+ *          values of a measurement are found by inverting the datasheet's
+ *          compensation for the simulated weather, so the driver's own
+ *          compensation gives it back.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <math.h>
+
+#include "devices.h"
+
+#define BME_REG_FIELD0        0x1D
+#define BME_REG_IDAC_HEAT0    0x50
+#define BME_REG_RES_HEAT0     0x5A
+#define BME_REG_GAS_WAIT0     0x64
+#define BME_REG_CTRL_GAS_1    0x71
+#define BME_REG_CTRL_HUM      0x72
+#define BME_REG_CTRL_MEAS     0x74
+#define BME_REG_COEFF1        0x8A
+#define BME_REG_CHIP_ID       0xD0
+#define BME_REG_COEFF2        0xE1
+#define BME_REG_SOFT_RESET    0xE0
+#define BME_REG_VARIANT_ID    0xF0
+
+#define BME_CHIP_ID           0x61
+#define BME_SOFT_RESET_CMD    0xB6
+#define BME_MODE_FORCED       0x01
+#define BME_RUN_GAS           0x10
+
+#define BME_NEW_DATA          0x80
+#define BME_MEASURING         0x20
+#define BME_GAS_MEASURING     0x40
+#define BME_GAS_VALID         0x20
+#define BME_HEAT_STAB         0x10
+
+struct bme_calib_t
+{
+    uint16_t t1;
+    int16_t t2;
+    int8_t t3;
+    uint16_t p1;
+    int16_t p2;
+    int8_t p3;
+    int16_t p4;
+    int16_t p5;
+    int8_t p6;
+    int8_t p7;
+    int16_t p8;
+    int16_t p9;
+    uint8_t p10;
+    uint16_t h1;
+    uint16_t h2;
+    int8_t h3;
+    int8_t h4;
+    int8_t h5;
+    uint8_t h6;
+    int8_t h7;
+    int8_t gh1;
+    int16_t gh2;
+    int8_t gh3;
+};
+
+static const bme_calib_t calib = {
+    26181, 26499, 3,
+    36095, -10409, 88, 7362, -143, 30, 53, -3013, -2658, 30,
+    757, 1003, 0, 45, 20, 120, -100,
+    -30, -11906, 18
+};
+
+// Datasheet compensation, float version
+static float compensate_t(uint32_t adc, float &t_fine)
+{
+  float var1 = ((adc / 16384.0f) - (calib.t1 / 1024.0f)) * calib.t2;
+  float var2 = (adc / 131072.0f) - (calib.t1 / 8192.0f);
+
+  t_fine = var1 + var2 * var2 * (calib.t3 * 16.0f);
+  return t_fine / 5120.0f;
+}
+
+static float compensate_p(uint32_t adc, float t_fine)
+{
+  float var1 = (t_fine / 2.0f) - 64000.0f;
+  float var2 = var1 * var1 * (calib.p6 / 131072.0f);
+  var2 = var2 + (var1 * calib.p5 * 2.0f);
+  var2 = (var2 / 4.0f) + (calib.p4 * 65536.0f);
+  var1 = (((calib.p3 * var1 * var1) / 16384.0f) + (calib.p2 * var1)) / 524288.0f;
+  var1 = (1.0f + (var1 / 32768.0f)) * calib.p1;
+
+  float p = 1048576.0f - adc;
+  p = ((p - (var2 / 4096.0f)) * 6250.0f) / var1;
+  var1 = (calib.p9 * p * p) / 2147483648.0f;
+  var2 = p * (calib.p8 / 32768.0f);
+  float var3 = (p / 256.0f) * (p / 256.0f) * (p / 256.0f) * (calib.p10 / 131072.0f);
+  return p + (var1 + var2 + var3 + (calib.p7 * 128.0f)) / 16.0f;
+}
+
+static float compensate_h(uint16_t adc, float t_fine)
+{
+  float temp = t_fine / 5120.0f;
+  float var1 = adc - ((calib.h1 * 16.0f) + ((calib.h3 / 2.0f) * temp));
+  float var2 = var1 * ((calib.h2 / 262144.0f) *
+                       (1.0f + ((calib.h4 / 16384.0f) * temp) + ((calib.h5 / 1048576.0f) * temp * temp)));
+  float var3 = calib.h6 / 16384.0f;
+  float var4 = calib.h7 / 2097152.0f;
+
+  return var2 + ((var3 + (var4 * temp)) * var2 * var2);
+}
+
+// Smallest raw value whose compensated reading reaches target, the
+// compensation is monotonic in the raw value (falling for pressure)
+template <class F>
+static uint32_t invert(F reading, float target, uint32_t max_adc, bool falling)
+{
+  uint32_t lo = 0, hi = max_adc;
+
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    bool below = falling ? reading(mid) > target : reading(mid) < target;
+
+    if (below)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+Sim_BME680::Sim_BME680(const char *name, uint8_t address)
+    : Sim_I2C_Device(name, address), pointer(0), meas_index(0), meas_done(SIM_NEVER)
+{
+  reset();
+}
+
+void Sim_BME680::reset()
+{
+  uint8_t coeff[42];
+
+  memset(regs, 0, sizeof(regs));
+  memset(coeff, 0, sizeof(coeff));
+
+  // Laid out as the driver's coefficient array (BME68X_IDX_*)
+  coeff[0] = calib.t2;
+  coeff[1] = calib.t2 >> 8;
+  coeff[2] = calib.t3;
+  coeff[4] = calib.p1;
+  coeff[5] = calib.p1 >> 8;
+  coeff[6] = calib.p2;
+  coeff[7] = calib.p2 >> 8;
+  coeff[8] = calib.p3;
+  coeff[10] = calib.p4;
+  coeff[11] = calib.p4 >> 8;
+  coeff[12] = calib.p5;
+  coeff[13] = calib.p5 >> 8;
+  coeff[14] = calib.p7;
+  coeff[15] = calib.p6;
+  coeff[18] = calib.p8;
+  coeff[19] = calib.p8 >> 8;
+  coeff[20] = calib.p9;
+  coeff[21] = calib.p9 >> 8;
+  coeff[22] = calib.p10;
+  coeff[23] = calib.h2 >> 4;
+  coeff[24] = ((calib.h2 & 0x0F) << 4) | (calib.h1 & 0x0F);
+  coeff[25] = calib.h1 >> 4;
+  coeff[26] = calib.h3;
+  coeff[27] = calib.h4;
+  coeff[28] = calib.h5;
+  coeff[29] = calib.h6;
+  coeff[30] = calib.h7;
+  coeff[31] = calib.t1;
+  coeff[32] = calib.t1 >> 8;
+  coeff[33] = calib.gh2;
+  coeff[34] = calib.gh2 >> 8;
+  coeff[35] = calib.gh1;
+  coeff[36] = calib.gh3;
+  coeff[37] = 38;       // res_heat_val
+  coeff[39] = 0x10;     // res_heat_range 1
+  coeff[41] = 0x00;     // range_sw_err
+
+  memcpy(&regs[BME_REG_COEFF1], &coeff[0], 23);
+  memcpy(&regs[BME_REG_COEFF2], &coeff[23], 14);
+  memcpy(&regs[0x00], &coeff[37], 5);
+
+  regs[BME_REG_CHIP_ID] = BME_CHIP_ID;
+  regs[BME_REG_VARIANT_ID] = 0x00;
+  meas_done = SIM_NEVER;
+}
+
+bool Sim_BME680::i2c_write(const uint8_t *data, uint8_t length)
+{
+  if (length == 0)
+    return true;
+
+  pointer = data[0];
+
+  // Burst writes come as register, value pairs
+  for (uint8_t i = 0; i + 1 < length; i += 2)
+    write_register(data[i], data[i + 1]);
+  return true;
+}
+
+uint8_t Sim_BME680::i2c_read(uint8_t *data, uint8_t length)
+{
+  for (uint8_t i = 0; i < length; i++)
+    data[i] = regs[(uint8_t)(pointer + i)];
+
+  pointer += length;
+  return length;
+}
+
+void Sim_BME680::write_register(uint8_t reg, uint8_t value)
+{
+  if (reg == BME_REG_SOFT_RESET)
+  {
+    if (value == BME_SOFT_RESET_CMD)
+      reset();
+    return;
+  }
+
+  if (reg == BME_REG_CHIP_ID || reg == BME_REG_VARIANT_ID)
+    return;
+
+  regs[reg] = value;
+
+  if (reg == BME_REG_CTRL_MEAS && (value & 0x03) == BME_MODE_FORCED)
+  {
+    regs[BME_REG_FIELD0] = BME_MEASURING | BME_GAS_MEASURING;
+    meas_done = sim_now() + duration();
+  }
+}
+
+// TPH conversions at their oversampling plus the heater phase, as
+// bme68x_get_meas_dur() and the gas_wait register
+sim_time_t Sim_BME680::duration()
+{
+  static const uint8_t cycles[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+  uint8_t ctrl_meas = regs[BME_REG_CTRL_MEAS];
+  uint32_t meas_cycles = cycles[(ctrl_meas >> 5) & 0x07] + cycles[(ctrl_meas >> 2) & 0x07] +
+                         cycles[regs[BME_REG_CTRL_HUM] & 0x07];
+  sim_time_t us = meas_cycles * 1963UL + 477 * 4 + 477 * 5 + 1000;
+
+  if (regs[BME_REG_CTRL_GAS_1] & BME_RUN_GAS)
+  {
+    uint8_t gas_wait = regs[BME_REG_GAS_WAIT0];
+    static const uint8_t factor[4] = {1, 4, 16, 64};
+
+    us += (gas_wait & 0x3F) * factor[gas_wait >> 6] * 1000UL;
+  }
+  return us * SIM_US;
+}
+
+void Sim_BME680::service(sim_time_t now)
+{
+  float temperature = 22.0f + 3.0f * sim_wave(3600) + sim_noise(0.02f);
+  float pressure = 83700.0f + 150.0f * sim_wave(7200) + sim_noise(2.0f);
+  float humidity = 35.0f - 8.0f * sim_wave(3600) + sim_noise(0.2f);
+  float gas_ohm = 60000.0f + 15000.0f * sim_wave(1800) + sim_noise(300.0f);
+  float t_fine;
+
+  uint32_t adc_t = invert([](uint32_t adc) { float f; return compensate_t(adc, f); },
+                          temperature, 0xFFFFF, false);
+  compensate_t(adc_t, t_fine);
+  uint32_t adc_p = invert([t_fine](uint32_t adc) { return compensate_p(adc, t_fine); },
+                          pressure, 0xFFFFF, true);
+  uint32_t adc_h = invert([t_fine](uint32_t adc) { return compensate_h(adc, t_fine); },
+                          humidity, 0xFFFF, false);
+
+  // Gas range that puts the 10 bit ADC value in its span
+  uint8_t range = 0;
+  long adc_g = 0;
+  for (; range < 16; range++)
+  {
+    adc_g = lround((1.0 / (1.25e-7 * (1 << range) * gas_ohm) - 1.0) * 1340.0 + 512.0);
+    if (adc_g < 1024)
+      break;
+  }
+  adc_g = constrain(adc_g, 0L, 1023L);
+
+  uint8_t *field = &regs[BME_REG_FIELD0];
+
+  field[0] = BME_NEW_DATA;
+  field[1] = meas_index++;
+  field[2] = adc_p >> 12;
+  field[3] = adc_p >> 4;
+  field[4] = adc_p << 4;
+  field[5] = adc_t >> 12;
+  field[6] = adc_t >> 4;
+  field[7] = adc_t << 4;
+  field[8] = adc_h >> 8;
+  field[9] = adc_h;
+  field[13] = adc_g >> 2;
+  field[14] = ((adc_g & 0x03) << 6) | range;
+  if (regs[BME_REG_CTRL_GAS_1] & BME_RUN_GAS)
+    field[14] |= BME_GAS_VALID | BME_HEAT_STAB;
+
+  // Back to sleep mode
+  regs[BME_REG_CTRL_MEAS] &= ~0x03;
+  meas_done = SIM_NEVER;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * @file    bus.cpp
+ * @brief   Device lists of the simulated I2C and SPI buses.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <Arduino.h>
+
+#include "bus.h"
+
+static Sim_I2C_Device *i2c_list = NULL;
+static Sim_SPI_Device *spi_list = NULL;
+
+Sim_I2C_Device::Sim_I2C_Device(const char *name, uint8_t address)
+    : Sim_Device(name), address(address), unplugged(false), next_on_bus(i2c_list)
+{
+  i2c_list = this;
+}
+
+Sim_I2C_Device *sim_i2c_devices()
+{
+  return i2c_list;
+}
+
+Sim_I2C_Device *sim_i2c_find(uint8_t address)
+{
+  for (Sim_I2C_Device *d = i2c_list; d; d = d->next_on_bus)
+  {
+    if (d->address == address && !d->unplugged)
+      return d;
+  }
+  return NULL;
+}
+
+// Chip select edges of the SPI devices
+static void spi_pin_hook(uint8_t pin, uint8_t level)
+{
+  for (Sim_SPI_Device *d = spi_list; d; d = d->next_on_bus)
+  {
+    if (d->cs_pin == pin)
+    {
+      if (!level)
+        d->transactions++;
+      d->spi_select(!level);
+    }
+  }
+}
+
+Sim_SPI_Device::Sim_SPI_Device(const char *name, uint8_t cs_pin)
+    : Sim_Device(name), cs_pin(cs_pin), next_on_bus(spi_list)
+{
+  if (!spi_list)
+    sim_on_pin_write(spi_pin_hook);
+  spi_list = this;
+
+  // Pulled up until the sketch drives it
+  sim_pin_input(cs_pin, HIGH);
+}
+
+Sim_SPI_Device *sim_spi_selected()
+{
+  for (Sim_SPI_Device *d = spi_list; d; d = d->next_on_bus)
+  {
+    if (sim_pin_level(d->cs_pin) == LOW)
+      return d;
+  }
+  return NULL;
+}
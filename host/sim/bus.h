@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * @file    bus.h
+ * @brief   Simulated devices on the I2C bus, the SPI bus and the UARTs.
+ *
+ *          The Wire and SPI shims route each transfer to the device that
+ *          owns the address or has its chip select low, and charge the
+ *          clock with the time the transfer takes on the wire.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SIM_BUS_H
+#define _SIM_BUS_H
+
+#include "sim.h"
+
+class Sim_I2C_Device : public Sim_Device
+{
+  public:
+    Sim_I2C_Device(const char *name, uint8_t address);
+
+    // Master writes, false NACKs the address
+    virtual bool i2c_write(const uint8_t *data, uint8_t length) = 0;
+    // Master reads, returns the bytes sent (the rest read as 0xFF)
+    virtual uint8_t i2c_read(uint8_t *data, uint8_t length) = 0;
+    // Broadcast to address 0x00
+    virtual void i2c_general_call(const uint8_t *data, uint8_t length) {}
+
+    uint8_t address;
+    // Off the bus, every transfer to it is NACKed
+    bool unplugged;
+    Sim_I2C_Device *next_on_bus;
+};
+
+Sim_I2C_Device *sim_i2c_find(uint8_t address);
+Sim_I2C_Device *sim_i2c_devices();
+
+class Sim_SPI_Device : public Sim_Device
+{
+  public:
+    Sim_SPI_Device(const char *name, uint8_t cs_pin);
+
+    virtual uint8_t spi_transfer(uint8_t out) = 0;
+    virtual void spi_select(bool selected) {}
+
+    uint8_t cs_pin;
+    Sim_SPI_Device *next_on_bus;
+};
+
+Sim_SPI_Device *sim_spi_selected();
+
+#endif  // _SIM_BUS_H
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * @file    devices.h
+ * @brief   Register level models of the pod's sensors, RTC and SD card.
+ *
+ *          Each model answers the same bus traffic as the part and takes the
+ *          datasheet's time to convert, so the libraries run their own code
+ *          paths (polling, retries, timeouts) against it.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SIM_DEVICES_H
+#define _SIM_DEVICES_H
+
+#include <Arduino.h>
+
+#include "bus.h"
+
+// ADS1115 16-bit ADC, single shot and continuous conversions
+class Sim_ADS1115 : public Sim_I2C_Device
+{
+  public:
+    Sim_ADS1115(const char *name, uint8_t address, float ain0, float ain1, float ain2, float ain3);
+
+    bool i2c_write(const uint8_t *data, uint8_t length);
+    uint8_t i2c_read(uint8_t *data, uint8_t length);
+    sim_time_t next_event() { return conv_done; }
+    void service(sim_time_t now);
+
+  private:
+    void write_config(uint16_t value);
+    int16_t convert();
+
+    float ain[4];
+    uint8_t pointer;
+    uint16_t config;
+    int16_t conversion;
+    uint16_t threshold[2];
+    sim_time_t conv_done;
+};
+
+// MCP3424 18-bit delta-sigma ADC with four channels
+class Sim_MCP3424 : public Sim_I2C_Device
+{
+  public:
+    Sim_MCP3424(const char *name, uint8_t address, float ch1, float ch2, float ch3, float ch4);
+
+    bool i2c_write(const uint8_t *data, uint8_t length);
+    uint8_t i2c_read(uint8_t *data, uint8_t length);
+    void i2c_general_call(const uint8_t *data, uint8_t length);
+    sim_time_t next_event() { return conv_done; }
+    void service(sim_time_t now);
+
+  private:
+    void start();
+
+    float input[4];
+    uint8_t config;
+    int32_t result;
+    bool fresh;
+    sim_time_t conv_done;
+};
+
+// BME680 gas, pressure, humidity and temperature sensor in forced mode
+class Sim_BME680 : public Sim_I2C_Device
+{
+  public:
+    Sim_BME680(const char *name, uint8_t address);
+
+    bool i2c_write(const uint8_t *data, uint8_t length);
+    uint8_t i2c_read(uint8_t *data, uint8_t length);
+    sim_time_t next_event() { return meas_done; }
+    void service(sim_time_t now);
+
+  private:
+    void reset();
+    void write_register(uint8_t reg, uint8_t value);
+    sim_time_t duration();
+
+    uint8_t regs[256];
+    uint8_t pointer;
+    uint8_t meas_index;
+    sim_time_t meas_done;
+};
+
+// ELT S300 CO2 sensor, I2C variant
+class Sim_S300 : public Sim_I2C_Device
+{
+  public:
+    Sim_S300(const char *name, uint8_t address);
+
+    bool i2c_write(const uint8_t *data, uint8_t length);
+    uint8_t i2c_read(uint8_t *data, uint8_t length);
+
+  private:
+    sim_time_t command_time;
+};
+
+// DS3231 RTC with the 1 Hz square wave on an interrupt pin
+class Sim_DS3231 : public Sim_I2C_Device
+{
+  public:
+    Sim_DS3231(const char *name, uint8_t address, uint32_t unixtime, uint8_t sqw_pin);
+
+    bool i2c_write(const uint8_t *data, uint8_t length);
+    uint8_t i2c_read(uint8_t *data, uint8_t length);
+    sim_time_t next_event();
+    void service(sim_time_t now);
+
+  private:
+    uint32_t unixtime();
+    bool sqw_enabled();
+
+    uint8_t regs[0x13];
+    uint8_t pointer;
+    int64_t offset_s;
+    uint8_t sqw_pin;
+};
+
+// Plantower PMS5003 streaming a 32 byte frame every second
+class Sim_PMS5003 : public Sim_Device
+{
+  public:
+    Sim_PMS5003(const char *name, HardwareSerial &serial, unsigned long baud);
+
+    sim_time_t next_event() { return next_byte; }
+    void service(sim_time_t now);
+
+  private:
+    void build_frame();
+
+    HardwareSerial &serial;
+    uint64_t byte_time;
+    uint8_t frame[32];
+    uint8_t sent;
+    sim_time_t frame_start;
+    sim_time_t next_byte;
+};
+
+// Alphasense OPC-R2 optical particle counter on SPI
+class Sim_OPC_R2 : public Sim_SPI_Device
+{
+  public:
+    Sim_OPC_R2(const char *name, uint8_t cs_pin);
+
+    uint8_t spi_transfer(uint8_t out);
+    void spi_select(bool selected);
+
+  private:
+    void build_histogram();
+
+    enum { IDLE, POWER, HISTOGRAM } state;
+    sim_time_t ready_at;
+    uint8_t histogram[64];
+    uint8_t index;
+    bool fan_on;
+};
+
+// SDHC card in SPI mode, its sectors are the sectors of an image file
+class Sim_SD_Card : public Sim_SPI_Device
+{
+  public:
+    Sim_SD_Card(const char *name, uint8_t cs_pin);
+    ~Sim_SD_Card();
+
+    // Opens or creates a sparse image of size_mb, false on I/O errors
+    bool open(const char *path, uint32_t size_mb);
+
+    uint8_t spi_transfer(uint8_t out);
+    void spi_select(bool selected);
+    void clear_stats();
+
+    uint32_t sector_count;
+    uint64_t sectors_read;
+    uint64_t sectors_written;
+
+  private:
+    void command(const uint8_t *cmd);
+    void respond(uint8_t r1);
+    void queue(uint8_t value);
+    void queue_block(const uint8_t *data, uint16_t length);
+    void read_sector();
+    void write_sector();
+    void busy(sim_time_t ns);
+    uint8_t r1();
+
+    int fd;
+    enum { CMD, WAIT_TOKEN, DATA_IN } state;
+    bool idle;
+    bool app_command;
+    bool multi_write;
+    bool multi_read;
+    sim_time_t init_ready;
+    sim_time_t busy_until;
+    sim_time_t data_ready;
+    uint32_t sector;
+    uint32_t erase_start;
+    uint32_t erase_end;
+    uint32_t writes;
+
+    uint8_t cmd[6];
+    uint8_t cmd_length;
+    uint8_t block[512 + 2];
+    uint16_t block_length;
+
+    uint8_t out[600];
+    uint16_t out_head;
+    uint16_t out_tail;
+};
+
+#endif  // _SIM_DEVICES_H
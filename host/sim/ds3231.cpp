@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * @file    ds3231.cpp
+ * @brief   DS3231 model: BCD time kept on virtual time, control and status.
+ *
+ *          With INTCN cleared and RS at 1 Hz the SQW pin falls on every
+ *          seconds update and rises half a second later.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <RTClib.h>
+
+#include "devices.h"
+
+#define DS3231_REG_CONTROL    0x0E
+#define DS3231_REG_STATUS     0x0F
+#define DS3231_INTCN          0x04
+#define DS3231_RS_MASK        0x18
+
+static uint8_t bin2bcd(uint8_t value)
+{
+  return value + 6 * (value / 10);
+}
+
+static uint8_t bcd2bin(uint8_t value)
+{
+  return value - 6 * (value >> 4);
+}
+
+Sim_DS3231::Sim_DS3231(const char *name, uint8_t address, uint32_t unixtime, uint8_t sqw_pin)
+    : Sim_I2C_Device(name, address), pointer(0), offset_s(unixtime), sqw_pin(sqw_pin)
+{
+  memset(regs, 0, sizeof(regs));
+  regs[DS3231_REG_CONTROL] = DS3231_INTCN | DS3231_RS_MASK;
+  sim_pin_input(sqw_pin, HIGH);
+}
+
+uint32_t Sim_DS3231::unixtime()
+{
+  return offset_s + sim_now() / SIM_S;
+}
+
+bool Sim_DS3231::sqw_enabled()
+{
+  return (regs[DS3231_REG_CONTROL] & (DS3231_INTCN | DS3231_RS_MASK)) == 0;
+}
+
+bool Sim_DS3231::i2c_write(const uint8_t *data, uint8_t length)
+{
+  if (length == 0)
+    return true;
+
+  pointer = data[0];
+
+  if (length == 1)
+    return true;
+
+  // A write to the time registers sets the clock, whole registers at a time
+  if (pointer == 0 && length >= 8)
+  {
+    DateTime set(2000 + bcd2bin(data[7]), bcd2bin(data[6] & 0x7F), bcd2bin(data[5]),
+                 bcd2bin(data[3]), bcd2bin(data[2]), bcd2bin(data[1]));
+
+    offset_s = (int64_t)set.unixtime() - sim_now() / SIM_S;
+    regs[DS3231_REG_STATUS] &= ~0x80;
+    return true;
+  }
+
+  for (uint8_t i = 1; i < length; i++)
+  {
+    uint8_t reg = pointer + i - 1;
+
+    if (reg >= DS3231_REG_CONTROL && reg < sizeof(regs))
+      regs[reg] = data[i];
+  }
+  return true;
+}
+
+uint8_t Sim_DS3231::i2c_read(uint8_t *data, uint8_t length)
+{
+  DateTime now(unixtime());
+
+  regs[0] = bin2bcd(now.second());
+  regs[1] = bin2bcd(now.minute());
+  regs[2] = bin2bcd(now.hour());
+  regs[3] = bin2bcd(now.dayOfTheWeek() ? now.dayOfTheWeek() : 7);
+  regs[4] = bin2bcd(now.day());
+  regs[5] = bin2bcd(now.month());
+  regs[6] = bin2bcd(now.year() - 2000);
+  // 0x11, 0x12: 24.25 C
+  regs[0x11] = 24;
+  regs[0x12] = 0x40;
+
+  for (uint8_t i = 0; i < length; i++)
+    data[i] = regs[(pointer + i) % sizeof(regs)];
+
+  pointer = (pointer + length) % sizeof(regs);
+  return length;
+}
+
+sim_time_t Sim_DS3231::next_event()
+{
+  // An unplugged RTC leaves the pin on its pull-up
+  if (!sqw_enabled() || unplugged)
+    return SIM_NEVER;
+
+  return (sim_now() / (SIM_S / 2) + 1) * (SIM_S / 2);
+}
+
+void Sim_DS3231::service(sim_time_t now)
+{
+  sim_pin_input(sqw_pin, (now / (SIM_S / 2)) % 2 ? HIGH : LOW);
+}
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * @file    mcp3424.cpp
+ * @brief   MCP3424 model: one config byte, results with a ready flag.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "devices.h"
+
+#define MCP_CONFIG_RDY        0x80
+#define MCP_CONFIG_CONTINUOUS 0x10
+#define MCP_CONFIG_DEFAULT    0x90
+
+// Typical data rates of 12, 14, 16 and 18 bit conversions in mSPS
+static const uint32_t sample_rates[4] = {240000, 60000, 15000, 3750};
+
+Sim_MCP3424::Sim_MCP3424(const char *name, uint8_t address, float ch1, float ch2, float ch3, float ch4)
+    : Sim_I2C_Device(name, address), config(MCP_CONFIG_DEFAULT), result(0),
+      fresh(false), conv_done(SIM_NEVER)
+{
+  input[0] = ch1;
+  input[1] = ch2;
+  input[2] = ch3;
+  input[3] = ch4;
+}
+
+// The internal oscillator is a few percent off the typical rate
+void Sim_MCP3424::start()
+{
+  uint8_t resolution = (config >> 2) & 0x03;
+  float period = 1e12f / sample_rates[resolution];
+
+  conv_done = sim_now() + (sim_time_t)(period * (1.0f + 0.03f + sim_noise(0.03f)));
+}
+
+bool Sim_MCP3424::i2c_write(const uint8_t *data, uint8_t length)
+{
+  if (length == 0)
+    return true;
+
+  config = data[length - 1] & ~MCP_CONFIG_RDY;
+
+  if ((data[length - 1] & MCP_CONFIG_RDY) || (config & MCP_CONFIG_CONTINUOUS))
+  {
+    fresh = false;
+    start();
+  }
+  return true;
+}
+
+void Sim_MCP3424::i2c_general_call(const uint8_t *data, uint8_t length)
+{
+  if (length == 0)
+    return;
+
+  if (data[0] == 0x06)
+    config = MCP_CONFIG_DEFAULT & ~MCP_CONFIG_RDY;
+  else if (data[0] != 0x08)
+    return;
+
+  fresh = false;
+  start();
+}
+
+uint8_t Sim_MCP3424::i2c_read(uint8_t *data, uint8_t length)
+{
+  uint8_t resolution = (config >> 2) & 0x03;
+  uint8_t status = config | (fresh ? 0 : MCP_CONFIG_RDY);
+  uint8_t frame[4];
+
+  if (resolution == 3)
+  {
+    frame[0] = result >> 16;
+    frame[1] = result >> 8;
+    frame[2] = result;
+    frame[3] = status;
+  }
+  else
+  {
+    frame[0] = result >> 8;
+    frame[1] = result;
+    frame[2] = status;
+    frame[3] = status;
+  }
+
+  for (uint8_t i = 0; i < length; i++)
+    data[i] = i < 4 ? frame[i] : status;
+
+  // A result is new only until it has been read once
+  fresh = false;
+  return length;
+}
+
+void Sim_MCP3424::service(sim_time_t now)
+{
+  uint8_t bits = 12 + 2 * ((config >> 2) & 0x03);
+  uint8_t gain = 1 << (config & 0x03);
+  float volts = input[(config >> 5) & 0x03];
+  float lsb = 2 * 2.048f / (1L << bits);
+
+  volts += 0.05f * volts * sim_wave(900) + sim_noise(0.00002f);
+
+  long max_code = (1L << (bits - 1)) - 1;
+  result = constrain((long)(volts * gain / lsb), -max_code - 1, max_code);
+  fresh = true;
+
+  if (config & MCP_CONFIG_CONTINUOUS)
+    start();
+  else
+    conv_done = SIM_NEVER;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * @file    opc_r2.cpp
+ * @brief   OPC-R2 model: command bytes answered busy (0x31) until the
+ *          device is ready (0xF3), then the command's data.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "devices.h"
+
+#define OPC_BUSY              0x31
+#define OPC_READY             0xF3
+#define OPC_READY_NS          (8 * SIM_MS)
+
+Sim_OPC_R2::Sim_OPC_R2(const char *name, uint8_t cs_pin)
+    : Sim_SPI_Device(name, cs_pin), state(IDLE), ready_at(0), index(0), fan_on(false)
+{
+  memset(histogram, 0, sizeof(histogram));
+}
+
+void Sim_OPC_R2::spi_select(bool selected)
+{
+  if (selected)
+    ready_at = sim_now() + OPC_READY_NS;
+  else
+    state = IDLE;
+}
+
+static void put_float(uint8_t *p, float value)
+{
+  memcpy(p, &value, sizeof(value));
+}
+
+// 16 bin counts, the bin MToFs, flow, period and the PM values
+void Sim_OPC_R2::build_histogram()
+{
+  float scale = fan_on ? 1.0f + 0.3f * sim_wave(1800) : 0.0f;
+
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    uint16_t count = scale * (400 >> (i / 2)) + (fan_on ? sim_random() % 5 : 0);
+
+    histogram[2 * i] = count;
+    histogram[2 * i + 1] = count >> 8;
+  }
+  put_float(&histogram[36], 5.0f);          // sample flow rate, ml/s
+  put_float(&histogram[44], 1.4f);          // sample period, s
+  put_float(&histogram[50], 3.0f * scale);
+  put_float(&histogram[54], 6.5f * scale);
+  put_float(&histogram[58], 11.0f * scale);
+}
+
+uint8_t Sim_OPC_R2::spi_transfer(uint8_t out)
+{
+  switch (state)
+  {
+    case IDLE:
+      if (out != 0x03 && out != 0x30)
+        return OPC_BUSY;
+      if (sim_now() < ready_at)
+        return OPC_BUSY;
+
+      transactions++;
+      if (out == 0x30)
+      {
+        build_histogram();
+        state = HISTOGRAM;
+        index = 0;
+      }
+      else
+        state = POWER;
+      return OPC_READY;
+
+    case POWER:
+      fan_on = out == 0x03;
+      state = IDLE;
+      return OPC_READY;
+
+    case HISTOGRAM:
+      if (index < sizeof(histogram))
+        return histogram[index++];
+      return 0x00;
+  }
+  return 0xFF;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * @file    pms5003.cpp
+ * @brief   PMS5003 model: active mode frames on a UART at 9600 baud.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "devices.h"
+
+#define PMS_FRAME_PERIOD      (1000 * SIM_MS)
+
+Sim_PMS5003::Sim_PMS5003(const char *name, HardwareSerial &serial, unsigned long baud)
+    : Sim_Device(name), serial(serial), byte_time(10ULL * SIM_S / baud), sent(0),
+      frame_start(PMS_FRAME_PERIOD / 3), next_byte(PMS_FRAME_PERIOD / 3)
+{
+}
+
+void Sim_PMS5003::build_frame()
+{
+  uint16_t words[13];
+  float pm25 = 8.0f + 4.0f * sim_wave(1800) + sim_noise(1.0f);
+
+  words[0] = pm25 * 0.7f;           // PM1.0 standard
+  words[1] = pm25;                  // PM2.5 standard
+  words[2] = pm25 * 1.3f;           // PM10 standard
+  words[3] = words[0];              // PM1.0 environment
+  words[4] = words[1];
+  words[5] = words[2];
+  words[6] = pm25 * 180;            // > 0.3 um per 0.1 L
+  words[7] = pm25 * 55;
+  words[8] = pm25 * 9;
+  words[9] = pm25 * 1.2f;
+  words[10] = pm25 * 0.4f;
+  words[11] = pm25 * 0.1f;
+  words[12] = 0x9700;               // version, error code
+
+  frame[0] = 0x42;
+  frame[1] = 0x4D;
+  frame[2] = 0;
+  frame[3] = 28;
+  for (uint8_t i = 0; i < 13; i++)
+  {
+    frame[4 + 2 * i] = words[i] >> 8;
+    frame[5 + 2 * i] = words[i];
+  }
+
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < 30; i++)
+    sum += frame[i];
+  frame[30] = sum >> 8;
+  frame[31] = sum;
+}
+
+void Sim_PMS5003::service(sim_time_t now)
+{
+  if (sent == 0)
+    build_frame();
+
+  serial.sim_receive(frame[sent++]);
+  bytes++;
+
+  if (sent < sizeof(frame))
+  {
+    next_byte = now + byte_time;
+    return;
+  }
+
+  sent = 0;
+  transactions++;
+  frame_start += PMS_FRAME_PERIOD;
+  next_byte = frame_start;
+}
@@ -0,0 +1,39 @@
+/*******************************************************************************
+ * @file    s300.cpp
+ * @brief   ELT S300 model: 'R' starts a read, the answer is a 7 byte frame.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "devices.h"
+
+// The sensor needs this long after the command before the frame is valid
+#define S300_READ_NS          (10 * SIM_MS)
+
+Sim_S300::Sim_S300(const char *name, uint8_t address)
+    : Sim_I2C_Device(name, address), command_time(SIM_NEVER)
+{
+}
+
+bool Sim_S300::i2c_write(const uint8_t *data, uint8_t length)
+{
+  if (length > 0 && data[0] == 'R')
+    command_time = sim_now();
+  return true;
+}
+
+uint8_t Sim_S300::i2c_read(uint8_t *data, uint8_t length)
+{
+  uint16_t ppm = 420 + 60 * sim_wave(1200) + sim_noise(3);
+  uint8_t frame[7] = {0x08, (uint8_t)(ppm >> 8), (uint8_t)ppm, 0, 0, 0, 0};
+
+  // Too early, or no command: the status bytes read back as 0xFF
+  if (command_time == SIM_NEVER || sim_now() - command_time < S300_READ_NS)
+    memset(&frame[3], 0xFF, 4);
+
+  for (uint8_t i = 0; i < length && i < sizeof(frame); i++)
+    data[i] = frame[i];
+
+  command_time = SIM_NEVER;
+  return min(length, (uint8_t)sizeof(frame));
+}
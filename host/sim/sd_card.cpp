@@ -0,0 +1,386 @@
+/*******************************************************************************
+ * @file    sd_card.cpp
+ * @brief   SDHC card in SPI mode over an image file.
+ *
+ *          Commands, R1/R3/R7 responses, data tokens and the busy signal
+ *          follow the SD physical layer spec closely enough for SdFat's
+ *          SharedSpiCard and DedicatedSpiCard. Timing is that of a typical
+ *          class 10 card: a read token comes after the access time, a write
+ *          keeps the card busy for the programming time, and every few
+ *          hundred writes a longer busy period stands for the card's
+ *          internal garbage collection.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "devices.h"
+
+#define SD_INIT_NS            (40 * SIM_MS)
+#define SD_READ_NS            (300 * SIM_US)
+#define SD_NEXT_BLOCK_NS      (60 * SIM_US)
+#define SD_WRITE_NS           (700 * SIM_US)
+#define SD_MULTI_WRITE_NS     (250 * SIM_US)
+#define SD_GC_NS              (30 * SIM_MS)
+#define SD_GC_WRITES          256
+#define SD_ERASE_NS           (2 * SIM_MS)
+
+#define R1_READY              0x00
+#define R1_IDLE               0x01
+#define R1_ILLEGAL_COMMAND    0x04
+#define R1_ADDRESS_ERROR      0x20
+
+#define TOKEN_START_BLOCK     0xFE
+#define TOKEN_MULTI_WRITE     0xFC
+#define TOKEN_STOP_TRAN       0xFD
+#define DATA_ACCEPTED         0xE5
+
+Sim_SD_Card::Sim_SD_Card(const char *name, uint8_t cs_pin)
+    : Sim_SPI_Device(name, cs_pin), sector_count(0), sectors_read(0), sectors_written(0),
+      fd(-1), state(CMD), idle(true), app_command(false), multi_write(false),
+      multi_read(false), init_ready(SIM_NEVER), busy_until(0), data_ready(SIM_NEVER),
+      sector(0), erase_start(0), erase_end(0), writes(0), cmd_length(0),
+      block_length(0), out_head(0), out_tail(0)
+{
+}
+
+Sim_SD_Card::~Sim_SD_Card()
+{
+  if (fd >= 0)
+    close(fd);
+}
+
+bool Sim_SD_Card::open(const char *path, uint32_t size_mb)
+{
+  struct stat st;
+
+  fd = ::open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || fstat(fd, &st) < 0)
+    return false;
+
+  // An existing image keeps its size, a new one is sparse
+  if (st.st_size == 0 && ftruncate(fd, (off_t)size_mb << 20) < 0)
+    return false;
+  if (st.st_size > 0)
+    size_mb = st.st_size >> 20;
+
+  // C_SIZE counts 512 KiB units
+  sector_count = (size_mb & ~0U) * 2048;
+  return sector_count > 0;
+}
+
+void Sim_SD_Card::clear_stats()
+{
+  Sim_Device::clear_stats();
+  sectors_read = 0;
+  sectors_written = 0;
+}
+
+uint8_t Sim_SD_Card::r1()
+{
+  return idle ? R1_IDLE : R1_READY;
+}
+
+void Sim_SD_Card::queue(uint8_t value)
+{
+  if (out_head < sizeof(out))
+    out[out_head++] = value;
+}
+
+void Sim_SD_Card::queue_block(const uint8_t *data, uint16_t length)
+{
+  queue(TOKEN_START_BLOCK);
+  for (uint16_t i = 0; i < length; i++)
+    queue(data[i]);
+  queue(0xFF);
+  queue(0xFF);
+}
+
+// One fill byte before the response
+void Sim_SD_Card::respond(uint8_t value)
+{
+  queue(0xFF);
+  queue(value);
+}
+
+void Sim_SD_Card::busy(sim_time_t ns)
+{
+  busy_until = sim_now() + ns;
+  sim_stats.sd_busy_ns += ns;
+}
+
+void Sim_SD_Card::spi_select(bool selected)
+{
+  // The card stops driving MISO, an unread response is lost
+  out_head = out_tail = 0;
+  cmd_length = 0;
+}
+
+void Sim_SD_Card::read_sector()
+{
+  uint8_t data[512];
+
+  if (pread(fd, data, sizeof(data), (off_t)sector * 512) != (ssize_t)sizeof(data))
+    memset(data, 0, sizeof(data));
+
+  queue_block(data, sizeof(data));
+  sectors_read++;
+  sim_stats.sd_sectors_read++;
+
+  if (multi_read && ++sector < sector_count)
+    data_ready = sim_now() + SD_NEXT_BLOCK_NS;
+  else
+    data_ready = SIM_NEVER;
+}
+
+void Sim_SD_Card::write_sector()
+{
+  if (pwrite(fd, block, 512, (off_t)sector * 512) != 512)
+    perror("sd_card");
+
+  sectors_written++;
+  sim_stats.sd_sectors_written++;
+  queue(DATA_ACCEPTED);
+
+  sim_time_t ns = multi_write ? SD_MULTI_WRITE_NS : SD_WRITE_NS;
+  if (++writes % SD_GC_WRITES == 0)
+    ns += SD_GC_NS;
+  busy(ns);
+
+  if (multi_write)
+  {
+    sector++;
+    state = WAIT_TOKEN;
+  }
+  else
+    state = CMD;
+}
+
+void Sim_SD_Card::command(const uint8_t *cmd)
+{
+  uint8_t index = cmd[0] & 0x3F;
+  uint32_t arg = ((uint32_t)cmd[1] << 24) | ((uint32_t)cmd[2] << 16) | (cmd[3] << 8) | cmd[4];
+  bool acmd = app_command;
+
+  app_command = false;
+  transactions++;
+
+  // CSD v2.0: 25 MHz, C_SIZE for sector_count, single block erase
+  uint32_t c_size = sector_count / 1024 - 1;
+  const uint8_t csd[16] = {0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00,
+                           (uint8_t)((c_size >> 16) & 0x3F), (uint8_t)(c_size >> 8), (uint8_t)c_size,
+                           0x7F, 0x80, 0x0A, 0x40, 0x00, 0x01};
+  const uint8_t cid[16] = {0x03, 'S', 'D', 'S', 'I', 'M', 'H', 'S', 0x10,
+                           0x12, 0x34, 0x56, 0x78, 0x01, 0x6A, 0x01};
+  const uint8_t scr[8] = {0x02, 0x35, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00};
+  uint8_t zeros[64] = {0};
+
+  switch (index)
+  {
+    case 0:
+      idle = true;
+      multi_read = multi_write = false;
+      data_ready = SIM_NEVER;
+      state = CMD;
+      respond(R1_IDLE);
+      break;
+
+    case 8:
+      respond(r1());
+      queue(0x00);
+      queue(0x00);
+      queue((arg >> 8) & 0x0F);
+      queue(arg);
+      break;
+
+    case 55:
+      app_command = true;
+      respond(r1());
+      break;
+
+    case 41:
+      if (!acmd)
+      {
+        respond(r1() | R1_ILLEGAL_COMMAND);
+        break;
+      }
+      // Power up takes a while, the host repeats ACMD41 until it is done
+      if (init_ready == SIM_NEVER)
+        init_ready = sim_now() + SD_INIT_NS;
+      if (sim_now() >= init_ready)
+        idle = false;
+      respond(r1());
+      break;
+
+    case 58:
+      respond(r1());
+      queue(idle ? 0x40 : 0xC0);
+      queue(0xFF);
+      queue(0x80);
+      queue(0x00);
+      break;
+
+    case 9:
+      respond(r1());
+      queue(0xFF);
+      queue_block(csd, sizeof(csd));
+      break;
+
+    case 10:
+      respond(r1());
+      queue(0xFF);
+      queue_block(cid, sizeof(cid));
+      break;
+
+    case 13:
+      respond(r1());
+      queue(0x00);
+      if (acmd)
+        queue_block(zeros, 64);
+      break;
+
+    case 51:
+      respond(r1());
+      queue(0xFF);
+      queue_block(scr, sizeof(scr));
+      break;
+
+    case 6:
+      respond(r1());
+      queue(0xFF);
+      queue_block(zeros, 64);
+      break;
+
+    case 12:
+      multi_read = false;
+      data_ready = SIM_NEVER;
+      respond(r1());
+      busy(SD_NEXT_BLOCK_NS);
+      break;
+
+    case 16:
+    case 23:
+    case 59:
+      respond(r1());
+      break;
+
+    case 17:
+    case 18:
+    case 24:
+    case 25:
+      if (arg >= sector_count)
+      {
+        respond(r1() | R1_ADDRESS_ERROR);
+        break;
+      }
+      sector = arg;
+      respond(r1());
+      if (index == 17 || index == 18)
+      {
+        multi_read = index == 18;
+        data_ready = sim_now() + SD_READ_NS;
+      }
+      else
+      {
+        multi_write = index == 25;
+        state = WAIT_TOKEN;
+      }
+      break;
+
+    case 32:
+      erase_start = arg;
+      respond(r1());
+      break;
+
+    case 33:
+      erase_end = arg;
+      respond(r1());
+      break;
+
+    case 38:
+    {
+      uint8_t sector_zeros[512] = {0};
+
+      for (uint32_t s = erase_start; s <= erase_end && s < sector_count; s++)
+      {
+        if (pwrite(fd, sector_zeros, 512, (off_t)s * 512) != 512)
+          break;
+      }
+      respond(r1());
+      busy(SD_ERASE_NS);
+      break;
+    }
+
+    default:
+      respond(r1() | R1_ILLEGAL_COMMAND);
+      break;
+  }
+}
+
+uint8_t Sim_SD_Card::spi_transfer(uint8_t in)
+{
+  uint8_t reply = 0xFF;
+
+  // MISO first, the byte shifted in only affects the following transfers
+  if (out_tail < out_head)
+  {
+    reply = out[out_tail++];
+    if (out_tail == out_head)
+      out_head = out_tail = 0;
+  }
+  else if (sim_now() < busy_until)
+    reply = 0x00;
+  else if (data_ready != SIM_NEVER && sim_now() >= data_ready)
+  {
+    read_sector();
+    reply = out[out_tail++];
+  }
+
+  switch (state)
+  {
+    case DATA_IN:
+      block[block_length++] = in;
+      if (block_length == sizeof(block))
+        write_sector();
+      break;
+
+    case WAIT_TOKEN:
+      if ((in == TOKEN_START_BLOCK && !multi_write) || (in == TOKEN_MULTI_WRITE && multi_write))
+      {
+        state = DATA_IN;
+        block_length = 0;
+      }
+      else if (in == TOKEN_STOP_TRAN && multi_write)
+      {
+        multi_write = false;
+        state = CMD;
+        busy(SD_NEXT_BLOCK_NS);
+      }
+      break;
+
+    case CMD:
+      if (cmd_length == 0 && (in & 0xC0) != 0x40)
+        break;
+
+      if (cmd_length == 0)
+      {
+        out_head = out_tail = 0;
+        // A stop command ends the block stream right away
+        if ((in & 0x3F) == 12)
+          data_ready = SIM_NEVER;
+      }
+
+      cmd[cmd_length++] = in;
+      if (cmd_length == sizeof(cmd))
+      {
+        cmd_length = 0;
+        command(cmd);
+      }
+      break;
+  }
+
+  return reply;
+}
@@ -0,0 +1,531 @@
+/*******************************************************************************
+ * @file    sim.cpp
+ * @brief   Virtual clock and the timing side of the Arduino core API.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stdlib.h>
+#include <time.h>
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+#include "sim.h"
+
+#define SIM_PIN_COUNT         NUM_DIGITAL_PINS
+#define SIM_EXT_IRQ_COUNT     6
+#define SIM_MAX_IRQ_SOURCES   8
+#define SIM_MAX_PIN_HOOKS     4
+
+sim_stats_t sim_stats;
+FILE *sim_console = NULL;
+
+volatile uint8_t SREG = _BV(SREG_I);
+
+static sim_time_t clock_ns = 0;
+static bool in_isr = false;
+static bool in_service = false;
+
+static Sim_Device *device_list = NULL;
+
+static uint8_t pin_mode[SIM_PIN_COUNT];
+static uint8_t pin_level[SIM_PIN_COUNT];
+static uint16_t analog_value[NUM_ANALOG_INPUTS];
+
+static sim_pin_hook_f pin_hooks[SIM_MAX_PIN_HOOKS];
+static uint8_t pin_hook_count = 0;
+
+static sim_irq_source_f irq_sources[SIM_MAX_IRQ_SOURCES];
+static uint8_t irq_source_count = 0;
+
+static void (*ext_handler[SIM_EXT_IRQ_COUNT])(void);
+static int ext_mode[SIM_EXT_IRQ_COUNT];
+static bool ext_pending[SIM_EXT_IRQ_COUNT];
+
+static sim_time_t wdt_period = 0;
+static sim_time_t wdt_deadline = SIM_NEVER;
+
+static uint32_t random_state = 0x2545F491;
+
+static bool realtime = false;
+static sim_time_t realtime_base;
+static struct timespec wall_base;
+
+/*********************************  Devices  **********************************/
+Sim_Device::Sim_Device(const char *name)
+    : name(name), transactions(0), bytes(0), next(NULL)
+{
+  // Appended so that reports list the devices in construction order
+  Sim_Device **tail = &device_list;
+
+  while (*tail)
+    tail = &(*tail)->next;
+  *tail = this;
+}
+
+Sim_Device *sim_devices()
+{
+  return device_list;
+}
+
+void sim_clear_stats()
+{
+  memset(&sim_stats, 0, sizeof(sim_stats));
+
+  for (Sim_Device *d = device_list; d; d = d->next)
+    d->clear_stats();
+}
+
+/**********************************  Clock  ***********************************/
+// Sleeps while virtual time is ahead of the wall clock
+static void wait_for_wall_clock()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  sim_time_t wall = (now.tv_sec - wall_base.tv_sec) * SIM_S + now.tv_nsec - wall_base.tv_nsec;
+  sim_time_t ahead = clock_ns - realtime_base;
+
+  if (ahead > wall + SIM_MS)
+  {
+    struct timespec pause = {(time_t)((ahead - wall) / SIM_S), (long)((ahead - wall) % SIM_S)};
+    nanosleep(&pause, NULL);
+  }
+}
+
+void sim_realtime(bool on)
+{
+  realtime = on;
+  realtime_base = clock_ns;
+  clock_gettime(CLOCK_MONOTONIC, &wall_base);
+}
+
+static void check_watchdog()
+{
+  if (clock_ns < wdt_deadline)
+    return;
+
+  fprintf(stderr, "xpod_host: watchdog reset at %.3f s\n", clock_ns / 1e9);
+  exit(3);
+}
+
+void sim_run_isr(void (*vector)(void))
+{
+  uint8_t sreg = SREG;
+
+  in_isr = true;
+  SREG = sreg & ~_BV(SREG_I);
+  vector();
+  SREG = sreg;
+  in_isr = false;
+
+  clock_ns += SIM_COST_ISR;
+  sim_stats.interrupts++;
+}
+
+bool sim_interrupts_enabled()
+{
+  return !in_isr && (SREG & _BV(SREG_I));
+}
+
+void sim_dispatch_interrupts()
+{
+  // A source that stays asserted is served once per pass, not forever
+  for (uint8_t pass = 0; pass < 64 && sim_interrupts_enabled(); pass++)
+  {
+    bool served = false;
+
+    for (uint8_t i = 0; i < SIM_EXT_IRQ_COUNT; i++)
+    {
+      if (ext_pending[i] && ext_handler[i])
+      {
+        ext_pending[i] = false;
+        sim_run_isr(ext_handler[i]);
+        served = true;
+      }
+    }
+
+    for (uint8_t i = 0; i < irq_source_count; i++)
+      served |= irq_sources[i]();
+
+    if (!served)
+      break;
+  }
+}
+
+sim_time_t sim_now()
+{
+  return clock_ns;
+}
+
+void sim_advance_to(sim_time_t t)
+{
+  // Devices and ISRs run at a single point in time
+  if (in_isr || in_service)
+  {
+    if (t > clock_ns)
+      clock_ns = t;
+    return;
+  }
+
+  while (true)
+  {
+    sim_dispatch_interrupts();
+
+    Sim_Device *due = NULL;
+    sim_time_t due_at = SIM_NEVER;
+
+    for (Sim_Device *d = device_list; d; d = d->next)
+    {
+      sim_time_t at = d->next_event();
+
+      if (at < due_at)
+      {
+        due = d;
+        due_at = at;
+      }
+    }
+
+    if (!due || due_at > t)
+      break;
+
+    if (due_at > clock_ns)
+      clock_ns = due_at;
+
+    in_service = true;
+    due->service(clock_ns);
+    in_service = false;
+  }
+
+  if (t > clock_ns)
+    clock_ns = t;
+
+  sim_dispatch_interrupts();
+  check_watchdog();
+
+  if (realtime)
+    wait_for_wall_clock();
+}
+
+void sim_advance(sim_time_t ns)
+{
+  sim_advance_to(clock_ns + ns);
+}
+
+// Timer0 overflows every 1024 us at 16 MHz
+#define SIM_TIMER0_OVERFLOW   (1024 * SIM_US)
+
+void sim_sleep()
+{
+  sim_time_t from = clock_ns;
+  sim_time_t wake = (clock_ns / SIM_TIMER0_OVERFLOW + 1) * SIM_TIMER0_OVERFLOW;
+
+  for (Sim_Device *d = device_list; d; d = d->next)
+  {
+    sim_time_t at = d->next_event();
+
+    if (at > clock_ns && at < wake)
+      wake = at;
+  }
+
+  sim_advance_to(wake);
+  sim_stats.sleep_ns += clock_ns - from;
+}
+
+/***********************************  Pins  ***********************************/
+void sim_on_pin_write(sim_pin_hook_f hook)
+{
+  if (pin_hook_count < SIM_MAX_PIN_HOOKS)
+    pin_hooks[pin_hook_count++] = hook;
+}
+
+void sim_add_irq_source(sim_irq_source_f source)
+{
+  if (irq_source_count < SIM_MAX_IRQ_SOURCES)
+    irq_sources[irq_source_count++] = source;
+}
+
+void sim_pin_input(uint8_t pin, uint8_t level)
+{
+  if (pin >= SIM_PIN_COUNT)
+    return;
+
+  uint8_t previous = pin_level[pin];
+  int irq = digitalPinToInterrupt(pin);
+
+  pin_level[pin] = level;
+
+  if (irq < 0 || irq >= SIM_EXT_IRQ_COUNT || !ext_handler[irq] || previous == level)
+    return;
+
+  if (ext_mode[irq] == CHANGE ||
+      (ext_mode[irq] == RISING && level) ||
+      (ext_mode[irq] == FALLING && !level))
+    ext_pending[irq] = true;
+}
+
+uint8_t sim_pin_level(uint8_t pin)
+{
+  return pin < SIM_PIN_COUNT ? pin_level[pin] : LOW;
+}
+
+void sim_analog_input(uint8_t pin, uint16_t value)
+{
+  if (pin >= A0)
+    pin -= A0;
+  if (pin < NUM_ANALOG_INPUTS)
+    analog_value[pin] = value;
+}
+
+/**********************************  Noise  ***********************************/
+uint32_t sim_random()
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state;
+}
+
+float sim_noise(float amplitude)
+{
+  return amplitude * ((sim_random() & 0xFFFF) / 32767.5f - 1.0f);
+}
+
+float sim_wave(float period_s)
+{
+  return sin(2 * M_PI * (clock_ns / 1e9) / period_s);
+}
+
+/*****************************  Arduino core API  *****************************/
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  sim_advance(SIM_COST_DIGITAL_IO);
+  if (pin >= SIM_PIN_COUNT)
+    return;
+
+  pin_mode[pin] = mode;
+  if (mode == INPUT_PULLUP)
+    pin_level[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  sim_advance(SIM_COST_DIGITAL_IO);
+  if (pin >= SIM_PIN_COUNT)
+    return;
+
+  pin_level[pin] = value ? HIGH : LOW;
+  for (uint8_t i = 0; i < pin_hook_count; i++)
+    pin_hooks[i](pin, pin_level[pin]);
+}
+
+int digitalRead(uint8_t pin)
+{
+  sim_advance(SIM_COST_DIGITAL_IO);
+  return sim_pin_level(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+  sim_advance(SIM_COST_ANALOG_READ);
+
+  if (pin >= A0)
+    pin -= A0;
+  if (pin >= NUM_ANALOG_INPUTS)
+    return 0;
+
+  int value = analog_value[pin] + (int)sim_noise(2.0f);
+  return constrain(value, 0, 1023);
+}
+
+void analogReference(uint8_t mode)
+{
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  sim_advance(SIM_COST_DIGITAL_IO);
+}
+
+unsigned long millis(void)
+{
+  sim_advance(SIM_COST_MILLIS);
+  return clock_ns / SIM_MS;
+}
+
+// Timer0 counts in 4 us steps at 16 MHz
+unsigned long micros(void)
+{
+  sim_advance(SIM_COST_MICROS);
+  return (clock_ns / SIM_US) & ~3UL;
+}
+
+void delay(unsigned long ms)
+{
+  sim_stats.delay_ns += ms * SIM_MS;
+  sim_advance(ms * SIM_MS);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  sim_advance(us * SIM_US);
+}
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout)
+{
+  sim_advance(timeout * SIM_US);
+  return 0;
+}
+
+void attachInterrupt(uint8_t irq, void (*handler)(void), int mode)
+{
+  if (irq >= SIM_EXT_IRQ_COUNT)
+    return;
+
+  ext_handler[irq] = handler;
+  ext_mode[irq] = mode;
+  ext_pending[irq] = false;
+}
+
+void detachInterrupt(uint8_t irq)
+{
+  if (irq < SIM_EXT_IRQ_COUNT)
+    ext_handler[irq] = NULL;
+}
+
+void cli(void)
+{
+  SREG &= ~_BV(SREG_I);
+  clock_ns += SIM_COST_CLI_SEI;
+}
+
+void sei(void)
+{
+  SREG |= _BV(SREG_I);
+  clock_ns += SIM_COST_CLI_SEI;
+  if (!in_service)
+    sim_dispatch_interrupts();
+}
+
+void yield(void)
+{
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed)
+    random_state = seed;
+}
+
+long random(long howbig)
+{
+  return howbig > 0 ? sim_random() % howbig : 0;
+}
+
+long random(long howsmall, long howbig)
+{
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration)
+{
+}
+
+void noTone(uint8_t pin)
+{
+}
+
+/**********************************  EEPROM  **********************************/
+static uint8_t eeprom[E2END + 1];
+static bool eeprom_erased = false;
+static const char *eeprom_path = NULL;
+
+static uint8_t *eeprom_cells()
+{
+  if (!eeprom_erased)
+  {
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eeprom_erased = true;
+  }
+  return eeprom;
+}
+
+bool sim_eeprom_open(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+
+  eeprom_cells();
+  eeprom_path = path;
+  if (!f)
+    return true;
+
+  bool ok = fread(eeprom, 1, sizeof(eeprom), f) == sizeof(eeprom);
+  fclose(f);
+  return ok;
+}
+
+bool sim_eeprom_save()
+{
+  FILE *f;
+
+  if (!eeprom_path || !(f = fopen(eeprom_path, "wb")))
+    return false;
+
+  bool ok = fwrite(eeprom_cells(), 1, sizeof(eeprom), f) == sizeof(eeprom);
+  return fclose(f) == 0 && ok;
+}
+
+uint32_t eeprom_read_dword(const uint32_t *address)
+{
+  uint32_t value;
+
+  sim_advance(SIM_COST_EEPROM_READ);
+  memcpy(&value, eeprom_cells() + ((uintptr_t)address & E2END), sizeof(value));
+  return value;
+}
+
+void eeprom_update_dword(uint32_t *address, uint32_t value)
+{
+  uint8_t *cells = eeprom_cells() + ((uintptr_t)address & E2END);
+
+  // 3.4 ms per byte that changes, as the ATmega2560 datasheet
+  for (uint8_t i = 0; i < sizeof(value); i++, value >>= 8)
+  {
+    if (cells[i] != (uint8_t)value)
+    {
+      cells[i] = value;
+      sim_advance(SIM_COST_EEPROM_WRITE);
+    }
+  }
+}
+
+/*********************************  Watchdog  *********************************/
+void wdt_enable(uint8_t timeout)
+{
+  // WDTO_15MS doubles up to WDTO_2S, then 4 s and 8 s
+  wdt_period = (15ULL * SIM_MS) << timeout;
+  if (timeout >= WDTO_4S)
+    wdt_period = (timeout == WDTO_4S ? 4 : 8) * SIM_S;
+  wdt_deadline = clock_ns + wdt_period;
+}
+
+void wdt_disable(void)
+{
+  wdt_deadline = SIM_NEVER;
+}
+
+void wdt_reset(void)
+{
+  clock_ns += SIM_COST_CLI_SEI;
+  if (wdt_deadline != SIM_NEVER)
+    wdt_deadline = clock_ns + wdt_period;
+}
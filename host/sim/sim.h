@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * @file    sim.h
+ * @brief   Virtual time, pins, interrupts and bus statistics of the host build.
+ *
+ *          The sketch runs as plain code on the host, only the calls it makes
+ *          into the core and the buses take time: each call moves the clock
+ *          by about what it costs on a 16 MHz Mega, and delay() or a device
+ *          that is busy moves it further. Computation between those calls
+ *          is free, so cycle times are a lower bound that is exact for the
+ *          bus, card and serial waits that make up most of a cycle.
+ *
+ *          Devices are Sim_Device objects with timed events (a conversion
+ *          that finishes, a UART byte that arrives). The clock never passes
+ *          an event without servicing it, and pending interrupts run as soon
+ *          as the I flag of SREG allows.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef uint64_t sim_time_t;
+
+#define SIM_NEVER             UINT64_MAX
+#define SIM_US                1000ULL
+#define SIM_MS                1000000ULL
+#define SIM_S                 1000000000ULL
+
+// Cost of the core calls, in ns of a 16 MHz ATmega2560
+#define SIM_COST_MILLIS       1500
+#define SIM_COST_MICROS       2500
+#define SIM_COST_DIGITAL_IO   3500
+#define SIM_COST_ANALOG_READ  112000
+#define SIM_COST_CLI_SEI      63
+#define SIM_COST_ISR          2500
+#define SIM_COST_UART_WRITE   4000
+#define SIM_COST_UART_READ    1500
+#define SIM_COST_EEPROM_READ  1000
+#define SIM_COST_EEPROM_WRITE (3400 * SIM_US)
+
+struct sim_stats_t
+{
+    uint64_t i2c_transactions;
+    uint64_t i2c_bytes;
+    uint64_t i2c_nacks;
+    uint64_t spi_transactions;
+    uint64_t spi_bytes;
+    uint64_t sd_sectors_read;
+    uint64_t sd_sectors_written;
+    uint64_t sd_busy_ns;
+    uint64_t serial_tx_bytes;
+    uint64_t serial_rx_overruns;
+    uint64_t interrupts;
+    uint64_t delay_ns;
+    uint64_t sleep_ns;
+};
+
+extern sim_stats_t sim_stats;
+
+class Sim_Device
+{
+  public:
+    Sim_Device(const char *name);
+    virtual ~Sim_Device() {}
+
+    // Time of the next event, SIM_NEVER when nothing is scheduled
+    virtual sim_time_t next_event() { return SIM_NEVER; }
+    virtual void service(sim_time_t now) {}
+
+    // Cleared with sim_stats at the end of the warm-up
+    virtual void clear_stats() { transactions = 0; bytes = 0; }
+
+    const char *name;
+    uint64_t transactions;
+    uint64_t bytes;
+    Sim_Device *next;
+};
+
+Sim_Device *sim_devices();
+
+sim_time_t sim_now();
+void sim_advance(sim_time_t ns);
+void sim_advance_to(sim_time_t t);
+void sim_clear_stats();
+
+// sleep_cpu(): to the next Timer0 overflow or device event, whichever
+// comes first
+void sim_sleep();
+
+// Pins driven by the devices, edges reach attachInterrupt() handlers
+void sim_pin_input(uint8_t pin, uint8_t level);
+uint8_t sim_pin_level(uint8_t pin);
+void sim_analog_input(uint8_t pin, uint16_t value);
+
+// Called on every digitalWrite(), the SPI bus selects devices with it
+typedef void (*sim_pin_hook_f)(uint8_t pin, uint8_t level);
+void sim_on_pin_write(sim_pin_hook_f hook);
+
+// Level triggered interrupt sources, polled whenever interrupts may run. A
+// source returns true when it ran its vector through sim_run_isr().
+typedef bool (*sim_irq_source_f)();
+void sim_add_irq_source(sim_irq_source_f source);
+void sim_run_isr(void (*vector)(void));
+
+bool sim_interrupts_enabled();
+void sim_dispatch_interrupts();
+
+// Where the console (USART0 or Serial) output goes, NULL drops it
+extern FILE *sim_console;
+
+// Keeps virtual time from running ahead of the wall clock, for a console
+// that a program on the host talks to
+void sim_realtime(bool on);
+
+// EEPROM contents, erased (0xFF) unless loaded from a file. A run on the
+// same file is a reset of the pod, not a new chip.
+bool sim_eeprom_open(const char *path);
+bool sim_eeprom_save();
+
+// Deterministic noise for the simulated readings
+uint32_t sim_random();
+float sim_noise(float amplitude);
+// Slow variation of a reading, sin() over period_s of virtual time
+float sim_wave(float period_s);
+
+#endif  // _SIM_H
@@ -0,0 +1,224 @@
+/*******************************************************************************
+ * @file    usart0.cpp
+ * @brief   USART0 registers for a sketch that drives the console UART itself.
+ *
+ *          UDR0 feeds a one byte data register and the shift register, which
+ *          sends a byte in 10 bit times of the UBRR0 baud rate. UDRE0, TXC0
+ *          and RXC0 follow that state, and the UDRE and RX vectors run while
+ *          their enable bits in UCSR0B are set, as on the chip.
+ *
+ *          With a pseudo terminal attached, the console output goes to it
+ *          and what the other end writes arrives a byte per 10 bit times.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <avr/io.h>
+
+#include "sim.h"
+#include "usart0.h"
+
+extern "C" void USART0_RX_vect(void) __attribute__((weak));
+extern "C" void USART0_UDRE_vect(void) __attribute__((weak));
+
+Usart0_Status_Reg UCSR0A;
+Usart0_Data_Reg UDR0;
+volatile uint8_t UCSR0B;
+volatile uint8_t UCSR0C;
+volatile uint8_t UBRR0H;
+volatile uint8_t UBRR0L;
+
+class Usart0 : public Sim_Device
+{
+  public:
+    Usart0() : Sim_Device("USART0"), u2x(false), txc(false), data_full(false),
+               shifting(false), shift_done(SIM_NEVER), rx_full(false), pty(-1),
+               rx_poll(SIM_NEVER) {}
+
+    sim_time_t next_event() { return shift_done < rx_poll ? shift_done : rx_poll; }
+
+    void service(sim_time_t now)
+    {
+      if (now >= rx_poll)
+        poll_pty(now);
+      if (now < shift_done)
+        return;
+
+      shifting = false;
+      shift_done = SIM_NEVER;
+      if (data_full)
+        shift(data);
+      else
+        txc = true;
+    }
+
+    // A byte a character time while the other end has any, the receiver
+    // keeps the one it has until the sketch reads it
+    void poll_pty(sim_time_t now)
+    {
+      uint8_t value;
+
+      if ((UCSR0B & _BV(RXEN0)) && !rx_full && ::read(pty, &value, 1) == 1)
+      {
+        receive(value);
+        rx_poll = now + byte_time();
+      }
+      else
+        rx_poll = now + SIM_MS;
+    }
+
+    void write(uint8_t value)
+    {
+      if (!(UCSR0B & _BV(TXEN0)))
+        return;
+
+      if (!shifting)
+        shift(value);
+      else
+      {
+        data = value;
+        data_full = true;
+      }
+    }
+
+    void shift(uint8_t value)
+    {
+      data_full = false;
+      shifting = true;
+      shift_done = sim_now() + byte_time();
+      bytes++;
+
+      sim_stats.serial_tx_bytes++;
+      if (sim_console)
+        fputc(value, sim_console);
+    }
+
+    uint64_t byte_time()
+    {
+      uint16_t ubrr = (UBRR0H << 8) | UBRR0L;
+
+      return 10ULL * (u2x ? 8 : 16) * (ubrr + 1) * SIM_S / F_CPU;
+    }
+
+    uint8_t status()
+    {
+      return (rx_full ? _BV(RXC0) : 0) | (txc ? _BV(TXC0) : 0) |
+             (data_full ? 0 : _BV(UDRE0)) | (u2x ? _BV(U2X0) : 0);
+    }
+
+    void write_status(uint8_t value)
+    {
+      u2x = value & _BV(U2X0);
+      // TXC0 is cleared by writing a one to it
+      if (value & _BV(TXC0))
+        txc = false;
+    }
+
+    uint8_t read()
+    {
+      rx_full = false;
+      return rx_data;
+    }
+
+    void receive(uint8_t value)
+    {
+      if (!(UCSR0B & _BV(RXEN0)))
+        return;
+      if (rx_full)
+        sim_stats.serial_rx_overruns++;
+      rx_data = value;
+      rx_full = true;
+    }
+
+    bool u2x;
+    bool txc;
+    uint8_t data;
+    bool data_full;
+    bool shifting;
+    sim_time_t shift_done;
+    uint8_t rx_data;
+    bool rx_full;
+    int pty;
+    sim_time_t rx_poll;
+};
+
+static Usart0 usart0;
+
+Usart0_Status_Reg &Usart0_Status_Reg::operator=(uint8_t value)
+{
+  usart0.write_status(value);
+  return *this;
+}
+
+// A register access is a cycle, polling loops on the flags see time pass
+Usart0_Status_Reg::operator uint8_t() const
+{
+  sim_advance(SIM_COST_CLI_SEI);
+  return usart0.status();
+}
+
+Usart0_Data_Reg &Usart0_Data_Reg::operator=(uint8_t value)
+{
+  sim_advance(SIM_COST_CLI_SEI);
+  usart0.write(value);
+  return *this;
+}
+
+Usart0_Data_Reg::operator uint8_t() const
+{
+  return usart0.read();
+}
+
+static bool usart0_irq()
+{
+  if (usart0.rx_full && (UCSR0B & _BV(RXCIE0)) && USART0_RX_vect)
+  {
+    sim_run_isr(USART0_RX_vect);
+    return true;
+  }
+  if (!usart0.data_full && (UCSR0B & _BV(UDRIE0)) && USART0_UDRE_vect)
+  {
+    sim_run_isr(USART0_UDRE_vect);
+    return true;
+  }
+  return false;
+}
+
+void usart0_attach()
+{
+  sim_add_irq_source(usart0_irq);
+}
+
+bool usart0_enabled()
+{
+  return UCSR0B & _BV(RXEN0);
+}
+
+void usart0_receive(uint8_t value)
+{
+  usart0.receive(value);
+}
+
+const char *usart0_open_pty()
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+  if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+    return NULL;
+
+  // Unbuffered, the other end sees each byte as it is sent. A full pty
+  // drops bytes like a cable nobody listens on.
+  sim_console = fdopen(fd, "w");
+  if (!sim_console)
+    return NULL;
+  setvbuf(sim_console, NULL, _IONBF, 0);
+
+  usart0.pty = fd;
+  usart0.rx_poll = sim_now();
+  return ptsname(fd);
+}
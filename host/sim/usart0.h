@@ -0,0 +1,21 @@
+/*******************************************************************************
+ * @file    usart0.h
+ * @brief   Host side of the USART0 register emulation.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SIM_USART0_H
+#define _SIM_USART0_H
+
+#include <stdint.h>
+
+void usart0_attach();
+// True once the sketch has enabled the receiver, it owns the console then
+bool usart0_enabled();
+void usart0_receive(uint8_t value);
+// Connects the console to a new pseudo terminal and returns the name of
+// its other end, NULL if none could be made
+const char *usart0_open_pty();
+
+#endif  // _SIM_USART0_H
@@ -0,0 +1,427 @@
+/*******************************************************************************
+ * @file    xpod_host.cpp
+ * @brief   Runs the pod firmware on Linux against simulated sensors and
+ *          reports what one loop() cycle costs in virtual time.
+ *
+ *          usage: xpod_host [--cycles N] [--image FILE] [--size-mb N]
+ *                           [--start YYYY-MM-DDThh:mm:ss] [--serial FILE|-]
+ *                           [--profile] [--pty] [--unplug NAME:FROM:TO]
+ *                           [--put FILE] [--get DIR]
+ *
+ *          The SD card is an image file, a new one is formatted before the
+ *          firmware boots and keeps the logs of every run after that (mount
+ *          it with `mount -o loop` to look at the files). The EEPROM is kept
+ *          in IMAGE.eeprom, so the next run on an image is a reset of the
+ *          pod. --serial keeps the console output, --profile sends 'p'
+ *          before the last cycle. --pty puts the console on a pseudo
+ *          terminal instead and runs in step with the wall clock, so that a
+ *          host program (tools/xpod_download) can talk to the pod.
+ *          --unplug takes the I2C device NAME (as in the device report)
+ *          off the bus from cycle FROM to TO, setup() being cycle 0; it
+ *          can be given more than once. --put copies a file into the
+ *          card's root directory before the boot, XPOD.CFG for one.
+ *          --get closes the day's log after the run, as the pod does at
+ *          midnight, and copies the files of the card's root to DIR.
+ *
+ *          The first cycle is left out of the report, it opens new files and
+ *          sends the header lines.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <getopt.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <SdFat.h>
+
+#include "sim.h"
+#include "devices.h"
+#include "usart0.h"
+#include "xpod_node.h"
+#include "xpod_config.h"
+
+#define DEFAULT_CYCLES        100
+#define DEFAULT_IMAGE         "xpod_sd.img"
+#define DEFAULT_SIZE_MB       128
+#define DEFAULT_START         "2026-10-18T12:00:00"
+
+#if SDCARD_LOG_ENABLED
+// The sketch's, it syncs and closes the day's log
+void close_log();
+#endif
+
+struct metric_t
+{
+    const char *name;
+    const char *unit;
+    double scale;
+    double sum;
+    double min;
+    double max;
+};
+
+enum
+{
+  M_CYCLE, M_WORK, M_SLEEP, M_I2C_TRANS, M_I2C_BYTES, M_I2C_NACKS, M_SPI_TRANS, M_SPI_BYTES,
+  M_SD_READ, M_SD_WRITTEN, M_SD_BUSY, M_SERIAL, M_RX_OVERRUNS, M_IRQS, M_COUNT
+};
+
+static metric_t metrics[M_COUNT] = {
+  {"cycle time", "ms", 1e-6, 0, 0, 0},
+  {"work time (cycle - delay, sleep)", "ms", 1e-6, 0, 0, 0},
+  {"sleep", "ms", 1e-6, 0, 0, 0},
+  {"I2C transactions", "", 1, 0, 0, 0},
+  {"I2C bytes", "", 1, 0, 0, 0},
+  {"I2C NACKs", "", 1, 0, 0, 0},
+  {"SPI transactions", "", 1, 0, 0, 0},
+  {"SPI bytes", "", 1, 0, 0, 0},
+  {"SD sectors read", "", 1, 0, 0, 0},
+  {"SD sectors written", "", 1, 0, 0, 0},
+  {"SD busy", "ms", 1e-6, 0, 0, 0},
+  {"console bytes", "", 1, 0, 0, 0},
+  {"UART RX overruns", "", 1, 0, 0, 0},
+  {"interrupts", "", 1, 0, 0, 0},
+};
+
+static void record(uint8_t m, double value, unsigned long n)
+{
+  metric_t &metric = metrics[m];
+
+  value *= metric.scale;
+  metric.sum += value;
+  metric.min = (n == 0 || value < metric.min) ? value : metric.min;
+  metric.max = (n == 0 || value > metric.max) ? value : metric.max;
+}
+
+static void usage()
+{
+  fprintf(stderr,
+          "usage: xpod_host [--cycles N] [--image FILE] [--size-mb N]\n"
+          "                 [--start YYYY-MM-DDThh:mm:ss] [--serial FILE|-] [--profile]\n"
+          "                 [--pty] [--unplug NAME:FROM:TO] [--put FILE] [--get DIR]\n");
+  exit(2);
+}
+
+// A new image gets a file system before the firmware sees it
+static bool format_image(uint8_t cs_pin)
+{
+  SdFat formatter;
+
+  if (!formatter.cardBegin(SdSpiConfig(cs_pin, SHARED_SPI, SD_SCK_MHZ(4))))
+    return false;
+  return formatter.format();
+}
+
+// Copies a host file into the card's root directory under its own name
+static bool put_file(uint8_t cs_pin, const char *path)
+{
+  SdFat card;
+  FsFile out;
+  const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+  FILE *in = fopen(path, "rb");
+  uint8_t buffer[512];
+  size_t length;
+  bool ok;
+
+  if (!in)
+    return false;
+  ok = card.begin(SdSpiConfig(cs_pin, SHARED_SPI, SD_SCK_MHZ(4))) &&
+       out.open(name, O_WRONLY | O_CREAT | O_TRUNC);
+  while (ok && (length = fread(buffer, 1, sizeof(buffer), in)) > 0)
+    ok = out.write(buffer, length) == length;
+  ok = out.close() && ok;
+  fclose(in);
+  return ok;
+}
+
+// Copies the files of the card's root directory into the host directory
+static bool get_files(uint8_t cs_pin, const char *dir)
+{
+  SdFat card;
+  FsFile root;
+  FsFile in;
+  bool ok = card.begin(SdSpiConfig(cs_pin, SHARED_SPI, SD_SCK_MHZ(4))) && root.open("/");
+
+  while (ok && in.openNext(&root, O_RDONLY))
+  {
+    char name[64];
+    uint8_t buffer[512];
+    int length;
+
+    if (in.isFile() && in.getName(name, sizeof(name)))
+    {
+      std::string path = std::string(dir) + "/" + name;
+      FILE *out = fopen(path.c_str(), "wb");
+
+      ok = out != NULL;
+      while (ok && (length = in.read(buffer, sizeof(buffer))) > 0)
+        ok = fwrite(buffer, 1, length, out) == (size_t)length;
+      ok = ok && length == 0;
+      if (out)
+        ok = fclose(out) == 0 && ok;
+    }
+    in.close();
+  }
+  return ok;
+}
+
+struct unplug_t
+{
+    std::string name;
+    unsigned long from;
+    unsigned long to;
+};
+
+static std::vector<unplug_t> unplugs;
+
+static bool parse_unplug(const char *arg)
+{
+  const char *colon = strchr(arg, ':');
+  unplug_t unplug;
+
+  if (!colon || sscanf(colon + 1, "%lu:%lu", &unplug.from, &unplug.to) != 2)
+    return false;
+  unplug.name.assign(arg, colon - arg);
+  unplugs.push_back(unplug);
+  return true;
+}
+
+// Plugs the devices in and out for the cycle about to run
+static void apply_unplugs(unsigned long cycle)
+{
+  for (Sim_I2C_Device *d = sim_i2c_devices(); d; d = d->next_on_bus)
+  {
+    d->unplugged = false;
+    for (size_t i = 0; i < unplugs.size(); i++)
+    {
+      if (unplugs[i].name == d->name && cycle >= unplugs[i].from && cycle <= unplugs[i].to)
+        d->unplugged = true;
+    }
+  }
+}
+
+static void send_console(uint8_t c)
+{
+  if (usart0_enabled())
+    usart0_receive(c);
+  else
+    Serial.sim_receive(c);
+}
+
+int main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    {"cycles", required_argument, NULL, 'c'},
+    {"image", required_argument, NULL, 'i'},
+    {"size-mb", required_argument, NULL, 'm'},
+    {"start", required_argument, NULL, 't'},
+    {"serial", required_argument, NULL, 's'},
+    {"profile", no_argument, NULL, 'p'},
+    {"pty", no_argument, NULL, 'y'},
+    {"unplug", required_argument, NULL, 'u'},
+    {"put", required_argument, NULL, 'f'},
+    {"get", required_argument, NULL, 'g'},
+    {NULL, 0, NULL, 0}
+  };
+  unsigned long cycles = DEFAULT_CYCLES;
+  const char *image = DEFAULT_IMAGE;
+  unsigned long size_mb = DEFAULT_SIZE_MB;
+  const char *start = DEFAULT_START;
+  const char *serial = NULL;
+  bool profile = false;
+  bool pty = false;
+  std::vector<const char *> put_files;
+  const char *get_dir = NULL;
+  int opt;
+
+  while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+      case 'c': cycles = strtoul(optarg, NULL, 0); break;
+      case 'i': image = optarg; break;
+      case 'm': size_mb = strtoul(optarg, NULL, 0); break;
+      case 't': start = optarg; break;
+      case 's': serial = optarg; break;
+      case 'p': profile = true; break;
+      case 'y': pty = true; break;
+      case 'u': if (!parse_unplug(optarg)) usage(); break;
+      case 'f': put_files.push_back(optarg); break;
+      case 'g': get_dir = optarg; break;
+      default: usage();
+    }
+  }
+  if (optind != argc || cycles < 2 || size_mb == 0)
+    usage();
+
+  DateTime start_time(start);
+  if (!start_time.isValid())
+  {
+    fprintf(stderr, "xpod_host: bad start time %s\n", start);
+    return 2;
+  }
+
+  if (pty)
+  {
+    const char *name = usart0_open_pty();
+
+    if (!name)
+    {
+      perror("xpod_host: pty");
+      return 1;
+    }
+    fprintf(stderr, "xpod_host: console on %s\n", name);
+  }
+  else if (serial)
+  {
+    sim_console = strcmp(serial, "-") == 0 ? stdout : fopen(serial, "w");
+    if (!sim_console)
+    {
+      perror(serial);
+      return 1;
+    }
+  }
+
+  // The pod as wired in xpod_node.h and the module headers, inputs are
+  // voltages at the ADC pins. The models are never freed: the sketch's
+  // global SdFile closes through the card model when the program exits.
+  new Sim_ADS1115("ADS1115 0x48", 0x48, 1.20f, 0.85f, 0.42f, 0.95f);
+  new Sim_ADS1115("ADS1115 0x49", 0x49, 1.10f, 0.80f, 1.35f, 0.00f);
+  new Sim_ADS1115("ADS1115 0x4A", 0x4A, 0.61f, 0.60f, 0.55f, 0.54f);
+  new Sim_ADS1115("ADS1115 0x4B", 0x4B, 0.72f, 0.38f, 0.00f, 0.00f);
+  new Sim_MCP3424("MCP3424 0x69", 0x69, 0.31f, 0.30f, 0.22f, 0.21f);
+  new Sim_MCP3424("MCP3424 0x6E", 0x6E, 0.27f, 0.26f, 0.35f, 0.34f);
+  new Sim_BME680("BME680", 0x76);
+  new Sim_S300("S300", 0x31);
+  new Sim_DS3231("DS3231", 0x68, start_time.unixtime(), RTC_SQW_PIN);
+  new Sim_PMS5003("PMS5003", Serial1, 9600);
+  new Sim_OPC_R2("OPC-R2", 49);
+  Sim_SD_Card &card = *new Sim_SD_Card("SD card", SD_CARD_CS_PIN);
+
+  sim_analog_input(IN_VOLT_PIN, 489);
+  sim_analog_input(MOTOR_CTRL_IN_PIN, 512);
+
+  bool formatted = access(image, F_OK) == 0;
+  if (!card.open(image, size_mb))
+  {
+    perror(image);
+    return 1;
+  }
+  if (!formatted && !format_image(SD_CARD_CS_PIN))
+  {
+    fprintf(stderr, "xpod_host: failed to format %s\n", image);
+    return 1;
+  }
+  for (size_t i = 0; i < put_files.size(); i++)
+  {
+    if (!put_file(SD_CARD_CS_PIN, put_files[i]))
+    {
+      fprintf(stderr, "xpod_host: failed to copy %s to the card\n", put_files[i]);
+      return 1;
+    }
+  }
+
+  std::string eeprom = std::string(image) + ".eeprom";
+  if (!sim_eeprom_open(eeprom.c_str()))
+  {
+    fprintf(stderr, "xpod_host: failed to read %s\n", eeprom.c_str());
+    return 1;
+  }
+
+  usart0_attach();
+  sim_clear_stats();
+
+  if (pty)
+    sim_realtime(true);
+
+  sim_time_t boot = sim_now();
+  apply_unplugs(0);
+  setup();
+  double setup_ms = (sim_now() - boot) / 1e6;
+
+  // Warm-up cycle
+  apply_unplugs(1);
+  loop();
+  sim_clear_stats();
+
+  unsigned long measured = cycles - 1;
+  sim_stats_t last = sim_stats;
+
+  for (unsigned long n = 0; n < measured; n++)
+  {
+    if (profile && n == measured - 1)
+      send_console('p');
+
+    sim_time_t begin = sim_now();
+    apply_unplugs(n + 2);
+    loop();
+    sim_time_t cycle = sim_now() - begin;
+    const sim_stats_t &s = sim_stats;
+
+    record(M_CYCLE, cycle, n);
+    record(M_WORK, cycle - (s.delay_ns - last.delay_ns) - (s.sleep_ns - last.sleep_ns), n);
+    record(M_SLEEP, s.sleep_ns - last.sleep_ns, n);
+    record(M_I2C_TRANS, s.i2c_transactions - last.i2c_transactions, n);
+    record(M_I2C_BYTES, s.i2c_bytes - last.i2c_bytes, n);
+    record(M_I2C_NACKS, s.i2c_nacks - last.i2c_nacks, n);
+    record(M_SPI_TRANS, s.spi_transactions - last.spi_transactions, n);
+    record(M_SPI_BYTES, s.spi_bytes - last.spi_bytes, n);
+    record(M_SD_READ, s.sd_sectors_read - last.sd_sectors_read, n);
+    record(M_SD_WRITTEN, s.sd_sectors_written - last.sd_sectors_written, n);
+    record(M_SD_BUSY, s.sd_busy_ns - last.sd_busy_ns, n);
+    record(M_SERIAL, s.serial_tx_bytes - last.serial_tx_bytes, n);
+    record(M_RX_OVERRUNS, s.serial_rx_overruns - last.serial_rx_overruns, n);
+    record(M_IRQS, s.interrupts - last.interrupts, n);
+    last = s;
+  }
+
+  // Let the console drain what the last cycle queued
+  sim_advance(200 * SIM_MS);
+
+  if (sim_console && sim_console != stdout)
+    fclose(sim_console);
+  if (!sim_eeprom_save())
+    perror(eeprom.c_str());
+
+  printf("xpod_host: %lu cycles after the warm-up, loop_period_ms %u, setup %.1f ms\n\n",
+         measured, xpod_config.loop_period_ms, setup_ms);
+  printf("%-32s %12s %12s %12s\n", "per cycle", "mean", "min", "max");
+  for (uint8_t m = 0; m < M_COUNT; m++)
+  {
+    char label[48];
+
+    snprintf(label, sizeof(label), metrics[m].unit[0] ? "%s [%s]" : "%s", metrics[m].name,
+             metrics[m].unit);
+    printf("%-32s %12.3f %12.3f %12.3f\n", label, metrics[m].sum / measured, metrics[m].min,
+           metrics[m].max);
+  }
+
+  printf("\n%-32s %12s %12s\n", "device", "trans/cycle", "bytes/cycle");
+  for (Sim_Device *d = sim_devices(); d; d = d->next)
+    printf("%-32s %12.2f %12.2f\n", d->name, (double)d->transactions / measured,
+           (double)d->bytes / measured);
+
+  printf("\nbytes written to the card: %llu (%.1f per cycle)\n",
+         (unsigned long long)card.sectors_written * 512,
+         card.sectors_written * 512.0 / measured);
+
+  if (get_dir)
+  {
+    #if SDCARD_LOG_ENABLED
+      close_log();
+    #endif
+    if (!get_files(SD_CARD_CS_PIN, get_dir))
+    {
+      fprintf(stderr, "xpod_host: failed to copy the card's files to %s\n", get_dir);
+      return 1;
+    }
+  }
+  return 0;
+}
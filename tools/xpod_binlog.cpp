@@ -0,0 +1,454 @@
+/*******************************************************************************
+ * @file    xpod_binlog.cpp
+ * @brief   Converts a binary log of an xpod back to its CSV text.
+ *
+ *          Reads a daily .bin file written with BIN_LOG_ENABLED and writes
+ *          the file the pod would have written without it: the header line,
+ *          then "\r\n" and one line per record, with its Seq and CRC columns.
+ *          Only the data the file header counts is read, the rest of the
+ *          preallocated space is left alone. Records that fail their CRC are
+ *          skipped and counted on stderr; in a delta coded file so are the
+ *          ones up to the next keyframe.
+ *
+ *          The file is read as a stream, "-" reads it from stdin.
+ *
+ *          File layout: see xpod_V3.1.2/bin_log.h.
+ *
+ *          Build:  g++ -O2 -o xpod_binlog xpod_binlog.cpp
+ *          Use:    ./xpod_binlog OPOD12_2026_10_18.bin > OPOD12_2026_10_18.txt
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "../xpod_V3.1.2/crc16.h"
+
+#define BIN_LOG_VERSION       3
+#define BIN_LOG_HEADER_SIZE   1024
+#define BIN_LOG_MAX_COLUMNS   96
+#define BIN_LOG_TRAILER_SIZE  6
+
+#define BIN_LOG_KEYFRAME      'K'
+#define BIN_LOG_DELTA         'D'
+
+#define BIN_LOG_EMPTY         0x80000000UL
+#define BIN_LOG_NAN           0x80000001UL
+#define BIN_LOG_INF           0x80000002UL
+#define BIN_LOG_OVF           0x80000003UL
+#define BIN_LOG_NEG_ZERO      0x80000004UL
+#define BIN_LOG_EMPTY_TEXT    0xFF
+
+#define TELEMETRY_SKIP        0x00
+#define TELEMETRY_INT         0x10
+#define TELEMETRY_UINT        0x20
+#define TELEMETRY_FIXED       0x30
+#define TELEMETRY_TIME        0x40
+#define TELEMETRY_TEXT        0x50
+
+// bin_log_header_t, offsets of the packed AVR layout
+#define HDR_VERSION           4
+#define HDR_COLUMN_COUNT      5
+#define HDR_RECORD_SIZE       6
+#define HDR_RECORDS           8
+#define HDR_DATA_SIZE         12
+#define HDR_KEYFRAME_INTERVAL 20
+#define HDR_TAG               24
+#define HDR_WIDTH             (HDR_TAG + BIN_LOG_MAX_COLUMNS)
+#define HDR_SIZE              (HDR_WIDTH + BIN_LOG_MAX_COLUMNS)
+
+struct decode_stats_t
+{
+    unsigned long records;
+    unsigned long bad;
+    unsigned long skipped;
+};
+
+static uint32_t get_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void set_le32(uint8_t *p, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    p[i] = value >> (8 * i);
+}
+
+// Bytes of the file as they come, with room to step back over a record
+// that turned out bad
+class Stream_Window
+{
+  public:
+    Stream_Window(FILE *in, uint32_t limit) : in(in), limit(limit), start(0), consumed(0) {}
+
+    // Byte `i` from the current position, -1 past the data
+    int at(size_t i)
+    {
+      while (start + i >= buf.size())
+      {
+        uint8_t chunk[4096];
+        size_t want = sizeof(chunk);
+        uint32_t left = limit - consumed - (uint32_t)(buf.size() - start);
+
+        if (want > left)
+          want = left;
+        size_t n = want ? fread(chunk, 1, want, in) : 0;
+        if (n == 0)
+          return -1;
+        buf.insert(buf.end(), chunk, chunk + n);
+      }
+      return buf[start + i];
+    }
+
+    const uint8_t *data() { return buf.data() + start; }
+
+    void skip(size_t n)
+    {
+      start += n;
+      consumed += n;
+      if (start > 65536)
+      {
+        buf.erase(buf.begin(), buf.begin() + start);
+        start = 0;
+      }
+    }
+
+  private:
+    FILE *in;
+    uint32_t limit;
+    std::vector<uint8_t> buf;
+    size_t start;
+    uint32_t consumed;
+};
+
+static bool get_varint(const uint8_t *&p, const uint8_t *end, uint32_t &value)
+{
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7)
+  {
+    if (p >= end)
+      return false;
+    value |= (uint32_t)(*p & 0x7F) << shift;
+    if (!(*p++ & 0x80))
+      return true;
+  }
+  return false;
+}
+
+static uint32_t unzigzag(uint32_t value)
+{
+  return (value >> 1) ^ (0U - (value & 1));
+}
+
+static void put_fixed(std::string &line, int32_t value, uint8_t decimals)
+{
+  char buf[32];
+  uint32_t mag = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+  uint32_t scale = 1;
+
+  // 10^9 is the largest power of ten in 32 bits
+  if (decimals > 9)
+    decimals = 9;
+
+  for (uint8_t i = 0; i < decimals; i++)
+    scale *= 10;
+
+  if (decimals)
+    snprintf(buf, sizeof(buf), "%s%lu.%0*lu", value < 0 ? "-" : "",
+             (unsigned long)(mag / scale), decimals, (unsigned long)(mag % scale));
+  else
+    snprintf(buf, sizeof(buf), "%ld", (long)value);
+
+  line += buf;
+}
+
+// The Seq and CRC columns of log_record.h's seal_record()
+static void seal_line(std::string &line, uint32_t seq)
+{
+  char buf[16];
+
+  snprintf(buf, sizeof(buf), ",%lu,", (unsigned long)seq);
+  line += buf;
+  snprintf(buf, sizeof(buf), "%04X", crc16(line.data(), line.size()));
+  line += buf;
+}
+
+// The CSV text of one record, as CSV_Writer formats the sample
+static void record_line(const uint8_t *header, const uint8_t *p, std::string &line)
+{
+  uint8_t columns = header[HDR_COLUMN_COUNT];
+  char buf[32];
+
+  line.clear();
+  for (uint8_t i = 0; i < columns; i++)
+  {
+    uint8_t tag = header[HDR_TAG + i];
+    uint8_t width = header[HDR_WIDTH + i];
+    uint8_t type = tag & 0xF0;
+
+    if (i > 0)
+      line += ',';
+
+    const uint8_t *slot = p;
+    p += width;
+
+    if (width == 0)
+      continue;
+
+    if (type == TELEMETRY_TEXT)
+    {
+      if (slot[0] != BIN_LOG_EMPTY_TEXT)
+        line.append((const char *)slot, strnlen((const char *)slot, width));
+      continue;
+    }
+
+    uint32_t value = get_le32(slot);
+
+    if (value == BIN_LOG_EMPTY || type == TELEMETRY_SKIP)
+      continue;
+
+    if (type == TELEMETRY_FIXED)
+    {
+      switch (value)
+      {
+        case BIN_LOG_NAN: line += "nan"; continue;
+        case BIN_LOG_INF: line += "inf"; continue;
+        case BIN_LOG_OVF: line += "ovf"; continue;
+        case BIN_LOG_NEG_ZERO: line += '-'; value = 0; break;
+      }
+    }
+
+    switch (type)
+    {
+      case TELEMETRY_INT:
+        snprintf(buf, sizeof(buf), "%ld", (long)(int32_t)value);
+        line += buf;
+        break;
+
+      case TELEMETRY_UINT:
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)value);
+        line += buf;
+        break;
+
+      case TELEMETRY_FIXED:
+        put_fixed(line, (int32_t)value, tag & 0x0F);
+        break;
+
+      case TELEMETRY_TIME:
+      {
+        time_t t = value;
+        struct tm tm;
+
+        gmtime_r(&t, &tm);
+        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+        line += buf;
+        break;
+      }
+    }
+  }
+}
+
+static void print_record(const uint8_t *header, const uint8_t *record, uint32_t seq,
+                         decode_stats_t &stats)
+{
+  std::string line;
+
+  record_line(header, record, line);
+  seal_line(line, seq);
+  fprintf(stdout, "\r\n%s", line.c_str());
+  stats.records++;
+}
+
+static void decode_fixed(const uint8_t *header, Stream_Window &data, decode_stats_t &stats)
+{
+  uint16_t record_size = header[HDR_RECORD_SIZE] | (header[HDR_RECORD_SIZE + 1] << 8);
+  size_t stride = record_size + BIN_LOG_TRAILER_SIZE;
+
+  while (data.at(stride - 1) >= 0)
+  {
+    const uint8_t *p = data.data();
+    const uint8_t *trailer = p + record_size;
+
+    if (crc16(p, record_size + 4) == (trailer[4] | (trailer[5] << 8)))
+      print_record(header, p, get_le32(trailer), stats);
+    else
+      stats.bad++;
+    data.skip(stride);
+  }
+}
+
+// Rebuilds the slots of a delta coded record in `record`, which holds the
+// previous one
+static bool decode_payload(const uint8_t *header, const uint8_t *p, const uint8_t *end,
+                           bool keyframe, uint8_t *record, uint32_t &seq)
+{
+  uint32_t value;
+
+  if (!get_varint(p, end, value))
+    return false;
+  seq = keyframe ? value : seq + value;
+
+  for (uint8_t i = 0; i < header[HDR_COLUMN_COUNT]; i++)
+  {
+    uint8_t width = header[HDR_WIDTH + i];
+
+    if (width == 4)
+    {
+      if (!get_varint(p, end, value))
+        return false;
+      set_le32(record, (keyframe ? 0 : get_le32(record)) + unzigzag(value));
+    }
+    else if (width > 0)
+    {
+      bool changed = keyframe;
+
+      if (!keyframe)
+      {
+        if (p >= end || *p > 1)
+          return false;
+        changed = *p++ == 1;
+      }
+      if (changed)
+      {
+        if (end - p < width)
+          return false;
+        memcpy(record, p, width);
+        p += width;
+      }
+    }
+    record += width;
+  }
+
+  return p == end;
+}
+
+static void decode_delta(const uint8_t *header, Stream_Window &data, decode_stats_t &stats)
+{
+  uint16_t record_size = header[HDR_RECORD_SIZE] | (header[HDR_RECORD_SIZE + 1] << 8);
+  std::vector<uint8_t> record(record_size);
+  bool have_prev = false;
+  bool lost = false;
+  uint32_t seq = 0;
+  int kind;
+
+  while ((kind = data.at(0)) >= 0)
+  {
+    // Kind, length and payload, then the CRC of them
+    uint32_t length = 0;
+    size_t head = 1;
+    int c;
+
+    do
+    {
+      c = data.at(head);
+      if (c < 0)
+        return;
+      length |= (uint32_t)(c & 0x7F) << (7 * (head - 1));
+      head++;
+    } while ((c & 0x80) && head < 4);
+
+    bool framed = (kind == BIN_LOG_KEYFRAME || kind == BIN_LOG_DELTA) && !(c & 0x80);
+    size_t size = head + length;
+
+    if (framed && data.at(size + 1) < 0)
+      return;
+
+    const uint8_t *p = data.data();
+    if (!framed || crc16(p, size) != (p[size] | (p[size + 1] << 8)))
+    {
+      // Look for the next record a byte further on
+      if (!lost)
+        stats.bad++;
+      lost = true;
+      have_prev = false;
+      data.skip(1);
+      continue;
+    }
+    lost = false;
+
+    bool keyframe = kind == BIN_LOG_KEYFRAME;
+    if (!keyframe && !have_prev)
+      stats.skipped++;
+    else if (decode_payload(header, p + head, p + size, keyframe, record.data(), seq))
+    {
+      have_prev = true;
+      print_record(header, record.data(), seq, stats);
+    }
+    else
+    {
+      stats.bad++;
+      have_prev = false;
+    }
+    data.skip(size + 2);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint8_t header[BIN_LOG_HEADER_SIZE];
+  const char *path;
+  FILE *in;
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s log.bin|-\n", argv[0]);
+    return 2;
+  }
+
+  path = argv[1];
+  if (strcmp(path, "-") == 0)
+    in = stdin;
+  else if (!(in = fopen(path, "rb")))
+  {
+    perror(path);
+    return 1;
+  }
+
+  if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+      memcmp(header, "XPBL", 4) != 0 || header[HDR_VERSION] != BIN_LOG_VERSION ||
+      header[HDR_COLUMN_COUNT] > BIN_LOG_MAX_COLUMNS)
+  {
+    fprintf(stderr, "%s: not a version %d xpod binary log\n", path, BIN_LOG_VERSION);
+    return 1;
+  }
+
+  uint16_t record_size = header[HDR_RECORD_SIZE] | (header[HDR_RECORD_SIZE + 1] << 8);
+  uint32_t records = get_le32(header + HDR_RECORDS);
+  uint32_t data_size = get_le32(header + HDR_DATA_SIZE);
+  unsigned long slots = 0;
+
+  for (uint8_t i = 0; i < header[HDR_COLUMN_COUNT]; i++)
+    slots += header[HDR_WIDTH + i];
+  if (slots != record_size)
+  {
+    fprintf(stderr, "%s: column widths do not add up to the record size\n", path);
+    return 1;
+  }
+
+  // The CSV header line follows the struct, padded with zeros
+  fwrite(header + HDR_SIZE, 1, strnlen((const char *)header + HDR_SIZE, sizeof(header) - HDR_SIZE),
+         stdout);
+
+  Stream_Window data(in, data_size);
+  decode_stats_t stats = {0, 0, 0};
+
+  if (header[HDR_KEYFRAME_INTERVAL] == 0)
+    decode_fixed(header, data, stats);
+  else
+    decode_delta(header, data, stats);
+
+  if (stats.records + stats.bad + stats.skipped < records)
+    fprintf(stderr, "%s: %lu of %lu records, the file is cut short\n", path,
+            stats.records + stats.bad + stats.skipped, (unsigned long)records);
+  if (stats.bad)
+    fprintf(stderr, "%s: %lu records failed their CRC, %lu more skipped to the next keyframe\n",
+            path, stats.bad, stats.skipped);
+
+  return 0;
+}
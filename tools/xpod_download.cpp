@@ -0,0 +1,465 @@
+/*******************************************************************************
+ * @file    xpod_download.cpp
+ * @brief   Mirrors the SD card of an xpod over its serial console.
+ *
+ *          Lists the pod's files and fetches what the local copies in DIR
+ *          lack: a file that grew is resumed from the local size, one that
+ *          got shorter (a card swapped, torn records dropped) is fetched
+ *          again whole, an equal one is skipped. A binary log's header is
+ *          fetched on every run, its counts change as it grows. A block
+ *          that fails its CRC or does not follow on is asked for again from
+ *          the last good offset, so an interrupted run picks up where it
+ *          stopped. The pod keeps sampling while it sends.
+ *
+ *          The session starts at --baud (CONSOLE_BAUD of the pod) and moves
+ *          to --fast (DOWNLOAD_BAUD) for the transfer, --fast 0 stays put.
+ *
+ *          Protocol: see xpod_V3.1.2/download.h.
+ *
+ *          Build:  g++ -O2 -o xpod_download xpod_download.cpp
+ *          Use:    ./xpod_download /dev/ttyACM0 OPOD12/
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "../xpod_V3.1.2/crc16.h"
+
+#define FRAME_VERSION         1
+
+#define DOWNLOAD_SESSION      'A'
+#define DOWNLOAD_FILE         'F'
+#define DOWNLOAD_BLOCK        'B'
+#define DOWNLOAD_END          'E'
+
+#define DOWNLOAD_OK           0
+
+// As in bin_log.h
+#define BIN_LOG_HEADER_SIZE   1024
+
+// Longer than a cycle's sampling, when the pod sends nothing
+#define FRAME_TIMEOUT_MS      4000
+#define MAX_RETRIES           5
+
+struct remote_file_t
+{
+    std::string name;
+    uint32_t size;
+};
+
+struct mirror_stats_t
+{
+    unsigned long files;
+    unsigned long fetched;
+    unsigned long bytes;
+    unsigned long retries;
+    unsigned long bad_frames;
+};
+
+static mirror_stats_t stats;
+
+static uint32_t get_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Same decoder as xpod_telemetry's
+static bool cobs_decode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out)
+{
+  size_t i = 0;
+
+  out.clear();
+  while (i < in.size())
+  {
+    uint8_t code = in[i++];
+
+    if (code == 0 || i + code - 1 > in.size())
+      return false;
+
+    out.insert(out.end(), in.begin() + i, in.begin() + i + code - 1);
+    i += code - 1;
+
+    if (code != 0xFF && i < in.size())
+      out.push_back(0);
+  }
+
+  return true;
+}
+
+static bool set_baud(int fd, unsigned long baud)
+{
+  static const struct
+  {
+    unsigned long baud;
+    speed_t speed;
+  } speeds[] = {{9600, B9600},     {19200, B19200},   {38400, B38400},    {57600, B57600},
+                {115200, B115200}, {230400, B230400}, {500000, B500000},  {1000000, B1000000}};
+  struct termios tio;
+
+  if (tcgetattr(fd, &tio) != 0)
+    return false;
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+  {
+    if (speeds[i].baud == baud)
+    {
+      cfsetispeed(&tio, speeds[i].speed);
+      cfsetospeed(&tio, speeds[i].speed);
+      return tcsetattr(fd, TCSANOW, &tio) == 0;
+    }
+  }
+
+  fprintf(stderr, "xpod_download: %lu baud is not supported\n", baud);
+  return false;
+}
+
+static void send_command(int fd, const std::string &line)
+{
+  std::string text = line + "\n";
+
+  if (write(fd, text.data(), text.size()) != (ssize_t)text.size())
+    perror("xpod_download: write");
+}
+
+// The console, split at the frame delimiters
+class Frame_Reader
+{
+  public:
+    Frame_Reader(int fd) : fd(fd), used(0) {}
+
+    // The next frame that holds its CRC, false after timeout_ms without one
+    bool next(uint8_t &type, std::vector<uint8_t> &payload, int timeout_ms)
+    {
+      std::vector<uint8_t> frame;
+
+      for (;;)
+      {
+        while (used < pending.size())
+        {
+          uint8_t c = pending[used++];
+
+          if (c != 0)
+          {
+            raw.push_back(c);
+            continue;
+          }
+          if (raw.empty())
+            continue;
+
+          bool ok = cobs_decode(raw, frame) && frame.size() >= 4 && frame[0] == FRAME_VERSION &&
+                    crc16(frame.data(), frame.size() - 2) ==
+                        (frame[frame.size() - 2] | (frame[frame.size() - 1] << 8));
+          raw.clear();
+
+          // Sample text and boot messages end up here as well
+          if (!ok)
+          {
+            stats.bad_frames++;
+            continue;
+          }
+
+          type = frame[1];
+          payload.assign(frame.begin() + 2, frame.end() - 2);
+          return true;
+        }
+
+        struct pollfd p = {fd, POLLIN, 0};
+        uint8_t chunk[4096];
+
+        if (poll(&p, 1, timeout_ms) <= 0)
+          return false;
+
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0)
+          return false;
+        pending.assign(chunk, chunk + n);
+        used = 0;
+      }
+    }
+
+    // Drops what arrived so far
+    void discard()
+    {
+      pending.clear();
+      used = 0;
+      raw.clear();
+      tcflush(fd, TCIFLUSH);
+    }
+
+  private:
+    int fd;
+    std::vector<uint8_t> pending;
+    size_t used;
+    std::vector<uint8_t> raw;
+};
+
+static bool start_session(int fd, Frame_Reader &reader, unsigned long fast)
+{
+  uint8_t type;
+  std::vector<uint8_t> payload;
+
+  for (int attempt = 0; attempt < MAX_RETRIES; attempt++)
+  {
+    send_command(fd, "B");
+    while (reader.next(type, payload, FRAME_TIMEOUT_MS))
+    {
+      if (type != DOWNLOAD_SESSION || payload.size() < 4)
+        continue;
+
+      unsigned long baud = get_le32(payload.data());
+      if (fast && baud != fast)
+        fprintf(stderr, "xpod_download: the pod moves to %lu baud, not %lu\n", baud, fast);
+
+      // The pod switches once the frame is out
+      tcdrain(fd);
+      usleep(20000);
+      reader.discard();
+      return set_baud(fd, baud);
+    }
+  }
+
+  return false;
+}
+
+static bool list_files(int fd, Frame_Reader &reader, std::vector<remote_file_t> &files)
+{
+  uint8_t type;
+  std::vector<uint8_t> payload;
+
+  for (int attempt = 0; attempt < MAX_RETRIES; attempt++)
+  {
+    files.clear();
+    send_command(fd, "L");
+
+    while (reader.next(type, payload, FRAME_TIMEOUT_MS))
+    {
+      if (type == DOWNLOAD_FILE && payload.size() > 4)
+      {
+        remote_file_t file = {std::string(payload.begin() + 4, payload.end()),
+                              get_le32(payload.data())};
+        files.push_back(file);
+      }
+      else if (type == DOWNLOAD_END && payload.size() >= 5)
+      {
+        // A lost 'F' frame shows in the count
+        if (payload[0] == DOWNLOAD_OK && get_le32(payload.data() + 1) == files.size())
+          return true;
+        break;
+      }
+    }
+    stats.retries++;
+  }
+
+  return false;
+}
+
+// Writes [from, to) of the pod's file into `path`, from 0 starts it anew
+static bool fetch(int fd, Frame_Reader &reader, const remote_file_t &file, const std::string &path,
+                  uint32_t from, uint32_t to)
+{
+  FILE *out = fopen(path.c_str(), from == 0 && to == file.size ? "wb" : "r+b");
+  uint32_t offset = from;
+  int retries = 0;
+  uint8_t type;
+  std::vector<uint8_t> payload;
+
+  if (!out)
+  {
+    perror(path.c_str());
+    return false;
+  }
+
+  while (offset < to && retries <= MAX_RETRIES)
+  {
+    // What was on the way from an earlier request comes first, the new
+    // transfer starts at `offset`
+    bool synced = false;
+
+    send_command(fd, "R " + file.name + " " + std::to_string(offset) + " " +
+                         std::to_string(to - offset));
+
+    while (reader.next(type, payload, FRAME_TIMEOUT_MS))
+    {
+      if (type == DOWNLOAD_BLOCK && payload.size() > 4)
+      {
+        if (get_le32(payload.data()) == offset)
+          synced = true;
+        else if (!synced)
+          continue;
+        // A block after a lost one, ask again from the gap
+        else
+          break;
+
+        size_t n = payload.size() - 4;
+
+        // The file may have grown since the listing, the rest is next run's
+        if (n > to - offset)
+          n = to - offset;
+        if (fseek(out, offset, SEEK_SET) != 0 || fwrite(payload.data() + 4, 1, n, out) != n)
+        {
+          perror(path.c_str());
+          fclose(out);
+          return false;
+        }
+
+        offset += n;
+        stats.bytes += n;
+        retries = 0;
+        if (offset >= to)
+          break;
+      }
+      else if (type == DOWNLOAD_END && payload.size() >= 5 && (synced || payload[0] != DOWNLOAD_OK))
+      {
+        if (payload[0] != DOWNLOAD_OK)
+          fprintf(stderr, "%s: the pod failed with status %u\n", file.name.c_str(), payload[0]);
+        break;
+      }
+    }
+
+    if (offset < to)
+    {
+      retries++;
+      stats.retries++;
+      reader.discard();
+    }
+  }
+
+  // The rest of a transfer that was cut short goes nowhere
+  if (offset >= to)
+  {
+    while (reader.next(type, payload, FRAME_TIMEOUT_MS) && type != DOWNLOAD_END)
+    {
+    }
+  }
+
+  fclose(out);
+  return offset >= to;
+}
+
+// A local copy that starts with the magic of a binary log
+static bool binary_log(const std::string &path)
+{
+  FILE *in = fopen(path.c_str(), "rb");
+  char magic[4];
+  bool binary = in && fread(magic, 1, sizeof(magic), in) == sizeof(magic) &&
+                memcmp(magic, "XPBL", sizeof(magic)) == 0;
+
+  if (in)
+    fclose(in);
+  return binary;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: xpod_download [--baud N] [--fast N] PORT DIR\n");
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    {"baud", required_argument, NULL, 'b'},
+    {"fast", required_argument, NULL, 'f'},
+    {NULL, 0, NULL, 0}
+  };
+  unsigned long baud = 115200;
+  unsigned long fast = 1000000;
+  int opt;
+
+  while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+      case 'b': baud = strtoul(optarg, NULL, 0); break;
+      case 'f': fast = strtoul(optarg, NULL, 0); break;
+      default: usage();
+    }
+  }
+  if (argc - optind != 2)
+    usage();
+
+  const char *port = argv[optind];
+  std::string dir = argv[optind + 1];
+  int fd = open(port, O_RDWR | O_NOCTTY);
+
+  if (fd < 0 || !set_baud(fd, baud))
+  {
+    perror(port);
+    return 1;
+  }
+  mkdir(dir.c_str(), 0777);
+
+  Frame_Reader reader(fd);
+  std::vector<remote_file_t> files;
+  struct timespec begin, end;
+  int status = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &begin);
+
+  if (fast && !start_session(fd, reader, fast))
+  {
+    fprintf(stderr, "xpod_download: no answer from the pod on %s\n", port);
+    return 1;
+  }
+  if (!list_files(fd, reader, files))
+  {
+    fprintf(stderr, "xpod_download: could not list the pod's files\n");
+    send_command(fd, "Q");
+    return 1;
+  }
+
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    const remote_file_t &file = files[i];
+    std::string path = dir + "/" + file.name;
+    struct stat st;
+    uint32_t local = stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+
+    stats.files++;
+    // Shorter on the pod: not the file we have
+    uint32_t from = local <= file.size ? local : 0;
+    // The header of a binary log changes as records come, it is fetched
+    // again with what was added (or to see that nothing was)
+    bool header = from >= BIN_LOG_HEADER_SIZE && binary_log(path);
+
+    if (from == file.size && !header)
+      continue;
+
+    fprintf(stderr, "%s: %lu of %lu bytes\n", file.name.c_str(),
+            (unsigned long)(file.size - from + (header ? BIN_LOG_HEADER_SIZE : 0)),
+            (unsigned long)file.size);
+    if ((!header || fetch(fd, reader, file, path, 0, BIN_LOG_HEADER_SIZE)) &&
+        (from == file.size || fetch(fd, reader, file, path, from, file.size)))
+      stats.fetched++;
+    else
+    {
+      fprintf(stderr, "%s: incomplete, run again to resume\n", file.name.c_str());
+      status = 1;
+    }
+  }
+
+  send_command(fd, "Q");
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+  fprintf(stderr, "%lu files, %lu fetched, %lu bytes in %.1f s, %lu retries, %lu bad frames\n",
+          stats.files, stats.fetched, stats.bytes, seconds, stats.retries, stats.bad_frames);
+
+  close(fd);
+  return status;
+}
@@ -0,0 +1,218 @@
+/*******************************************************************************
+ * @file    xpod_extract.cpp
+ * @brief   Extracts a time range from a daily CSV log of an xpod.
+ *
+ *          Binary searches the .idx file next to the log (see
+ *          xpod_V3.1.2/log_index.h) for the range's start, seeks the log
+ *          there and writes the header and the records from `from` up to,
+ *          not including, `to` to stdout. Only the records of the range and
+ *          at most one index period before it are read. Without an index
+ *          the whole log is scanned.
+ *
+ *          Times are YYYY-MM-DDThh:mm[:ss], or hh:mm[:ss] on the log's day.
+ *
+ *          Build:  g++ -O2 -o xpod_extract xpod_extract.cpp
+ *          Use:    ./xpod_extract OPOD12_2026_10_18.txt 14:00 15:00 > 14h.csv
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+struct index_entry_t
+{
+    uint32_t time;
+    uint32_t offset;
+    uint32_t seq;
+};
+
+static uint32_t get_u32(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Seconds since 1970 of "YYYY-MM-DDThh:mm[:ss]", the pod's clock has no zone
+static bool parse_time(const char *text, const struct tm *day, uint32_t &time)
+{
+  struct tm tm;
+  int n = 0;
+
+  memset(&tm, 0, sizeof(tm));
+  if (sscanf(text, "%d-%d-%dT%d:%d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour,
+             &tm.tm_min, &n) == 5)
+  {
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+  }
+  else if (day && sscanf(text, "%d:%d%n", &tm.tm_hour, &tm.tm_min, &n) == 2)
+  {
+    tm.tm_year = day->tm_year;
+    tm.tm_mon = day->tm_mon;
+    tm.tm_mday = day->tm_mday;
+  }
+  else
+    return false;
+
+  if (text[n] == ':')
+    tm.tm_sec = atoi(text + n + 1);
+
+  time = timegm(&tm);
+  return true;
+}
+
+static std::vector<index_entry_t> read_index(const std::string &log_path)
+{
+  std::vector<index_entry_t> entries;
+  size_t dot = log_path.rfind('.');
+  std::string path = log_path.substr(0, dot) + ".idx";
+  FILE *in = fopen(path.c_str(), "rb");
+  unsigned char raw[12];
+
+  if (!in)
+    return entries;
+
+  while (fread(raw, 1, sizeof(raw), in) == sizeof(raw))
+  {
+    index_entry_t entry = {get_u32(raw), get_u32(raw + 4), get_u32(raw + 8)};
+    entries.push_back(entry);
+  }
+  fclose(in);
+  return entries;
+}
+
+// Splits the log at its line breaks
+class Record_Reader
+{
+  public:
+    Record_Reader(FILE *in) : in(in), bytes(0) {}
+
+    // The text up to the next line break, false at the end of the file
+    bool next(std::string &record)
+    {
+      int c;
+
+      record.clear();
+      while ((c = getc(in)) != EOF)
+      {
+        bytes++;
+        if (c == '\n' && !record.empty() && record[record.size() - 1] == '\r')
+        {
+          record.resize(record.size() - 1);
+          return true;
+        }
+        record.push_back(c);
+      }
+      return !record.empty();
+    }
+
+    FILE *in;
+    unsigned long bytes;
+};
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "usage: %s log.txt from [to]\n", argv[0]);
+    return 2;
+  }
+
+  FILE *in = fopen(argv[1], "rb");
+  if (!in)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  Record_Reader reader(in);
+  std::string header, record;
+  std::vector<index_entry_t> index = read_index(argv[1]);
+
+  // The first record's line break, where an index entry would point
+  reader.next(header);
+  long data_start = header.size();
+
+  // The log's day, from the first record
+  struct tm day;
+  bool have_day = false;
+  uint32_t first_time;
+
+  if (reader.next(record) && parse_time(record.c_str(), NULL, first_time))
+  {
+    time_t t = first_time;
+    gmtime_r(&t, &day);
+    have_day = true;
+  }
+
+  fseek(in, 0, SEEK_END);
+  long size = ftell(in);
+
+  // Entries a reset left past the end of the log point nowhere
+  while (!index.empty() && index.back().offset >= (uint32_t)size)
+    index.pop_back();
+
+  uint32_t from, to = UINT32_MAX;
+
+  if (!parse_time(argv[2], have_day ? &day : NULL, from) ||
+      (argc > 3 && !parse_time(argv[3], have_day ? &day : NULL, to)))
+  {
+    fprintf(stderr, "%s: times are YYYY-MM-DDThh:mm[:ss] or hh:mm[:ss]\n", argv[0]);
+    return 2;
+  }
+
+  // The last entry at or before `from`, the first record of the log when
+  // there is none
+  long start = data_start;
+  size_t low = 0, high = index.size();
+
+  while (low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+
+    if (index[middle].time <= from)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  if (low > 0)
+    start = index[low - 1].offset;
+  else if (index.empty())
+    fprintf(stderr, "%s: no index, scanning the whole log\n", argv[1]);
+
+  // An entry points at the line break in front of its record
+  fseek(in, start, SEEK_SET);
+  if (getc(in) != '\r' || getc(in) != '\n')
+  {
+    fprintf(stderr, "%s: index does not match the log, scanning the whole log\n", argv[1]);
+    start = data_start;
+    fseek(in, data_start + 2, SEEK_SET);
+  }
+  reader.bytes = 2;
+
+  unsigned long records = 0;
+
+  fputs(header.c_str(), stdout);
+  while (reader.next(record))
+  {
+    uint32_t time;
+
+    // Torn or foreign lines are left to xpod_logcheck
+    if (!parse_time(record.c_str(), NULL, time) || time < from)
+      continue;
+    if (time >= to)
+      break;
+
+    fprintf(stdout, "\r\n%s", record.c_str());
+    records++;
+  }
+
+  fprintf(stderr, "%lu records, read %lu of %ld bytes\n", records, reader.bytes, size);
+  fclose(in);
+  return 0;
+}
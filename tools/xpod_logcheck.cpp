@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * @file    xpod_logcheck.cpp
+ * @brief   Validates and de-duplicates the CSV logs of an xpod.
+ *
+ *          Reads daily log files in order and writes one CSV to stdout: the
+ *          header of the first file, then every record whose CRC holds and
+ *          whose sequence number was not seen before. stderr gets the count
+ *          of bad and duplicate records and each jump in the sequence, a
+ *          jump is a reset (or records lost with it).
+ *
+ *          Record layout: see xpod_V3.1.2/log_record.h.
+ *
+ *          Build:  g++ -O2 -o xpod_logcheck xpod_logcheck.cpp
+ *          Use:    ./xpod_logcheck OPOD12_2026_10_*.txt > OPOD12.csv
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_set>
+
+#include "../xpod_V3.1.2/crc16.h"
+
+struct check_stats_t
+{
+    unsigned long records;
+    unsigned long bad;
+    unsigned long duplicates;
+    unsigned long jumps;
+};
+
+// Same test as check_record() of the firmware
+static bool check_record(const std::string &text, uint32_t &seq)
+{
+  size_t length = text.size();
+
+  if (length < 7 || text[length - 5] != ',')
+    return false;
+
+  char *end;
+  unsigned long crc = strtoul(text.c_str() + length - 4, &end, 16);
+  if (end != text.c_str() + length || crc16(text.data(), length - 4) != crc)
+    return false;
+
+  size_t comma = text.rfind(',', length - 6);
+  if (comma == std::string::npos || comma + 1 >= length - 5)
+    return false;
+
+  seq = strtoul(text.c_str() + comma + 1, NULL, 10);
+  return true;
+}
+
+static bool check_file(const char *path, std::string &header, std::unordered_set<uint32_t> &seen,
+                       uint32_t &last, check_stats_t &stats)
+{
+  FILE *in = fopen(path, "rb");
+  std::string text;
+  char chunk[4096];
+  size_t n;
+
+  if (!in)
+  {
+    perror(path);
+    return false;
+  }
+
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+    text.append(chunk, n);
+  fclose(in);
+
+  size_t end = text.find("\r\n");
+  std::string first = text.substr(0, end);
+
+  if (first.size() < 8 || first.compare(first.size() - 8, 8, ",Seq,CRC") != 0)
+  {
+    fprintf(stderr, "%s: no Seq and CRC columns\n", path);
+    return false;
+  }
+
+  if (header.empty())
+  {
+    header = first;
+    fputs(header.c_str(), stdout);
+  }
+  else if (first != header)
+    fprintf(stderr, "%s: the columns differ from the first file's\n", path);
+
+  while (end != std::string::npos)
+  {
+    size_t start = end + 2;
+    uint32_t seq;
+
+    end = text.find("\r\n", start);
+    std::string record = text.substr(start, end == std::string::npos ? end : end - start);
+
+    if (!check_record(record, seq))
+    {
+      stats.bad++;
+      continue;
+    }
+
+    if (!seen.insert(seq).second)
+    {
+      stats.duplicates++;
+      continue;
+    }
+
+    if (stats.records > 0 && seq != last + 1)
+    {
+      fprintf(stderr, "%s: sequence jumps from %lu to %lu\n", path, (unsigned long)last,
+              (unsigned long)seq);
+      stats.jumps++;
+    }
+
+    last = seq;
+    stats.records++;
+    fprintf(stdout, "\r\n%s", record.c_str());
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  std::unordered_set<uint32_t> seen;
+  std::string header;
+  check_stats_t stats = {0, 0, 0, 0};
+  uint32_t last = 0;
+  int status = 0;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s log.txt...\n", argv[0]);
+    return 2;
+  }
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!check_file(argv[i], header, seen, last, stats))
+      status = 1;
+  }
+
+  fprintf(stderr, "%lu records, %lu bad, %lu duplicates, %lu sequence jumps\n", stats.records,
+          stats.bad, stats.duplicates, stats.jumps);
+
+  return status;
+}
@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * @file    xpod_telemetry.cpp
+ * @brief   Host decoder of the binary serial frames of an xpod.
+ *
+ *          Reads a raw capture of the console (a file, or stdin) and writes
+ *          the CSV lines the pod writes to its SD card: the header of the
+ *          last header frame, then one line per sample frame. Frames that
+ *          fail their CRC, and any text between frames, are skipped and
+ *          counted on stderr.
+ *
+ *          Frame layout: see xpod_V3.1.2/telemetry.h.
+ *
+ *          Build:  g++ -O2 -o xpod_telemetry xpod_telemetry.cpp
+ *          Use:    stty -F /dev/ttyACM0 115200 raw
+ *                  ./xpod_telemetry /dev/ttyACM0 > pod.csv
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "../xpod_V3.1.2/crc16.h"
+
+#define TELEMETRY_VERSION     1
+
+#define TELEMETRY_HEADER      'H'
+#define TELEMETRY_SAMPLE      'S'
+
+#define TELEMETRY_SKIP        0x00
+#define TELEMETRY_INT         0x10
+#define TELEMETRY_UINT        0x20
+#define TELEMETRY_FIXED       0x30
+#define TELEMETRY_TIME        0x40
+#define TELEMETRY_TEXT        0x50
+
+struct decode_stats_t
+{
+    unsigned long frames;
+    unsigned long samples;
+    unsigned long bad_frames;
+};
+
+// Returns false for a malformed encoding
+static bool cobs_decode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out)
+{
+  size_t i = 0;
+
+  out.clear();
+  while (i < in.size())
+  {
+    uint8_t code = in[i++];
+
+    if (code == 0 || i + code - 1 > in.size())
+      return false;
+
+    out.insert(out.end(), in.begin() + i, in.begin() + i + code - 1);
+    i += code - 1;
+
+    if (code != 0xFF && i < in.size())
+      out.push_back(0);
+  }
+
+  return true;
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_fixed(std::string &line, int32_t value, uint8_t decimals)
+{
+  char buf[32];
+  uint32_t mag = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+  uint32_t scale = 1;
+
+  // 10^9 is the largest power of ten in 32 bits
+  if (decimals > 9)
+    decimals = 9;
+
+  for (uint8_t i = 0; i < decimals; i++)
+    scale *= 10;
+
+  if (decimals)
+    snprintf(buf, sizeof(buf), "%s%lu.%0*lu", value < 0 ? "-" : "",
+             (unsigned long)(mag / scale), decimals, (unsigned long)(mag % scale));
+  else
+    snprintf(buf, sizeof(buf), "%ld", (long)value);
+
+  line += buf;
+}
+
+// Appends the CSV text of the columns, false if the payload is cut short
+static bool sample_line(const uint8_t *p, size_t size, std::string &line)
+{
+  const uint8_t *end = p + size;
+  char buf[32];
+  bool first = true;
+
+  line.clear();
+  while (p < end)
+  {
+    uint8_t tag = *p++;
+    uint8_t type = tag & 0xF0;
+
+    if (!first)
+      line += ',';
+    first = false;
+
+    if (type == TELEMETRY_SKIP)
+      continue;
+
+    if (type == TELEMETRY_TEXT)
+    {
+      if (p >= end || p + 1 + *p > end)
+        return false;
+      line.append((const char *)p + 1, *p);
+      p += 1 + *p;
+      continue;
+    }
+
+    if (p + 4 > end)
+      return false;
+
+    uint32_t value = get_le32(p);
+    p += 4;
+
+    switch (type)
+    {
+      case TELEMETRY_INT:
+        snprintf(buf, sizeof(buf), "%ld", (long)(int32_t)value);
+        line += buf;
+        break;
+
+      case TELEMETRY_UINT:
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)value);
+        line += buf;
+        break;
+
+      case TELEMETRY_FIXED:
+        put_fixed(line, (int32_t)value, tag & 0x0F);
+        break;
+
+      case TELEMETRY_TIME:
+      {
+        time_t t = value;
+        struct tm tm;
+
+        gmtime_r(&t, &tm);
+        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+        line += buf;
+        break;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static void decode_frame(const std::vector<uint8_t> &raw, std::string &header, bool &header_written,
+                         decode_stats_t &stats, FILE *out)
+{
+  std::vector<uint8_t> frame;
+  std::string line;
+
+  // version, type and the crc
+  if (!cobs_decode(raw, frame) || frame.size() < 4)
+  {
+    stats.bad_frames++;
+    return;
+  }
+
+  size_t size = frame.size() - 2;
+  uint16_t crc = frame[size] | (frame[size + 1] << 8);
+
+  if (crc16(frame.data(), size) != crc || frame[0] != TELEMETRY_VERSION)
+  {
+    stats.bad_frames++;
+    return;
+  }
+
+  stats.frames++;
+
+  if (frame[1] == TELEMETRY_HEADER)
+  {
+    std::string text((const char *)frame.data() + 2, size - 2);
+
+    if (text != header)
+    {
+      header = text;
+      header_written = false;
+    }
+  }
+  else if (frame[1] == TELEMETRY_SAMPLE)
+  {
+    if (!sample_line(frame.data() + 2, size - 2, line))
+    {
+      stats.bad_frames++;
+      return;
+    }
+
+    if (!header_written && !header.empty())
+    {
+      fprintf(out, "%s\r\n", header.c_str());
+      header_written = true;
+    }
+
+    fprintf(out, "%s\r\n", line.c_str());
+    fflush(out);
+    stats.samples++;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  FILE *in = stdin;
+  std::vector<uint8_t> raw;
+  std::string header;
+  bool header_written = false;
+  decode_stats_t stats = {0, 0, 0};
+  int c;
+
+  if (argc > 2)
+  {
+    fprintf(stderr, "usage: %s [capture]\n", argv[0]);
+    return 2;
+  }
+
+  if (argc == 2 && !(in = fopen(argv[1], "rb")))
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  while ((c = fgetc(in)) != EOF)
+  {
+    if (c != 0)
+    {
+      raw.push_back(c);
+      continue;
+    }
+
+    if (!raw.empty())
+      decode_frame(raw, header, header_written, stats, stdout);
+    raw.clear();
+  }
+
+  fprintf(stderr, "%lu frames, %lu samples, %lu bad frames skipped\n",
+          stats.frames, stats.samples, stats.bad_frames);
+
+  return 0;
+}
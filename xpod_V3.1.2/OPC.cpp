@@ -8,6 +8,15 @@ Put together by Aidan Mobley
  */
 #include <stdio.h>
 #include "OPC.h"
+#include "fixed_point.h"
+
+const char OPC::name[] PROGMEM = "OPC";
+const char OPC::header[] PROGMEM =
+#if PRINT_BINS
+  "Bin 0,Bin 1,Bin 2,Bin 3,Bin 4,Bin 5,Bin 6,Bin 7,"
+  "Bin 8,Bin 9,Bin 10,Bin 11,Bin 12,Bin 13,Bin 14,Bin 15,"
+#endif
+  "OPC_sp,OPC_sfr,OPC_PM1,OPC_PM25,OPC_PM10";
 
 // Combine two bytes into a 16-bit unsigned int
 uint16_t OPC::twoBytes2int(byte LSB, byte MSB){
@@ -23,90 +32,152 @@ float OPC::fourBytes2float(byte val0, byte val1, byte val2, byte val3) {
   return result;
 }
 
-// Gets OPC ready to do something
-bool OPC::getReady(const byte command){
-  byte inData;
+// One attempt at getting the OPC ready, returns the last byte it answered.
+// On OPC_ready the SPI transaction stays open with CS low for the command.
+byte OPC::tryReady(const byte command){
+  byte inData = 0;
   SPI.beginTransaction(SPISettings(300000, MSBFIRST, SPI_MODE1));
-  int tries = 0;
-  int total_tries = 0;
-  while(inData != OPC_ready & total_tries++ < 20){
-    for(int i = 0; i < 10; i++){
-      inData = SPI.transfer(0x01);    // Try reading some bytes here to clear out anything remnant of other SPI activity
-      delayMicroseconds(10);
-    }
-    delay(10);
-    digitalWrite(CSpin, LOW);
-    while(inData != OPC_ready & tries++ < 20)
-    {
-      inData = SPI.transfer(command);
-      delay(5);
-    }
-    if(inData != OPC_ready){
-      if(inData == OPC_busy){         // waiting 2 seconds because opc is busy
-        digitalWrite(CSpin, HIGH);
-        delay(2000);
-      }
-      else{                           // resetting spi because different byte is returned
-        digitalWrite(CSpin, HIGH);
-        SPI.endTransaction();
-        delay(6000);
-        SPI.beginTransaction(SPISettings(300000, MSBFIRST, SPI_MODE1));
-      }
-    }
+  for(int i = 0; i < 10; i++){
+    inData = SPI.transfer(0x01);    // Try reading some bytes here to clear out anything remnant of other SPI activity
+    delayMicroseconds(10);
   }
   delay(10);
-  if(inData == OPC_ready)
-    return true;
-  else
-    return false;
+  digitalWrite(CSpin, LOW);
+  for(int tries = 0; tries < 20 && inData != OPC_ready; tries++){
+    inData = SPI.transfer(command);
+    delay(5);
+  }
+  if(inData != OPC_ready){
+    digitalWrite(CSpin, HIGH);
+    SPI.endTransaction();
+  }
+  return inData;
 }
 
+// Steps of warm()
+enum { OPC_POWERING, OPC_SPINNING_UP, OPC_WARM };
+
 OPC::OPC(){
   CSpin = 49;
+  requested = false;
+  warmState = OPC_POWERING;
+  warmTries = 0;
+  retryTime = 0;
+  retryDelay = 0;
+  memset(&data, 0, sizeof(data));
 }
 
+// The rest of the power-up is left to warm()
 bool OPC::begin(){
   SPI.begin();
   pinMode(CSpin, OUTPUT);
   digitalWrite(CSpin, HIGH);
-  delay(1000);
-  return on();
+  warmState = OPC_POWERING;
+  warmTries = 0;
+  retryTime = millis();
+  retryDelay = POWER_UP_DELAY;
+  return true;
 }
 
-bool OPC::on(){
-  bool on = getReady(0x03);
-  SPI.transfer(0x03);
-  digitalWrite(CSpin, HIGH);
-  SPI.endTransaction();
-  delay(2000);
-  return on;
+// Command 0x03 switches the fan and laser on, one tryReady() at most per
+// call; the busy, reset and fan waits pass between calls
+int8_t OPC::warm(){
+  if(warmState == OPC_WARM){
+    return 1;
+  }
+  if(millis() - retryTime < retryDelay){
+    return 0;
+  }
+
+  retryTime = millis();
+  if(warmState == OPC_SPINNING_UP){
+    warmState = OPC_WARM;
+    retryDelay = 0;
+    return 1;
+  }
+
+  byte inData = tryReady(0x03);
+  if(inData == OPC_ready){
+    delay(10);
+    SPI.transfer(0x03);
+    digitalWrite(CSpin, HIGH);
+    SPI.endTransaction();
+    warmState = OPC_SPINNING_UP;
+    retryDelay = FAN_DELAY;
+    return 0;
+  }
+  if(++warmTries >= ON_TRIES){
+    return -1;
+  }
+  retryDelay = (inData == OPC_busy) ? BUSY_DELAY : RESET_DELAY;
+  return 0;
 }
 
-bool OPC::off(){
-  bool off = getReady(0x03);
-  SPI.transfer(0x00);
-  digitalWrite(CSpin, HIGH);
-  SPI.endTransaction();
-  return off;
+// Requests the histogram, it is read out by collect() once HIST_DELAY passed.
+// A busy OPC is asked again from poll() instead of waiting here.
+void OPC::start(){
+  requested = false;
+}
+
+bool OPC::poll(){
+  if(requested){
+    return (millis() - requestTime) >= HIST_DELAY;
+  }
+  if(millis() - retryTime < retryDelay){
+    return false;
+  }
+
+  byte inData = tryReady(0x30);
+  if(inData == OPC_ready){
+    delay(10);
+    requested = true;
+    requestTime = millis();
+    retryDelay = 0;
+  }
+  else{
+    retryTime = millis();
+    retryDelay = (inData == OPC_busy) ? BUSY_DELAY : RESET_DELAY;
+  }
+  return false;
 }
 
-particleData OPC::getData(){
-  particleData data;
+// Out of time, drops a pending request so the histogram is not read
+void OPC::abort(){
+  if(requested){
+    digitalWrite(CSpin, HIGH);
+    SPI.endTransaction();
+    requested = false;
+  }
+}
+
+// False when the OPC never got ready to send its histogram
+bool OPC::collect(particleData &sample){
+  bool valid = requested;
+
+  readHistogram();
+  sample = data;
+  return valid;
+}
+
+void OPC::readHistogram(){
   double conv;
   byte vals[64];
-  byte command[] = {0x30, 0x01};       // command bytes to request histogram
-  
-  // SPI transaction
-  getReady(command[0]);
-  delay(100);
+  byte command = 0x01;       // command byte to read out the histogram
+
+  // tryReady() already released the bus when the OPC did not answer
+  if(!requested){
+    return;
+  }
+  requested = false;
   
   // read all bits available
   for (int i=0; i<64; ++i){
-    vals[i] = SPI.transfer(command[1]);
+    vals[i] = SPI.transfer(command);
     delayMicroseconds(10);
   }
   
   digitalWrite(CSpin, HIGH);
+  SPI.endTransaction();
   
   // sample period [s]
   float sp = fourBytes2float(vals[44], vals[45], vals[46], vals[47]);
@@ -148,39 +219,27 @@ particleData OPC::getData(){
   data.PM10 = PM10;
   data.PM25 = PM25;
   data.PM100 = PM100;
-  
-  return data;
 }
 
-String OPC::read4sd(particleData data){
-  String out_str = "";
-  #if PRINT_BINS
-    for(int i = 0; i < 16; i++){
-      out_str += String(data.bin[i]) + ",";
-    }
-  #else
-    //out_str = ",,,,,,,,,,,,,,,,";
-  #endif
-  out_str += String(data.sp) + ",";
-  out_str += String(data.sfr) + ",";
-  out_str += String(data.PM10) + ",";
-  out_str += String(data.PM25) + ",";
-  out_str += String(data.PM100) + ",";
-  
-  return out_str;
-}
-String OPC::read4print(particleData data){
-  String out_str = "";
+void OPC::read4print(const particleData &data, Print &out){
   #if PRINT_BINS
     for(int i = 0; i < 16; i++){
-      out_str += "Bin " + String(i) + ": " + String(data.bin[i]) + ",";
+      out.print(F("Bin "));
+      out.print(i);
+      out.print(F(": "));
+      print_int(out, data.bin[i]);
+      out.print(',');
     }
   #endif
-  out_str += "Sample Period: " + String(data.sp) + ",";
-  out_str += "Sample Flow Rate: " + String(data.sfr) + ",";
-  out_str += "PM1.0: " + String(data.PM10) + ",";
-  out_str += "PM2.5: " + String(data.PM25) + ",";
-  out_str += "PM10.0: " + String(data.PM100) + ",";
-
-  return out_str;
+  out.print(F("Sample Period: "));
+  print_float(out, data.sp, 2);
+  out.print(F(",Sample Flow Rate: "));
+  print_float(out, data.sfr, 2);
+  out.print(F(",PM1.0: "));
+  print_float(out, data.PM10, 2);
+  out.print(F(",PM2.5: "));
+  print_float(out, data.PM25, 2);
+  out.print(F(",PM10.0: "));
+  print_float(out, data.PM100, 2);
+  out.print(',');
 }
@@ -17,6 +17,13 @@ OPC.h - library for operating optical particle counter OPC-R2 from Alphasense us
 #define PRINT_BINS  1 // Prints the amount of particles in each of the 16 bins
 #define PM_COUNT    0 // Returns the PM measurements in particle count rather than ug/m3
 #define CONVERT     0 // Returns the bin measurements in particles/ml rather than particle count
+#define HIST_DELAY  100 // ms between the histogram request and reading it out
+#define BUSY_DELAY  2000 // ms before asking again when the OPC is busy
+#define RESET_DELAY 6000 // ms before asking again after an unexpected answer
+#define OPC_BUDGET_MS 1000 // time the histogram request may take per cycle
+#define POWER_UP_DELAY 1000 // ms from begin() to the first command
+#define FAN_DELAY   2000 // ms for the fan and laser to come up after switching on
+#define ON_TRIES    20 // attempts at switching on before the OPC counts as failed
 
 
 const byte OPC_ready = 0xF3;
@@ -35,20 +42,53 @@ struct particleData{
 // define class
 class OPC{
   public:
+    typedef particleData sample_type;
+
+    static const uint8_t column_count = 16 * PRINT_BINS + 5;
+    static const uint16_t budget_ms = OPC_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     OPC();
     bool begin();
-    bool on();
-    bool off();
-    particleData getData();
-    String read4sd(particleData data);
-    String read4print(particleData data);
+    // Powers up without blocking: waits, switches on, waits for the fan
+    int8_t warm();
+    void start();
+    bool poll();
+    bool collect(particleData &sample);
+    void abort();
+    void read4print(const particleData &data, Print &out);
+
+    template <class Sink>
+    static void columns(const particleData &data, Sink &sink);
   
   private:
     uint16_t twoBytes2int(byte LSB, byte MSB);
     float fourBytes2float(byte val0, byte val1, byte val2, byte val3);
-    bool getReady(const byte command);
+    byte tryReady(const byte command);
+    void readHistogram();
     int CSpin;
+    bool requested;
+    unsigned long requestTime;
+    unsigned long retryTime;
+    unsigned long retryDelay;
+    byte warmState;
+    byte warmTries;
+    particleData data;
 };
 
+template <class Sink>
+void OPC::columns(const particleData &data, Sink &sink){
+  #if PRINT_BINS
+    for(int i = 0; i < 16; i++){
+      sink.put_int(data.bin[i]);
+    }
+  #endif
+  sink.put_float(data.sp, 2);
+  sink.put_float(data.sfr, 2);
+  sink.put_float(data.PM10, 2);
+  sink.put_float(data.PM25, 2);
+  sink.put_float(data.PM100, 2);
+}
 
 #endif /* OPC_h */
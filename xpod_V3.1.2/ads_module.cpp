@@ -6,6 +6,50 @@
  * @date    Feb 18 2023
  ******************************************************************************/
 #include "ads_module.h"
+#include "digipot.h"
+#include "fixed_point.h"
+#include "xpod_config.h"
+
+const uint16_t ads_rates[ADS_RATE_COUNT] PROGMEM = {8, 16, 32, 64, 128, 250, 475, 860};
+
+// RATE_ADS1115_* of a rate in samples per second
+static uint16_t ads_rate_bits(uint16_t sps)
+{
+  uint8_t i = 0;
+
+  while (i < ADS_RATE_COUNT - 1 && pgm_read_word(&ads_rates[i]) < sps)
+    i++;
+  return i << 5;
+}
+
+// Bit per chip, the addresses run from 0x48 to 0x4B
+static uint8_t ads_chips_busy = 0;
+
+bool ads_chip_claim(uint8_t addr)
+{
+  uint8_t bit = 1 << (addr & 0x03);
+
+  if (ads_chips_busy & bit)
+    return false;
+  ads_chips_busy |= bit;
+  return true;
+}
+
+void ads_chip_release(uint8_t addr)
+{
+  ads_chips_busy &= ~(1 << (addr & 0x03));
+}
+
+const char ADS_Module::name[] PROGMEM = "ADS1115";
+const char ADS_Module::header[] PROGMEM =
+  "FIG 2600 (raw),FIG 2602 (raw),"
+#if FIGARO3_ENABLED
+  "FIG 3 (raw),FIG 3 heater (raw),"
+#endif
+#if FIGARO4_ENABLED
+  "FIG 4 (raw),FIG 4 heater (raw),"
+#endif
+  "PID,E2V,CO aux,CO main";
 
 ADS_Module::ADS_Module()
 {
@@ -41,232 +85,263 @@ ADS_Module::ADS_Module()
   ads_module[ADS_SENSOR_CO].channel = -1;
 
   for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
     ads_module[i].status = false;
+    ads_module[i].state = ADS_CONV_DONE;
+  }
+  conv_us = 0;
 }
 
+// True while any chip answers, the channels of a missing one read -999.
+// Called again on an offline module, it only tries the chips that are down.
 bool ADS_Module::begin()
 {
-  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
-  {
-    if (ads_module[i].module.begin(ads_module[i].addr))
-      ads_module[i].status = true;
-  }
+  bool any = false;
 
   for (int i = 0; i < ADS_SENSOR_COUNT; i++)
   {
-    if (ads_module[i].status == false)
-      return false;
+    if (!ads_module[i].status && ads_module[i].module.begin(ads_module[i].addr))
+    {
+      ads_module[i].module.setDataRate(ads_rate_bits(xpod_config.ads_rate_sps));
+      ads_module[i].status = true;
+    }
+    any |= ads_module[i].status;
   }
 
-  return true;
+  return any;
 }
 
-float ADS_Module::read_figaro(ads_sensor_id_e ads_sensor_id)
+uint16_t ADS_Module::conv_mux(ads_sensor_id_e ads_sensor_id)
 {
   ads_module_t *sensor = &ads_module[ads_sensor_id];
 
-  const int samples = 20;
-  float volts = 0.0;
-  float contaminants = 0.0;
-  float v_sum = 0.0;
-  float c_sum = 0.0;
-  int16_t adc = 0;
+  // CO is read as two differential pairs, aux first and main second
+  if (ads_sensor_id == ADS_SENSOR_CO)
+    return sensor->taken == 0 ? ADS1X15_REG_CONFIG_MUX_DIFF_0_1 : ADS1X15_REG_CONFIG_MUX_DIFF_2_3;
 
-  if (!sensor->status)
-    return -999;
-
-  for (int i = 0; i < samples; i++)
-  {
-    adc = sensor->module.readADC_SingleEnded(sensor->channel);
-    volts = sensor->module.computeVolts(adc);
-
-    // rs/ro, change 0.1 to voltage in clean air, (5/voltage_dirty) / (5/Voltage_clean)
-    contaminants = ((5.000 / volts) - 1) / ((5.000 / 0.1) - 1);
-
-    c_sum += contaminants;
-    v_sum += volts;
-  }
-
-  contaminants = c_sum / samples;
-  volts = v_sum / samples;
-
-  if (contaminants > 1.000)
-    contaminants = 1.000;
-
-  // return adc value, rs/ro, heater resistance.
-  // Use other code to calc rs/ro, calc heater resistance,
-  return volts;
-}
-
-float ADS_Module::read_heater(ads_sensor_id_e ads_sensor_id){
-  ads_module_t *sensor = &ads_module[ads_sensor_id];
-
-  const int samples = 20;
-  float volts = 0.0;
-  float raw = 0.0;
-  float r_sum = 0.0;
-  int adc = 1;
-  
-  for(int i = 0; i < samples; i++){
-    raw = sensor->module.readADC_SingleEnded(adc);
-    r_sum += raw;
-  }
-  raw = r_sum / samples;
-
-  volts = (raw - 0) * (0 - 5) / (0 - 27000);
-  
-  return volts;
+  return MUX_BY_CHANNEL[sensor->channel];
 }
 
-float ADS_Module::read_co()
+// The digital pots trim what the ADS1115s read, their levels go out
+// between the first cycles
+int8_t ADS_Module::warm()
 {
-  ads_module_t *sensor = &ads_module[ADS_SENSOR_CO];
-
-  float val;
-  const float multiplier = 0.1875F;  // ADS1115  @ +/- 6.144V gain (16-bit results)
-
-  if (!sensor->status)
-    return -999;
-
-  return (sensor->module.readADC_Differential_0_1() - sensor->module.readADC_Differential_2_3());
+  return PotsDone() ? 1 : 0;
 }
 
-float ADS_Module::read_co_aux()
+void ADS_Module::start()
 {
-  ads_module_t *sensor = &ads_module[ADS_SENSOR_CO];
-
-  float val;
-  const float multiplier = 0.1875F;  // ADS1115  @ +/- 6.144V gain (16-bit results)
+  conv_us = 1000000UL / xpod_config.ads_rate_sps + ADS_WAKEUP_US;
 
-  if (!sensor->status)
-    return -999;
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
+    ads_module_t *sensor = &ads_module[i];
+
+    sensor->taken = 0;
+    sensor->v_sum = 0.0;
+    sensor->raw_sum = 0;
+    sensor->state = sensor->status ? ADS_CONV_PENDING : ADS_CONV_DONE;
+
+    switch (i)
+    {
+      case ADS_SENSOR_FIG2600:
+      case ADS_SENSOR_FIG2602:
+      case ADS_SENSOR_FIG3:
+      case ADS_SENSOR_FIG4:
+        sensor->samples = xpod_config.ads_figaro_samples;
+        break;
+      case ADS_HEATER_FIG3:
+      case ADS_HEATER_FIG4:
+        sensor->samples = xpod_config.ads_heater_samples;
+        break;
+      case ADS_SENSOR_CO:
+        sensor->samples = 2;
+        break;
+      default:
+        sensor->samples = 1;
+        break;
+    }
+  }
 
-  return (sensor->module.readADC_Differential_0_1());
+  poll();
 }
 
-float ADS_Module::read_co_main()
+void ADS_Module::convert(ads_sensor_id_e ads_sensor_id)
 {
-  ads_module_t *sensor = &ads_module[ADS_SENSOR_CO];
-
-  float val;
-  const float multiplier = 0.1875F;  // ADS1115  @ +/- 6.144V gain (16-bit results)
-
-  if (!sensor->status)
-    return -999;
+  ads_module_t *sensor = &ads_module[ads_sensor_id];
 
-  return (sensor->module.readADC_Differential_2_3());
+  // Counted from the config write, the threshold writes after it take
+  // part of the conversion time
+  sensor->conv_start = micros();
+  sensor->module.startADCReading(conv_mux(ads_sensor_id), false);
 }
 
-uint16_t ADS_Module::read_raw(ads_sensor_id_e ads_sensor_id)
+bool ADS_Module::poll()
 {
-  ads_module_t *sensor = &ads_module[ads_sensor_id];
+  bool done = true;
 
-  if (!sensor->status)
-    return -999;
+  // Channels that share an ADS1115 are converted one after another, while
+  // the four chips convert in parallel
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
+    ads_module_t *sensor = &ads_module[i];
+
+    if (sensor->state == ADS_CONV_BUSY)
+    {
+      // The chip is not asked before its conversion can be done, the bus
+      // stays free for the other modules
+      if (micros() - sensor->conv_start < conv_us ||
+          !sensor->module.conversionComplete())
+      {
+        done = false;
+        continue;
+      }
+
+      int16_t adc = sensor->module.getLastConversionResults();
+
+      if (sensor->taken == 0)
+        sensor->first = adc;
+      sensor->last = adc;
+      sensor->v_sum += sensor->module.computeVolts(adc);
+      sensor->raw_sum += adc;
+      sensor->taken++;
+
+      if (sensor->taken >= sensor->samples)
+      {
+        sensor->state = ADS_CONV_DONE;
+        ads_chip_release(sensor->addr);
+        continue;
+      }
+
+      convert((ads_sensor_id_e)i);
+      done = false;
+    }
+    else if (sensor->state == ADS_CONV_PENDING)
+    {
+      if (ads_chip_claim(sensor->addr))
+      {
+        convert((ads_sensor_id_e)i);
+        sensor->state = ADS_CONV_BUSY;
+      }
+      done = false;
+    }
+  }
 
-  return sensor->module.readADC_SingleEnded(sensor->channel);
+  return done;
 }
 
-String ADS_Module::read4sd()
+// The data rate is good to -10 %. 0x48 converts FIG 2600, FIG 3 with its
+// heater and the PID, 0x49 FIG 2602 and FIG 4 with its heater; CO and E2V
+// are done well before either.
+uint32_t ADS_Module::conversion_ms()
 {
-  String out_str = "";
-
-  out_str += String(read_figaro(ADS_SENSOR_FIG2600)) + ",";
-  out_str += String(read_figaro(ADS_SENSOR_FIG2602)) + ",";
-#if FIGARO3_ENABLED
-  out_str += String(read_figaro(ADS_SENSOR_FIG3)) + ",";
-#endif
-#if FIGARO4_ENABLED
-  out_str += String(read_figaro(ADS_SENSOR_FIG4)) + ",";
-#endif
-  out_str += String(read_raw(ADS_SENSOR_PID)) + ",";
-  out_str += String(read_raw(ADS_SENSOR_E2V)) + ",";
-  out_str += String(read_co_aux()) + "," + String(read_co_main());
+  uint16_t chip48 = (1 + FIGARO3_ENABLED) * xpod_config.ads_figaro_samples
+                    + FIGARO3_ENABLED * xpod_config.ads_heater_samples + 1;
+  uint16_t chip49 = (1 + FIGARO4_ENABLED) * xpod_config.ads_figaro_samples
+                    + FIGARO4_ENABLED * xpod_config.ads_heater_samples;
+  uint32_t conversions = max(chip48, chip49);
 
-  return out_str;
+  return (conversions * 1100UL + xpod_config.ads_rate_sps - 1) / xpod_config.ads_rate_sps;
 }
 
-String ADS_Module::read4print()
+// Conversions still running are left to finish, start() resets the state
+void ADS_Module::abort()
 {
-  String out_str = "";
-
-  out_str += "FIG2600:" + String(read_figaro(ADS_SENSOR_FIG2600)) + ",";
-  out_str += "FIG2602:" + String(read_figaro(ADS_SENSOR_FIG2602)) + ",";
-#if FIGARO3_ENABLED
-  out_str += "FIG3:" + String(read_figaro(ADS_SENSOR_FIG3)) + ",";
-#endif
-#if FIGARO4_ENABLED
-  out_str += "FIG4:" + String(read_figaro(ADS_SENSOR_FIG4)) + ",";
-#endif
-  out_str += "PID:" + String(read_raw(ADS_SENSOR_PID)) + ",";
-  out_str += "E2V:" + String(read_raw(ADS_SENSOR_E2V)) + ",";
-  out_str += "CO:" + String(read_co());
-
-  return out_str;
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
+    if (ads_module[i].state == ADS_CONV_BUSY)
+      ads_chip_release(ads_module[i].addr);
+    ads_module[i].state = ADS_CONV_DONE;
+  }
 }
 
-String ADS_Module::read4sd_raw()
+bool ADS_Module::collect(ads_sample_t &sample)
 {
-  String out_str = "";
+  bool valid = false;
 
-  // out_str += String(read_figaro(ADS_SENSOR_FIG2600)) +"\t";
-  out_str += String(read_raw(ADS_SENSOR_FIG2600)) + ",";
+  for (int i = 0; i < ADS_SENSOR_COUNT; i++)
+  {
+    ads_module_t *sensor = &ads_module[i];
 
-  // out_str += String(read_figaro(ADS_SENSOR_FIG2602)) + "\t";
-  out_str += String(read_raw(ADS_SENSOR_FIG2602)) + ",";
+    if (!sensor->status || sensor->taken == 0)
+    {
+      sample.volts[i] = -999;
+      sample.raw[i] = -999;
+      continue;
+    }
 
-  #if FIGARO3_ENABLED
-    // out_str += String(read_figaro(ADS_SENSOR_FIG3)) + "\t";
-    out_str += String(read_raw(ADS_SENSOR_FIG3)) + ",";
-  
-    out_str += String(read_raw(ADS_HEATER_FIG3)) + ",";
-  #endif
+    valid = true;
 
-  #if FIGARO4_ENABLED
-    // out_str += String(read_figaro(ADS_SENSOR_FIG4)) + "\t";
-    out_str += String(read_raw(ADS_SENSOR_FIG4)) + ",";
-  
-    out_str += String(read_raw(ADS_HEATER_FIG4)) + ",";
-  #endif
+    if (i == ADS_HEATER_FIG3 || i == ADS_HEATER_FIG4)
+      sample.volts[i] = ((float)sensor->raw_sum / sensor->taken) * (0 - 5) / (0 - 27000);
+    else
+      sample.volts[i] = sensor->v_sum / sensor->taken;
 
-  out_str += String(read_raw(ADS_SENSOR_PID)) + ",";
-  out_str += String(read_raw(ADS_SENSOR_E2V)) + ",";
+    sample.raw[i] = sensor->first;
+  }
 
-  out_str += String(read_co_aux()) + "," + String(read_co_main());
+  if (ads_module[ADS_SENSOR_CO].status && ads_module[ADS_SENSOR_CO].taken == 2)
+  {
+    sample.co_aux = ads_module[ADS_SENSOR_CO].first;
+    sample.co_main = ads_module[ADS_SENSOR_CO].last;
+  }
+  else
+  {
+    sample.co_aux = -999;
+    sample.co_main = -999;
+  }
 
-  return out_str;
+  return valid;
 }
 
-String ADS_Module::read4print_raw()
+void ADS_Module::read4print(const ads_sample_t &sample, Print &out)
 {
-  String out_str = "";
-  
-   out_str += "FIG2600:" + String(read_figaro(ADS_SENSOR_FIG2600));
-   out_str += "(" + String(read_raw(ADS_SENSOR_FIG2600)) + "),";
-
-   out_str += "FIG2602:" + String(read_figaro(ADS_SENSOR_FIG2602));
-   out_str += "(" + String(read_raw(ADS_SENSOR_FIG2602)) + "),";
+  out.print(F("FIG2600:"));
+  print_float(out, sample.volts[ADS_SENSOR_FIG2600], 2);
+  out.print('(');
+  print_uint(out, sample.raw[ADS_SENSOR_FIG2600]);
+  out.print(F("),"));
+
+  out.print(F("FIG2602:"));
+  print_float(out, sample.volts[ADS_SENSOR_FIG2602], 2);
+  out.print('(');
+  print_uint(out, sample.raw[ADS_SENSOR_FIG2602]);
+  out.print(F("),"));
 
   #if FIGARO3_ENABLED
-    out_str += "FIG3:" + String(read_figaro(ADS_SENSOR_FIG3)) + ",";
-    out_str += "(" + String(read_raw(ADS_SENSOR_FIG3)) + "),";
-  
-    out_str += "FIG3_volts:" + String(read_heater(ADS_HEATER_FIG3)) + ",";
-    out_str += "(" + String(read_raw(ADS_HEATER_FIG3)) + "),";
+    out.print(F("FIG3:"));
+    print_float(out, sample.volts[ADS_SENSOR_FIG3], 2);
+    out.print(F(",("));
+    print_uint(out, sample.raw[ADS_SENSOR_FIG3]);
+    out.print(F("),"));
+
+    out.print(F("FIG3_volts:"));
+    print_float(out, sample.volts[ADS_HEATER_FIG3], 2);
+    out.print(F(",("));
+    print_uint(out, sample.raw[ADS_HEATER_FIG3]);
+    out.print(F("),"));
   #endif
-  
+
   #if FIGARO4_ENABLED
-    out_str += "FIG4:" + String(read_figaro(ADS_SENSOR_FIG4)) + ",";
-    out_str += "(" + String(read_raw(ADS_SENSOR_FIG4)) + "),";
-  
-    out_str += "FIG4_volts:" + String(read_heater(ADS_HEATER_FIG4)) + ",";
-    out_str += "(" + String(read_raw(ADS_HEATER_FIG4)) + "),";
+    out.print(F("FIG4:"));
+    print_float(out, sample.volts[ADS_SENSOR_FIG4], 2);
+    out.print(F(",("));
+    print_uint(out, sample.raw[ADS_SENSOR_FIG4]);
+    out.print(F("),"));
+
+    out.print(F("FIG4_volts:"));
+    print_float(out, sample.volts[ADS_HEATER_FIG4], 2);
+    out.print(F(",("));
+    print_uint(out, sample.raw[ADS_HEATER_FIG4]);
+    out.print(F("),"));
   #endif
 
-//   out_str += "PID:" + String(read_raw(ADS_SENSOR_PID)) + ",";
-  out_str += "E2V:" + String(read_raw(ADS_SENSOR_E2V)) + ",";
-
-  out_str += "CO:" + String(read_co_aux()) + "," + String(read_co_main());;
+  out.print(F("E2V:"));
+  print_uint(out, sample.raw[ADS_SENSOR_E2V]);
+  out.print(',');
 
-  return out_str;
+  out.print(F("CO:"));
+  print_float(out, sample.co_aux, 2);
+  out.print(',');
+  print_float(out, sample.co_main, 2);
 }
@@ -14,6 +14,15 @@
 #define FIGARO3_ENABLED       1
 #define FIGARO4_ENABLED       1
 
+// Defaults of the XPOD.CFG settings, see xpod_config.h
+#define ADS_FIGARO_SAMPLES    20
+#define ADS_HEATER_SAMPLES    20
+#define ADS_RATE_SPS          128
+#define ADS_BUDGET_MS         1000
+#define ADS_RATE_COUNT        8
+// A single shot conversion starts with the oscillator waking up
+#define ADS_WAKEUP_US         50
+
 enum ads_sensor_id_e
 {
     ADS_SENSOR_FIG2600 = 0,
@@ -28,33 +37,104 @@ enum ads_sensor_id_e
     ADS_SENSOR_COUNT
 };
 
+enum ads_conv_state_e
+{
+    ADS_CONV_PENDING = 0,
+    ADS_CONV_BUSY,
+    ADS_CONV_DONE
+};
+
+// Data rates of the ADS1115 in samples per second, RATE_ADS1115_* order
+extern const uint16_t ads_rates[ADS_RATE_COUNT] PROGMEM;
+
+// One conversion at a time per ADS1115, whichever module asks: a start
+// rewrites the chip's mux. Claim false while another holds the chip.
+bool ads_chip_claim(uint8_t addr);
+void ads_chip_release(uint8_t addr);
+
+struct ads_sample_t
+{
+    float volts[ADS_SENSOR_COUNT];
+    uint16_t raw[ADS_SENSOR_COUNT];
+    float co_aux;
+    float co_main;
+};
+
 struct ads_module_t
 {
     uint8_t addr;
     int8_t channel;
     bool status;
     Adafruit_ADS1115 module;
+
+    // Acquisition state of the current cycle
+    ads_conv_state_e state;
+    uint8_t samples;
+    uint8_t taken;
+    float v_sum;
+    int32_t raw_sum;
+    int16_t first;
+    int16_t last;
+    // micros() of the conversion's start
+    unsigned long conv_start;
 };
 
 class ADS_Module {
   public:
+    typedef ads_sample_t sample_type;
+
+    static const uint8_t column_count = 6 + 2 * FIGARO3_ENABLED + 2 * FIGARO4_ENABLED;
+    static const uint16_t budget_ms = ADS_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     ADS_Module();
     bool begin();
-    
-    float read_figaro(ads_sensor_id_e ads_sensor_id);
-    float read_heater(ads_sensor_id_e ads_sensor_id);
-    float read_co();
-    float read_co_aux();
-    float read_co_main();
-    uint16_t read_raw(ads_sensor_id_e ads_sensor_id);
-
-    String read4sd();
-    String read4print();
-    String read4sd_raw();
-    String read4print_raw();
+    int8_t warm();
+
+    void start();
+    bool poll();
+    bool collect(ads_sample_t &sample);
+    void abort();
+    // Longest a cycle's conversions take at the XPOD.CFG settings
+    static uint32_t conversion_ms();
+
+    void read4print(const ads_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const ads_sample_t &sample, Sink &sink);
 
   private:
+    uint16_t conv_mux(ads_sensor_id_e ads_sensor_id);
+    void convert(ads_sensor_id_e ads_sensor_id);
+
+    // Nominal conversion time at ads_rate_sps, wake-up included
+    unsigned long conv_us;
+
     ads_module_t ads_module[ADS_SENSOR_COUNT];
 };
 
+template <class Sink>
+void ADS_Module::columns(const ads_sample_t &sample, Sink &sink)
+{
+  sink.put_uint(sample.raw[ADS_SENSOR_FIG2600]);
+  sink.put_uint(sample.raw[ADS_SENSOR_FIG2602]);
+
+  #if FIGARO3_ENABLED
+    sink.put_uint(sample.raw[ADS_SENSOR_FIG3]);
+    sink.put_uint(sample.raw[ADS_HEATER_FIG3]);
+  #endif
+
+  #if FIGARO4_ENABLED
+    sink.put_uint(sample.raw[ADS_SENSOR_FIG4]);
+    sink.put_uint(sample.raw[ADS_HEATER_FIG4]);
+  #endif
+
+  sink.put_uint(sample.raw[ADS_SENSOR_PID]);
+  sink.put_uint(sample.raw[ADS_SENSOR_E2V]);
+
+  sink.put_float(sample.co_aux, 2);
+  sink.put_float(sample.co_main, 2);
+}
+
 #endif  //_ADS_MODULE_H
@@ -0,0 +1,544 @@
+/*******************************************************************************
+ * @file    bin_log.cpp
+ * @brief   Binary sample records in a preallocated daily file.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "bin_log.h"
+#include "crc16.h"
+#include "fixed_point.h"
+#include "log_record.h"
+#include "xpod_config.h"
+#include "xpod_node.h"
+
+static const char bin_log_magic[4] = {'X', 'P', 'B', 'L'};
+
+// Forwards the CSV header line to the file, cut at the space the header has
+class Header_Print : public Print
+{
+  public:
+    Header_Print(SdBaseFile &file, uint16_t room) : file(file), room(room) {}
+
+    size_t write(uint8_t c)
+    {
+      if (room == 0)
+        return 0;
+      room--;
+      return file.write(&c, 1);
+    }
+    using Print::write;
+
+  private:
+    SdBaseFile &file;
+    uint16_t room;
+};
+
+// Counts and checksums the bytes of a record, and writes them when it has
+// somewhere to
+class Record_Writer
+{
+  public:
+    Record_Writer(Print *out) : size(0), crc(CRC16_INIT), ok(true), out(out) {}
+
+    void put(uint8_t value)
+    {
+      crc = crc16_update(crc, value);
+      size++;
+      if (out && out->write(value) != 1)
+        ok = false;
+    }
+
+    void put(const uint8_t *data, uint16_t length)
+    {
+      for (uint16_t i = 0; i < length; i++)
+        put(data[i]);
+    }
+
+    void varint(uint32_t value)
+    {
+      while (value >= 0x80)
+      {
+        put((uint8_t)value | 0x80);
+        value >>= 7;
+      }
+      put((uint8_t)value);
+    }
+
+    // Small values of either sign in few bytes
+    void zigzag(uint32_t value)
+    {
+      varint((value << 1) ^ ((int32_t)value < 0 ? 0xFFFFFFFFUL : 0));
+    }
+
+    uint16_t size;
+    uint16_t crc;
+    bool ok;
+
+  private:
+    Print *out;
+};
+
+static uint32_t get_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// The shortest cycle the settings allow, SQW pacing falls back to millis()
+static uint32_t cycle_ms()
+{
+  uint32_t period_ms = xpod_config.loop_period_ms;
+
+#if SQW_PACING_ENABLED
+  period_ms = min(period_ms, xpod_config.sample_period_s * 1000UL);
+#endif
+  return period_ms;
+}
+
+Bin_Log::Bin_Log()
+{
+  memset(&header, 0, sizeof(header));
+  csv_header = NULL;
+  mismatch = false;
+  dropped = 0;
+  defined = false;
+  header_dirty = false;
+  new_file = false;
+  column = 0;
+  prev_seq = 0;
+  have_prev = false;
+  since_keyframe = 0;
+}
+
+bool Bin_Log::begin(SdBaseFile &file, void (*csv_header)(Print &out), uint8_t keyframe_interval)
+{
+  this->csv_header = csv_header;
+  mismatch = false;
+  dropped = 0;
+  header_dirty = false;
+  have_prev = false;
+
+  if (file.fileSize() == 0)
+  {
+    // Without a contiguous run the log still works, appends just allocate
+    file.preAllocate(86400000UL / cycle_ms() * BIN_LOG_PREALLOC_RECORD);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, bin_log_magic, sizeof(bin_log_magic));
+    header.version = BIN_LOG_VERSION;
+    header.last_record = BIN_LOG_NO_RECORD;
+    header.keyframe_interval = keyframe_interval;
+    defined = false;
+    new_file = true;
+
+    return file.seekSet(0);
+  }
+
+  if (file.read(&header, sizeof(header)) != (int)sizeof(header) ||
+      memcmp(header.magic, bin_log_magic, sizeof(bin_log_magic)) != 0 ||
+      header.version != BIN_LOG_VERSION)
+    return false;
+
+  defined = true;
+  new_file = false;
+
+  // Going further back takes fixed-size records, a delta coded file only
+  // knows where its last one starts
+  uint16_t stride = header.record_size + BIN_LOG_TRAILER_SIZE;
+
+  while (header.last_record != BIN_LOG_NO_RECORD && dropped < LOG_TAIL_MAX_RECORDS &&
+         !valid_record(file, header.last_record))
+  {
+    header.data_size = header.last_record;
+    header.records--;
+    dropped++;
+    header_dirty = true;
+
+    if (header.keyframe_interval || header.last_record < stride)
+      header.last_record = BIN_LOG_NO_RECORD;
+    else
+      header.last_record -= stride;
+  }
+
+  return file.seekSet(BIN_LOG_HEADER_SIZE + (uint64_t)header.data_size);
+}
+
+// Checks the CRC of the record at `offset` in the data
+bool Bin_Log::valid_record(SdBaseFile &file, uint32_t offset)
+{
+  uint8_t chunk[32];
+  uint16_t crc = CRC16_INIT;
+  uint16_t left;
+
+  if (!file.seekSet(BIN_LOG_HEADER_SIZE + (uint64_t)offset))
+    return false;
+
+  if (header.keyframe_interval == 0)
+  {
+    left = header.record_size + sizeof(uint32_t);
+  }
+  else
+  {
+    int kind = file.read();
+
+    if (kind != BIN_LOG_KEYFRAME && kind != BIN_LOG_DELTA)
+      return false;
+    crc = crc16_update(crc, kind);
+
+    // Length, a varint of two bytes at most
+    left = 0;
+    for (uint8_t shift = 0;; shift += 7)
+    {
+      int c = file.read();
+
+      if (c < 0 || shift > 7)
+        return false;
+      crc = crc16_update(crc, c);
+      left |= (c & 0x7F) << shift;
+      if (!(c & 0x80))
+        break;
+    }
+  }
+
+  while (left > 0)
+  {
+    uint16_t n = min(left, (uint16_t)sizeof(chunk));
+
+    if (file.read(chunk, n) != n)
+      return false;
+    crc = crc16(chunk, n, crc);
+    left -= n;
+  }
+
+  if (file.read(chunk, 2) != 2)
+    return false;
+
+  return crc == (chunk[0] | (chunk[1] << 8));
+}
+
+// Rewrites the header in place, a new file also gets the CSV header line
+bool Bin_Log::write_header(SdBaseFile &file)
+{
+  uint64_t position = file.curPosition();
+
+  if (!file.seekSet(0) || file.write(&header, sizeof(header)) != sizeof(header))
+    return false;
+
+  if (new_file)
+  {
+    static const uint8_t zeros[32] = {0};
+    Header_Print text(file, BIN_LOG_HEADER_SIZE - sizeof(header) - 1);
+
+    if (csv_header)
+      csv_header(text);
+
+    while (file.curPosition() < BIN_LOG_HEADER_SIZE)
+    {
+      size_t n = min((uint64_t)sizeof(zeros), BIN_LOG_HEADER_SIZE - file.curPosition());
+
+      if (file.write(zeros, n) != n)
+        return false;
+    }
+
+    new_file = false;
+    position = BIN_LOG_HEADER_SIZE;
+  }
+
+  header_dirty = false;
+  return file.seekSet(position);
+}
+
+// Payload of a delta coded record, against `prev` unless it is a keyframe
+template <class W>
+void Bin_Log::encode(W &out, const uint8_t *record, uint32_t seq, bool keyframe)
+{
+  const uint8_t *p = record;
+  const uint8_t *q = prev;
+
+  out.varint(keyframe ? seq : seq - prev_seq);
+
+  for (uint8_t i = 0; i < header.column_count; i++)
+  {
+    uint8_t width = header.width[i];
+
+    // 4 byte slots are numbers whatever their tag says so far
+    if (width == 4)
+      out.zigzag(keyframe ? get_le32(p) : get_le32(p) - get_le32(q));
+    else if (width > 0 && keyframe)
+      out.put(p, width);
+    else if (width > 0 && memcmp(p, q, width) == 0)
+      out.put(0);
+    else if (width > 0)
+    {
+      out.put(1);
+      out.put(p, width);
+    }
+
+    p += width;
+    q += width;
+  }
+}
+
+bool Bin_Log::append(SdBaseFile &file, Print &out, const uint8_t *record, uint16_t size,
+                     uint32_t seq)
+{
+  if (mismatch || !defined || size != header.record_size)
+    return false;
+
+  // Only a new file's header goes out here, `out` is still empty then.
+  // Later changes wait for sync(), after what `out` holds.
+  if (new_file && !write_header(file))
+    return false;
+
+  uint16_t written;
+
+  if (header.keyframe_interval == 0)
+  {
+    uint8_t trailer[BIN_LOG_TRAILER_SIZE];
+    for (uint8_t i = 0; i < 4; i++)
+      trailer[i] = seq >> (8 * i);
+
+    uint16_t crc = crc16(trailer, 4, crc16(record, size));
+    trailer[4] = crc;
+    trailer[5] = crc >> 8;
+
+    if (out.write(record, size) != size || out.write(trailer, sizeof(trailer)) != sizeof(trailer))
+      return false;
+    written = size + sizeof(trailer);
+  }
+  else
+  {
+    bool keyframe = !have_prev || since_keyframe == 0 || size > sizeof(prev);
+
+    // The length goes first, the payload is encoded once to count it
+    Record_Writer length(NULL);
+    encode(length, record, seq, keyframe);
+
+    Record_Writer w(&out);
+    w.put(keyframe ? BIN_LOG_KEYFRAME : BIN_LOG_DELTA);
+    w.varint(length.size);
+    encode(w, record, seq, keyframe);
+
+    uint16_t crc = w.crc;
+    if (!w.ok || out.write((uint8_t)crc) != 1 || out.write((uint8_t)(crc >> 8)) != 1)
+    {
+      // The next record has nothing to be a delta of
+      have_prev = false;
+      return false;
+    }
+    written = w.size + 2;
+
+    if (size <= sizeof(prev))
+    {
+      memcpy(prev, record, size);
+      have_prev = true;
+    }
+    prev_seq = seq;
+    since_keyframe = keyframe ? 1 : since_keyframe + 1;
+    if (since_keyframe >= header.keyframe_interval)
+      since_keyframe = 0;
+  }
+
+  header.last_record = header.data_size;
+  header.data_size += written;
+  header.records++;
+  header_dirty = true;
+  return true;
+}
+
+bool Bin_Log::sync(SdBaseFile &file)
+{
+  if (header_dirty && !new_file && !write_header(file))
+    return false;
+
+  return file.sync();
+}
+
+bool Bin_Log::close(SdBaseFile &file)
+{
+  bool ok = sync(file);
+
+  // A FAT file is as long as its preallocation until here
+  if (!new_file)
+    ok &= file.truncate();
+
+  return file.close() && ok;
+}
+
+uint32_t Bin_Log::data_end(SdBaseFile &file)
+{
+  uint64_t position = file.curPosition();
+  uint32_t size = file.fileSize();
+  bin_log_header_t header;
+
+  if (file.seekSet(0) && file.read(&header, sizeof(header)) == (int)sizeof(header) &&
+      memcmp(header.magic, bin_log_magic, sizeof(bin_log_magic)) == 0 &&
+      BIN_LOG_HEADER_SIZE + header.data_size < size)
+    size = BIN_LOG_HEADER_SIZE + header.data_size;
+
+  file.seekSet(position);
+  return size;
+}
+
+/******************************  Record builder  ******************************/
+Bin_Record::Bin_Record(Bin_Log &log, Print &out) : log(log), out(out)
+{
+  log.column = 0;
+
+  if (!log.defined)
+  {
+    log.header.column_count = 0;
+    log.header.record_size = 0;
+  }
+}
+
+// Width of the next column's slot, 0 for none. The first record of a file
+// defines the slots, later ones have to match them; a column that was empty
+// so far takes its type from the first value it gets.
+uint8_t Bin_Record::slot(uint8_t tag, uint8_t width)
+{
+  bin_log_header_t &header = log.header;
+  uint8_t i = log.column++;
+
+  if (log.mismatch)
+    return 0;
+
+  if (!log.defined)
+  {
+    if (i >= BIN_LOG_MAX_COLUMNS)
+    {
+      log.mismatch = true;
+      return 0;
+    }
+
+    header.tag[i] = tag;
+    header.width[i] = width;
+    header.column_count = i + 1;
+    header.record_size += width;
+    return width;
+  }
+
+  if (i >= header.column_count || (width == 0) != (header.width[i] == 0))
+  {
+    log.mismatch = true;
+    return 0;
+  }
+
+  if (tag != TELEMETRY_SKIP && tag != header.tag[i])
+  {
+    if (header.tag[i] != TELEMETRY_SKIP)
+    {
+      log.mismatch = true;
+      return 0;
+    }
+
+    header.tag[i] = tag;
+    log.header_dirty = true;
+  }
+
+  return header.width[i];
+}
+
+void Bin_Record::put_le(uint8_t tag, uint32_t value)
+{
+  put_bytes(value, slot(tag, 4));
+}
+
+// Little-endian, a numeric slot is always 4 bytes wide
+void Bin_Record::put_bytes(uint32_t value, uint8_t width)
+{
+  for (uint8_t i = 0; i < width; i++)
+  {
+    out.write((uint8_t)value);
+    value >>= 8;
+  }
+}
+
+void Bin_Record::put_int(long value)
+{
+  put_le(TELEMETRY_INT, (uint32_t)value);
+}
+
+void Bin_Record::put_uint(unsigned long value)
+{
+  put_le(TELEMETRY_UINT, value);
+}
+
+// nan, inf, -0 and values beyond the fixed range get a reserved value
+void Bin_Record::put_float(float value, uint8_t decimals)
+{
+  int32_t fixed = 0;
+  uint32_t code;
+
+  if (isnan(value))
+    code = BIN_LOG_NAN;
+  else if (isinf(value))
+    code = BIN_LOG_INF;
+  else if (!to_fixed(value, decimals, fixed))
+    code = BIN_LOG_OVF;
+  else if (fixed == 0 && value < 0)
+    code = BIN_LOG_NEG_ZERO;
+  else
+    code = (uint32_t)fixed;
+
+  put_le(TELEMETRY_FIXED | (decimals & 0x0F), code);
+}
+
+void Bin_Record::put_fixed(long value, uint8_t decimals)
+{
+  put_le(TELEMETRY_FIXED | (decimals & 0x0F), (uint32_t)value);
+}
+
+// A text longer than its slot does not fit the file's layout, it starts a
+// new part rather than losing its end
+void Bin_Record::put_str(const char *value)
+{
+  size_t len = min(strlen(value), (size_t)255);
+  uint8_t width = slot(TELEMETRY_TEXT, len ? len : 1);
+
+  if (len > width)
+    log.mismatch = true;
+
+  for (uint8_t i = 0; i < width; i++)
+    out.write(i < len ? (uint8_t)value[i] : 0);
+}
+
+void Bin_Record::put_time(const DateTime &value)
+{
+  put_le(TELEMETRY_TIME, value.unixtime());
+}
+
+void Bin_Record::skip()
+{
+  uint8_t width = slot(TELEMETRY_SKIP, 4);
+
+  if (width == 0)
+    return;
+
+  if (log.header.tag[log.column - 1] == TELEMETRY_TEXT)
+  {
+    out.write(BIN_LOG_EMPTY_TEXT);
+    for (uint8_t i = 1; i < width; i++)
+      out.write((uint8_t)0);
+  }
+  else
+  {
+    put_bytes(BIN_LOG_EMPTY, width);
+  }
+}
+
+void Bin_Record::disabled(uint8_t columns)
+{
+  for (uint8_t i = 0; i < columns; i++)
+    slot(TELEMETRY_SKIP, 0);
+}
+
+bool Bin_Record::end()
+{
+  if (!log.defined)
+    log.defined = !log.mismatch;
+  else if (log.column != log.header.column_count)
+    log.mismatch = true;
+
+  return !log.mismatch;
+}
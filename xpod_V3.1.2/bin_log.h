@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * @file    bin_log.h
+ * @brief   Binary sample records in a preallocated daily file.
+ *
+ *          With BIN_LOG_ENABLED the SD log holds records instead of CSV
+ *          lines. The file's clusters are allocated in one contiguous run
+ *          when it is created, so an append never walks the FAT for a free
+ *          cluster in the middle of a cycle:
+ *
+ *            header (BIN_LOG_HEADER_SIZE bytes) | record | record | ...
+ *
+ *          The header holds bin_log_header_t and, after it, the CSV header
+ *          line. Bin_Record lays a sample out with one slot per column:
+ *            - numbers are a little-endian 32 bit value, typed by the
+ *              column's tag (TELEMETRY_INT/UINT/FIXED/TIME of telemetry.h,
+ *              decimals in the low nibble);
+ *            - TEXT is the characters padded with zeros to the slot width;
+ *            - columns of a module that is not built have no slot.
+ *          The BIN_LOG_* values below stand for an empty column, for the
+ *          nan/inf/-0 texts of print_float() and for a value beyond the 32
+ *          bit fixed-point range (read back as "ovf", the text log has its
+ *          digits).
+ *
+ *          The first record of a file fixes the layout. A column that is
+ *          empty in it keeps the SKIP tag until it first holds a value, the
+ *          header is rewritten then. A TEXT slot is as wide as its text in
+ *          that record, a longer one later is a mismatch like a changed
+ *          column.
+ *
+ *          With a keyframe_interval of 0 the file stores the slots as they
+ *          are, then the record's sequence number (log_record.h) and the
+ *          CRC-16 of both. Otherwise records are delta coded:
+ *
+ *            'K' or 'D' | varint length | payload | CRC-16 (of all before)
+ *
+ *          A keyframe ('K') payload is the sequence number as a varint, then
+ *          every 4 byte slot as a zigzag varint and every TEXT slot as it
+ *          is. A delta ('D') payload has the differences to the previous
+ *          record instead, and a TEXT slot is a 0 when it did not change or
+ *          a 1 and its bytes. Most readings move by a few counts between
+ *          samples and take one byte. A keyframe comes every
+ *          keyframe_interval records and first after every begin(), a reader
+ *          can start at any of them.
+ *
+ *          `records` and `data_size` are as of the last sync(). A FAT file's
+ *          size is its preallocated size until close() truncates it, the
+ *          header is what marks the end of the data. begin() drops records
+ *          at the end that fail their CRC.
+ *
+ *          tools/xpod_binlog.cpp turns a file back into the CSV of the text
+ *          log, byte for byte.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _BIN_LOG_H
+#define _BIN_LOG_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <SdFat.h>
+
+#include "telemetry.h"
+
+#define BIN_LOG_VERSION       3
+#define BIN_LOG_HEADER_SIZE   1024
+#define BIN_LOG_MAX_COLUMNS   96
+// Sequence number and CRC after the slots of a fixed-size record
+#define BIN_LOG_TRAILER_SIZE  6
+// Longest record that can be delta coded, longer ones are all keyframes
+#define BIN_LOG_MAX_RECORD    256
+
+// Bytes a record of `size` slot bytes takes in the file at most
+#define BIN_LOG_RECORD_BOUND(size) ((size) + (size) / 4 + 16)
+
+#define BIN_LOG_KEYFRAME      'K'
+#define BIN_LOG_DELTA         'D'
+#define BIN_LOG_NO_RECORD     0xFFFFFFFFUL
+
+// Reserved slot values, no reading scales to them
+#define BIN_LOG_EMPTY         0x80000000UL
+#define BIN_LOG_NAN           0x80000001UL
+#define BIN_LOG_INF           0x80000002UL
+#define BIN_LOG_OVF           0x80000003UL
+#define BIN_LOG_NEG_ZERO      0x80000004UL
+// First byte of an empty TEXT slot
+#define BIN_LOG_EMPTY_TEXT    0xFF
+
+struct bin_log_header_t
+{
+    char magic[4];            // "XPBL"
+    uint8_t version;
+    uint8_t column_count;
+    uint16_t record_size;     // slots only
+    uint32_t records;
+    uint32_t data_size;       // bytes of records after the header
+    uint32_t last_record;     // offset of the last of them
+    uint8_t keyframe_interval;
+    uint8_t reserved[3];      // 216 bytes on AVR and on hosts alike
+    uint8_t tag[BIN_LOG_MAX_COLUMNS];
+    uint8_t width[BIN_LOG_MAX_COLUMNS];
+};
+
+class Bin_Log
+{
+  public:
+    Bin_Log();
+
+    // Sets up an open file, a new one is preallocated and gets its header
+    // with the first record; its records are delta coded with a keyframe
+    // every `keyframe_interval` records, 0 keeps them fixed-size. False if
+    // the file is not a binary log.
+    bool begin(SdBaseFile &file, void (*csv_header)(Print &out), uint8_t keyframe_interval);
+
+    // Appends a record built with Bin_Record to `out`, a buffer in front of
+    // the file or the file itself. The header catches up at sync().
+    bool append(SdBaseFile &file, Print &out, const uint8_t *record, uint16_t size,
+                uint32_t seq);
+    // Updates the record count in the header and syncs the file, `out` of
+    // append() has to be flushed first
+    bool sync(SdBaseFile &file);
+    // Syncs, drops the unused preallocation and closes
+    bool close(SdBaseFile &file);
+
+    // Where the data of a binary log ends as of its last sync(), the size
+    // of any other file
+    static uint32_t data_end(SdBaseFile &file);
+
+    // Set by Bin_Record when the columns do not match the file's layout
+    bool mismatch;
+    // Records begin() found torn at the end of the file
+    uint8_t dropped;
+
+  private:
+    friend class Bin_Record;
+
+    bool write_header(SdBaseFile &file);
+    bool valid_record(SdBaseFile &file, uint32_t offset);
+    template <class W>
+    void encode(W &out, const uint8_t *record, uint32_t seq, bool keyframe);
+
+    bin_log_header_t header;
+    uint8_t prev[BIN_LOG_MAX_RECORD];
+    uint32_t prev_seq;
+    bool have_prev;
+    uint8_t since_keyframe;
+    void (*csv_header)(Print &out);
+    bool defined;
+    bool header_dirty;
+    bool new_file;
+    uint8_t column;
+};
+
+// Column sink of csv_writer.h that fills one record and, for the first
+// record of a file, the layout
+class Bin_Record
+{
+  public:
+    Bin_Record(Bin_Log &log, Print &out);
+
+    void put_int(long value);
+    void put_uint(unsigned long value);
+    void put_float(float value, uint8_t decimals);
+    void put_fixed(long value, uint8_t decimals);
+    void put_str(const char *value);
+    void put_time(const DateTime &value);
+    void skip();
+    void disabled(uint8_t columns);
+
+    // False when the record does not fit the layout of the file
+    bool end();
+
+  private:
+    uint8_t slot(uint8_t tag, uint8_t width);
+    void put_le(uint8_t tag, uint32_t value);
+    void put_bytes(uint32_t value, uint8_t width);
+
+    Bin_Log &log;
+    Print &out;
+};
+
+#endif  //_BIN_LOG_H
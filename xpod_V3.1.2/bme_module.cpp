@@ -7,10 +7,29 @@
  ******************************************************************************/
 #include <Arduino.h>
 #include "bme_module.h"
+#include "fixed_point.h"
+#include "xpod_config.h"
+
+// BME680_OS_* of an oversampling count: 0, 1, 2, 4, 8, 16
+static uint8_t os_bits(uint8_t count)
+{
+  uint8_t bits = 0;
+
+  while (count)
+  {
+    bits++;
+    count >>= 1;
+  }
+  return bits;
+}
+
+const char BME_Module::name[] PROGMEM = "BME680";
+const char BME_Module::header[] PROGMEM = "Temp,Pressure,Humidity";
 
 BME_Module::BME_Module()
 {
   status = false;
+  reading = false;
 }
 
 bool BME_Module::begin()
@@ -20,43 +39,70 @@ bool BME_Module::begin()
     status = true;
     
     // Set up oversampling and filter initialization
-    bme_sensor.setTemperatureOversampling(BME680_OS_8X);
-    bme_sensor.setHumidityOversampling(BME680_OS_2X);
-    bme_sensor.setPressureOversampling(BME680_OS_4X);
-    bme_sensor.setIIRFilterSize(BME680_FILTER_SIZE_3);
+    bme_sensor.setTemperatureOversampling(os_bits(xpod_config.bme_os_temp));
+    bme_sensor.setHumidityOversampling(os_bits(xpod_config.bme_os_hum));
+    bme_sensor.setPressureOversampling(os_bits(xpod_config.bme_os_pres));
+    // Filter sizes 2^n - 1 are BME680_FILTER_SIZE_* n
+    bme_sensor.setIIRFilterSize(os_bits(xpod_config.bme_filter));
     bme_sensor.setGasHeater(320, 150);
   }
 
   return status;
 }
 
-String BME_Module::read4sd()
+int8_t BME_Module::warm()
 {
-  String bms_data_str;
+  return 1;
+}
 
+void BME_Module::start()
+{
+  reading = status && bme_sensor.beginReading() != 0;
+}
 
+bool BME_Module::poll()
+{
+  if (!reading)
+    return true;
 
-  bms_data_str = String(bme_sensor.temperature) + ",";
-  bms_data_str += String(bme_sensor.pressure / 100.0) + ",";
-  bms_data_str += String(bme_sensor.humidity) ;
-  // bms_data_str += String(bme_sensor.gas_resistance / 1000.0) + ",";
-  // bms_data_str += String(bme_sensor.readAltitude(SEALEVELPRESSURE_HPA));
+  return bme_sensor.remainingReadingMillis() == Adafruit_BME680::reading_complete;
+}
 
-  return bms_data_str;
+void BME_Module::abort()
+{
+  reading = false;
 }
 
-String BME_Module::read4print()
+bool BME_Module::collect(bme_sample_t &sample)
 {
-  String bms_data_str;
+  bool valid = false;
 
-  // if (!status)
-  //   return "";
+  // The measurement has already finished, endReading() only fetches it
+  if (reading)
+    valid = bme_sensor.endReading();
 
-  bms_data_str = "Temp:" + String(bme_sensor.temperature) + " C,";
-  bms_data_str += "Pressure:" + String(bme_sensor.pressure / 100.0) + " hPa,";
-  bms_data_str += "Humidity:" + String(bme_sensor.humidity) + " %,";
-  bms_data_str += "Gas:" + String(bme_sensor.gas_resistance / 1000.0) + " KOhms,";
-  bms_data_str += "Altitude:" + String(bme_sensor.readAltitude(SEALEVELPRESSURE_HPA)) + " m";
+  reading = false;
 
-  return bms_data_str;
+  sample.temperature = bme_sensor.temperature;
+  sample.pressure = bme_sensor.pressure;
+  sample.humidity = bme_sensor.humidity;
+  sample.gas_resistance = bme_sensor.gas_resistance;
+
+  return valid;
+}
+
+void BME_Module::read4print(const bme_sample_t &sample, Print &out)
+{
+  out.print(F("Temp:"));
+  print_float(out, sample.temperature, 2);
+  out.print(F(" C,Pressure:"));
+  print_fixed(out, sample.pressure, 2);
+  out.print(F(" hPa,Humidity:"));
+  print_float(out, sample.humidity, 2);
+  out.print(F(" %,Gas:"));
+  print_float(out, sample.gas_resistance / 1000.0, 2);
+  // Same equation as Adafruit_BME680::readAltitude(), without another reading
+  out.print(F(" KOhms,Altitude:"));
+  print_float(out, 44330.0 * (1.0 - pow((sample.pressure / 100.0F) / SEALEVELPRESSURE_HPA, 0.1903)), 2);
+  out.print(F(" m"));
 }
\ No newline at end of file
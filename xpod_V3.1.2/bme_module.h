@@ -12,18 +12,58 @@
 
 #define BME_SENSOR_ADDR       (0x76)
 #define SEALEVELPRESSURE_HPA  (1013.25)
+#define BME_BUDGET_MS         1000
+
+// Defaults of the XPOD.CFG settings, oversampling 0 is off
+#define BME_OS_TEMP           8
+#define BME_OS_HUM            2
+#define BME_OS_PRES           4
+#define BME_FILTER            3
+
+struct bme_sample_t
+{
+    float temperature;
+    uint32_t pressure;
+    float humidity;
+    uint32_t gas_resistance;
+};
 
 class BME_Module
 {
   public:
+    typedef bme_sample_t sample_type;
+
+    static const uint8_t column_count = 3;
+    static const uint16_t budget_ms = BME_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     BME_Module();
     bool begin();
-    String read4sd();
-    String read4print();
+    int8_t warm();
+
+    void start();
+    bool poll();
+    bool collect(bme_sample_t &sample);
+    void abort();
+
+    void read4print(const bme_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const bme_sample_t &sample, Sink &sink);
 
   private:
     Adafruit_BME680 bme_sensor;
     bool status;
+    bool reading;
 };
 
-#endif  //_BME_MODULE_H
\ No newline at end of file
+template <class Sink>
+void BME_Module::columns(const bme_sample_t &sample, Sink &sink)
+{
+  sink.put_float(sample.temperature, 2);
+  sink.put_fixed(sample.pressure, 2);   // Pa to hPa
+  sink.put_float(sample.humidity, 2);
+}
+
+#endif  //_BME_MODULE_H
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * @file    co2_module.cpp
+ * @brief   Reads the ELT S300 CO2 sensor over I2C without blocking.
+ *
+ *          Same protocol as S300I2C::getCO2ppm(), split so that the read
+ *          command and the 7 byte answer are separate start()/collect() steps
+ *          instead of the library's per-byte delay(10).
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "co2_module.h"
+#include "fixed_point.h"
+
+const char CO2_Module::name[] PROGMEM = "S300";
+const char CO2_Module::header[] PROGMEM = "CO2";
+
+CO2_Module::CO2_Module()
+{
+  i2c_addr = 0;
+  status = false;
+}
+
+// The S300 has no ID register, it has to ACK its address
+bool CO2_Module::begin(uint8_t addr)
+{
+  i2c_addr = addr;
+  Wire.beginTransmission(i2c_addr);
+  status = Wire.endTransmission() == 0;
+
+  return status;
+}
+
+int8_t CO2_Module::warm()
+{
+  return 1;
+}
+
+void CO2_Module::start()
+{
+  Wire.beginTransmission(i2c_addr);
+  Wire.write(CO2_READ_CMD);
+  Wire.endTransmission();
+  cmd_time = millis();
+}
+
+bool CO2_Module::poll()
+{
+  return (millis() - cmd_time) >= CO2_READ_DELAY;
+}
+
+void CO2_Module::abort()
+{
+}
+
+bool CO2_Module::collect(unsigned int &co2_ppm)
+{
+  uint8_t buf[CO2_FRAME_LEN];
+  uint8_t len = 0;
+
+  Wire.requestFrom(i2c_addr, (uint8_t)CO2_FRAME_LEN);
+  while (Wire.available() && len < CO2_FRAME_LEN)
+    buf[len++] = Wire.read();
+
+  if (len != CO2_FRAME_LEN || buf[0] != 0x08 ||
+      buf[3] == 0xff || buf[4] == 0xff || buf[5] == 0xff || buf[6] == 0xff)
+  {
+    co2_ppm = 0;
+    return false;
+  }
+
+  co2_ppm = (buf[1] << 8) | buf[2];
+  return true;
+}
+
+void CO2_Module::read4print(unsigned int co2_ppm, Print &out)
+{
+  out.print(F("CO2:"));
+  print_uint(out, co2_ppm);
+}
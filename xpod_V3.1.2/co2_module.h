@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * @file    co2_module.h
+ * @brief   Reads the ELT S300 CO2 sensor over I2C without blocking.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _CO2_MODULE_H
+#define _CO2_MODULE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define CO2_I2C_ADDR          0x31
+#define CO2_READ_CMD          'R'
+#define CO2_FRAME_LEN         7
+#define CO2_READ_DELAY        10
+#define CO2_BUDGET_MS         100
+
+class CO2_Module
+{
+  public:
+    typedef unsigned int sample_type;
+
+    static const uint8_t column_count = 1;
+    static const uint16_t budget_ms = CO2_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
+    CO2_Module();
+    bool begin(uint8_t addr = CO2_I2C_ADDR);
+    int8_t warm();
+
+    void start();
+    bool poll();
+    bool collect(unsigned int &co2_ppm);
+    void abort();
+
+    void read4print(unsigned int co2_ppm, Print &out);
+
+    template <class Sink>
+    static void columns(unsigned int co2_ppm, Sink &sink)
+    {
+      sink.put_uint(co2_ppm);
+    }
+
+  private:
+    uint8_t i2c_addr;
+    unsigned long cmd_time;
+    bool status;
+};
+
+#endif  //_CO2_MODULE_H
@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * @file    console_serial.cpp
+ * @brief   Interrupt driven console on USART0 with a large TX ring.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "console_serial.h"
+
+#if CONSOLE_UART_ENABLED
+
+#define TX_MASK   (CONSOLE_TX_BUFFER_SIZE - 1)
+#define RX_MASK   (CONSOLE_RX_BUFFER_SIZE - 1)
+
+static_assert((CONSOLE_TX_BUFFER_SIZE & TX_MASK) == 0, "CONSOLE_TX_BUFFER_SIZE is not a power of two");
+static_assert((CONSOLE_RX_BUFFER_SIZE & RX_MASK) == 0, "CONSOLE_RX_BUFFER_SIZE is not a power of two");
+static_assert(CONSOLE_RX_BUFFER_SIZE <= 256, "rx indices are 8 bit");
+
+Console_Serial Console;
+
+ISR(USART0_RX_vect)
+{
+  Console.rx_irq();
+}
+
+ISR(USART0_UDRE_vect)
+{
+  Console.udre_irq();
+}
+
+Console_Serial::Console_Serial()
+{
+  tx_head = 0;
+  tx_tail = 0;
+  rx_head = 0;
+  rx_tail = 0;
+  dropped_count = 0;
+  policy = CONSOLE_TX_DROP;
+  written = false;
+}
+
+void Console_Serial::begin(unsigned long baud, uint8_t policy)
+{
+  this->policy = policy;
+  dropped_count = 0;
+
+  // Double speed mode, the same divisor HardwareSerial picks. 115200 baud
+  // is 2.1% off at 16 MHz, 250000, 500000 and 1000000 are exact.
+  uint16_t ubrr = (F_CPU / 4 / baud - 1) / 2;
+
+  UCSR0A = _BV(U2X0);
+  UBRR0H = ubrr >> 8;
+  UBRR0L = ubrr;
+  UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+  UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+
+void Console_Serial::end()
+{
+  flush();
+  UCSR0B = 0;
+  rx_head = rx_tail;
+}
+
+int Console_Serial::available()
+{
+  return (uint8_t)(rx_head - rx_tail) & RX_MASK;
+}
+
+int Console_Serial::peek()
+{
+  if (rx_head == rx_tail)
+    return -1;
+
+  return rx_buffer[rx_tail];
+}
+
+int Console_Serial::read()
+{
+  if (rx_head == rx_tail)
+    return -1;
+
+  uint8_t c = rx_buffer[rx_tail];
+  rx_tail = (rx_tail + 1) & RX_MASK;
+
+  return c;
+}
+
+uint16_t Console_Serial::tx_free()
+{
+  uint16_t head, tail;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    head = tx_head;
+    tail = tx_tail;
+  }
+
+  return (tail - head - 1) & TX_MASK;
+}
+
+int Console_Serial::availableForWrite()
+{
+  return tx_free();
+}
+
+// Waits until the ring is empty and the last byte has left the shift register
+void Console_Serial::flush()
+{
+  if (!written)
+    return;
+
+  // UCSR0A first, the host build's clock only moves on its reads
+  while (!(UCSR0A & _BV(TXC0)) || (UCSR0B & _BV(UDRIE0)))
+  {
+    // Called with interrupts off, drain the ring by hand
+    if (bit_is_clear(SREG, SREG_I) && (UCSR0B & _BV(UDRIE0)) && (UCSR0A & _BV(UDRE0)))
+      udre_irq();
+  }
+}
+
+void Console_Serial::tx_kick()
+{
+  written = true;
+  UCSR0B |= _BV(UDRIE0);
+}
+
+size_t Console_Serial::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t Console_Serial::write(const uint8_t *data, size_t size)
+{
+  if (policy == CONSOLE_TX_DROP && tx_free() < size)
+  {
+    dropped_count += size;
+    return 0;
+  }
+
+  for (size_t i = 0; i < size; i++)
+  {
+    uint16_t next = (tx_head + 1) & TX_MASK;
+
+    // Only reached with CONSOLE_TX_BLOCK
+    while (tx_free() == 0)
+    {
+      if (bit_is_clear(SREG, SREG_I) && (UCSR0A & _BV(UDRE0)))
+        udre_irq();
+    }
+
+    tx_buffer[tx_head] = data[i];
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+      tx_head = next;
+      tx_kick();
+    }
+  }
+
+  return size;
+}
+
+uint32_t Console_Serial::dropped()
+{
+  return dropped_count;
+}
+
+void Console_Serial::rx_irq()
+{
+  bool parity_error = UCSR0A & _BV(UPE0);
+  uint8_t c = UDR0;
+  uint8_t next = (rx_head + 1) & RX_MASK;
+
+  if (!parity_error && next != rx_tail)
+  {
+    rx_buffer[rx_head] = c;
+    rx_head = next;
+  }
+}
+
+void Console_Serial::udre_irq()
+{
+  if (tx_head == tx_tail)
+  {
+    UCSR0B &= ~_BV(UDRIE0);
+    return;
+  }
+
+  UDR0 = tx_buffer[tx_tail];
+  tx_tail = (tx_tail + 1) & TX_MASK;
+
+  // TXC0 is cleared by writing a one, flush() waits for it
+  UCSR0A = (UCSR0A & (_BV(U2X0) | _BV(MPCM0))) | _BV(TXC0);
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * @file    console_serial.h
+ * @brief   Interrupt driven console on USART0 with a large TX ring.
+ *
+ *          HardwareSerial queues only 64 bytes, so printing a sample line
+ *          blocks the loop for most of its wire time. Console_Serial owns
+ *          USART0 instead: print() copies into a CONSOLE_TX_BUFFER_SIZE ring
+ *          and returns, the UDRE interrupt sends it out in the background.
+ *
+ *          When the ring is full the policy decides:
+ *            CONSOLE_TX_DROP   the write is dropped whole and counted, the
+ *                              loop never waits on the console
+ *            CONSOLE_TX_BLOCK  the write waits for room, like Serial
+ *
+ *          It takes the USART0 vectors, so it can not be linked together
+ *          with Serial: nothing else in the sketch may use Serial while
+ *          CONSOLE_UART_ENABLED is set, print to CONSOLE instead.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _CONSOLE_SERIAL_H
+#define _CONSOLE_SERIAL_H
+
+#include <Arduino.h>
+#include "xpod_node.h"
+
+// Both sizes must be powers of two
+#define CONSOLE_TX_BUFFER_SIZE  512
+#define CONSOLE_RX_BUFFER_SIZE  64
+
+#define CONSOLE_TX_DROP         0
+#define CONSOLE_TX_BLOCK        1
+
+class Console_Serial : public Stream
+{
+  public:
+    Console_Serial();
+    void begin(unsigned long baud, uint8_t policy = CONSOLE_TX_DROP);
+    void end();
+
+    int available();
+    int peek();
+    int read();
+    int availableForWrite();
+    void flush();
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *data, size_t size);
+    using Print::write;
+
+    operator bool() { return true; }
+
+    // Bytes dropped since begin() because the ring was full
+    uint32_t dropped();
+
+    void rx_irq();
+    void udre_irq();
+
+  private:
+    uint16_t tx_free();
+    void tx_kick();
+
+    uint8_t tx_buffer[CONSOLE_TX_BUFFER_SIZE];
+    uint8_t rx_buffer[CONSOLE_RX_BUFFER_SIZE];
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
+    volatile uint8_t rx_head;
+    volatile uint8_t rx_tail;
+    uint32_t dropped_count;
+    uint8_t policy;
+    bool written;
+};
+
+#if CONSOLE_UART_ENABLED
+extern Console_Serial Console;
+#define CONSOLE Console
+#else
+#define CONSOLE Serial
+#endif
+
+inline void console_begin(unsigned long baud = CONSOLE_BAUD)
+{
+#if CONSOLE_UART_ENABLED
+  Console.begin(baud, CONSOLE_TX_POLICY);
+#else
+  Serial.begin(baud);
+#endif
+}
+
+#endif  //_CONSOLE_SERIAL_H
@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * @file    crc16.h
+ * @brief   CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection).
+ *
+ *          Shared by the firmware and the host tools. On AVR the update
+ *          step is avr-libc's _crc_xmodem_update().
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _CRC16_H
+#define _CRC16_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#endif
+
+#define CRC16_INIT            0xFFFF
+
+static inline uint16_t crc16_update(uint16_t crc, uint8_t data)
+{
+#ifdef __AVR__
+  return _crc_xmodem_update(crc, data);
+#else
+  crc ^= (uint16_t)data << 8;
+  for (uint8_t i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  return crc;
+#endif
+}
+
+static inline uint16_t crc16(const void *data, size_t size, uint16_t crc = CRC16_INIT)
+{
+  const uint8_t *p = (const uint8_t *)data;
+
+  while (size--)
+    crc = crc16_update(crc, *p++);
+
+  return crc;
+}
+
+#endif  //_CRC16_H
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * @file    csv_writer.h
+ * @brief   Column sink that writes one comma separated line to a Print.
+ *
+ *          The modules describe their columns through put_*() and skip()
+ *          calls, the writer only adds the separators. Numbers go through
+ *          the integer formatter of fixed_point.h.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _CSV_WRITER_H
+#define _CSV_WRITER_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include "fixed_point.h"
+
+class CSV_Writer
+{
+  public:
+    CSV_Writer(Print &out) : out(out), first(true) {}
+
+    void put_int(long value)
+    {
+      separator();
+      print_int(out, value);
+    }
+
+    void put_uint(unsigned long value)
+    {
+      separator();
+      print_uint(out, value);
+    }
+
+    void put_float(float value, uint8_t decimals)
+    {
+      separator();
+      print_float(out, value, decimals);
+    }
+
+    // value is already scaled by 10^decimals
+    void put_fixed(long value, uint8_t decimals)
+    {
+      separator();
+      print_fixed(out, value, decimals);
+    }
+
+    void put_str(const char *value)
+    {
+      separator();
+      out.print(value);
+    }
+
+    void put_time(const DateTime &value)
+    {
+      char timestamp[] = "YYYY-MM-DDThh:mm:ss";
+
+      separator();
+      out.print(value.toString(timestamp));
+    }
+
+    // Empty column of a missing reading
+    void skip()
+    {
+      separator();
+    }
+
+    // Empty columns of a module that is not built
+    void disabled(uint8_t columns)
+    {
+      for (uint8_t i = 0; i < columns; i++)
+        skip();
+    }
+
+  private:
+    void separator()
+    {
+      if (!first)
+        out.print(',');
+      first = false;
+    }
+
+    Print &out;
+    bool first;
+};
+
+#endif  //_CSV_WRITER_H
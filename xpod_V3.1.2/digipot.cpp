@@ -94,3 +94,62 @@ void SetPotLevel(int Pot_Num,int level){
   }
   digitalWrite(potvar[Pot_Num].cs, HIGH);
 }
+
+struct pot_job{
+  int pot;
+  int level;
+};
+
+pot_job pot_jobs[NUM_POTS];
+int pot_job_count = 0;
+int pot_job_index = 0;
+// Clock edges done of the current job, 256 down then 2 * level up
+int pot_edge = 0;
+unsigned long pot_edge_us = 0;
+
+void QueuePotLevel(int Pot_Num,int level){
+  if(pot_job_count < NUM_POTS){
+    pot_jobs[pot_job_count].pot = Pot_Num;
+    pot_jobs[pot_job_count].level = level;
+    pot_job_count++;
+  }
+}
+
+bool PotsDone(){
+  return pot_job_index == pot_job_count;
+}
+
+bool ServicePots(){
+  if(pot_job_index == pot_job_count){
+    return true;
+  }
+  if(micros() - pot_edge_us < 1000){
+    return false;
+  }
+  pot_edge_us = micros();
+
+  pot &p = potvar[pot_jobs[pot_job_index].pot];
+  int edges = 2 * (128 + pot_jobs[pot_job_index].level);
+
+  if(pot_edge == edges){
+    digitalWrite(p.cs, HIGH);
+    pot_edge = 0;
+    pot_job_index++;
+    return pot_job_index == pot_job_count;
+  }
+
+  if(pot_edge == 0){
+    digitalWrite(p.cs, LOW);
+    digitalWrite(p.ud, LOW);
+  }
+  else if(pot_edge == 256){
+    // Down at zero-scale, count up from there
+    digitalWrite(p.cs, HIGH);
+    digitalWrite(p.cs, LOW);
+    digitalWrite(p.ud, HIGH);
+  }
+
+  digitalWrite(p.clk, pot_edge % 2 ? HIGH : LOW);
+  pot_edge++;
+  return false;
+}
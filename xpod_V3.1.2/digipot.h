@@ -20,4 +20,14 @@ void DownPot(int Pot_Num);
 
 void UpPot(int Pot_Num);
 
-void SetPotLevel(int Pot_Num,int level);
\ No newline at end of file
+void SetPotLevel(int Pot_Num,int level);
+
+// SetPotLevel() without the delays: QueuePotLevel() adds it to a list that
+// ServicePots() clocks out one edge at a time, a millisecond apart as in
+// SetPotLevel(). ServicePots() returns true once the list is done.
+void QueuePotLevel(int Pot_Num,int level);
+
+bool ServicePots();
+
+// True once ServicePots() has set every queued level
+bool PotsDone();
\ No newline at end of file
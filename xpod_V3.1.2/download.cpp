@@ -0,0 +1,257 @@
+/*******************************************************************************
+ * @file    download.cpp
+ * @brief   Log download over the serial console while the pod samples.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "download.h"
+#include "bin_log.h"
+#include "console_serial.h"
+#include "paced_print.h"
+#include "telemetry.h"
+
+enum
+{
+  IDLE,
+  LISTING,
+  READING
+};
+
+static void put_le32(Print &out, uint32_t value)
+{
+  for (uint8_t i = 0; i < 4; i++)
+    out.write((uint8_t)(value >> (8 * i)));
+}
+
+Download_Server::Download_Server(SdFat &sd, Stream &console, uint8_t *buffer)
+    : sd(sd), console(console), buffer(buffer)
+{
+  line_len = 0;
+  discard = false;
+  state = IDLE;
+  baud = CONSOLE_BAUD;
+  session = false;
+  last_activity = 0;
+}
+
+bool Download_Server::receive(char c)
+{
+  // strchr() also finds the terminator, so a NUL is not a command letter
+  if (line_len == 0 && !discard && (c == '\0' || !strchr("BLRQ", c)))
+    return false;
+
+  if (c == '\r' || c == '\n')
+  {
+    line[line_len] = '\0';
+    if (!discard)
+      command();
+    line_len = 0;
+    discard = false;
+  }
+  // A line that does not fit is no command
+  else if (line_len < sizeof(line) - 1)
+    line[line_len++] = c;
+  else
+    discard = true;
+
+  return true;
+}
+
+void Download_Server::command()
+{
+  Paced_Print out(console);
+  Telemetry_Frame frame(out);
+
+  session = true;
+  last_activity = millis();
+
+  switch (line[0])
+  {
+    case 'B':
+      frame.begin(DOWNLOAD_SESSION);
+      put_le32(frame, DOWNLOAD_BAUD);
+      frame.end();
+      set_baud(DOWNLOAD_BAUD);
+      break;
+
+    case 'L':
+      list();
+      break;
+
+    case 'R':
+    {
+      // R name offset [length]
+      char *name = strtok(line + 1, " ");
+      char *offset = strtok(NULL, " ");
+      char *length = strtok(NULL, " ");
+
+      read(name, offset ? strtoul(offset, NULL, 10) : 0,
+           length ? strtoul(length, NULL, 10) : 0xFFFFFFFFUL);
+      break;
+    }
+
+    case 'Q':
+      file.close();
+      dir.close();
+      state = IDLE;
+      session = false;
+      set_baud(CONSOLE_BAUD);
+      break;
+  }
+}
+
+void Download_Server::list()
+{
+  file.close();
+  dir.close();
+  entries = 0;
+  state = dir.open("/", O_RDONLY) ? LISTING : IDLE;
+  if (state == IDLE)
+    send_end(DOWNLOAD_READ_ERROR, 0);
+}
+
+void Download_Server::read(const char *name, uint32_t offset, uint32_t length)
+{
+  file.close();
+  dir.close();
+  state = IDLE;
+
+  if (!name || !file.open(name, O_RDONLY) || !file.isFile())
+  {
+    file.close();
+    send_end(DOWNLOAD_NO_FILE, 0);
+    return;
+  }
+
+  // The size as of now, a log that grows meanwhile is sent up to here. A
+  // binary log ends at its data, not at its preallocation.
+  size = Bin_Log::data_end(file);
+  position = offset < size ? offset : size;
+  if (length < size - position)
+    size = position + length;
+  contiguous = file.contiguousRange(&first_sector, NULL);
+  state = READING;
+}
+
+bool Download_Server::active()
+{
+  if (session && millis() - last_activity >= DOWNLOAD_IDLE_MS)
+  {
+    // The host is gone
+    file.close();
+    dir.close();
+    state = IDLE;
+    session = false;
+    set_baud(CONSOLE_BAUD);
+  }
+
+  return session;
+}
+
+bool Download_Server::service(unsigned long budget_ms)
+{
+  if (!active() || state == IDLE || !fits(budget_ms, DOWNLOAD_FRAME_BOUND))
+    return false;
+
+  last_activity = millis();
+  return state == LISTING ? send_entry() : send_block();
+}
+
+// One 'F' frame per file, hidden ones and directories are left out
+bool Download_Server::send_entry()
+{
+  SdFile entry;
+
+  while (entry.openNext(&dir, O_RDONLY))
+  {
+    if (entry.isFile() && !entry.isHidden())
+    {
+      Paced_Print out(console);
+      Telemetry_Frame frame(out);
+      size_t length = entry.getName((char *)buffer, DOWNLOAD_BLOCK_SIZE);
+
+      frame.begin(DOWNLOAD_FILE);
+      put_le32(frame, Bin_Log::data_end(entry));
+      frame.write(buffer, length);
+      frame.end();
+      entries++;
+      return true;
+    }
+    entry.close();
+  }
+
+  dir.close();
+  state = IDLE;
+  send_end(DOWNLOAD_OK, entries);
+  return true;
+}
+
+bool Download_Server::send_block()
+{
+  if (position >= size)
+  {
+    file.close();
+    state = IDLE;
+    send_end(DOWNLOAD_OK, size);
+    return true;
+  }
+
+  uint32_t base = position & ~(uint32_t)(DOWNLOAD_BLOCK_SIZE - 1);
+  uint16_t skip = position - base;
+  uint16_t length = size - base < DOWNLOAD_BLOCK_SIZE ? size - base : DOWNLOAD_BLOCK_SIZE;
+  bool ok;
+
+  // Whole aligned sectors, SdFat reads them into `buffer` without its cache
+  if (contiguous)
+    ok = sd.card()->readSectors(first_sector + base / 512, buffer, 1);
+  else
+    ok = file.seekSet(base) && file.read(buffer, length) == length;
+
+  if (!ok)
+  {
+    file.close();
+    state = IDLE;
+    send_end(DOWNLOAD_READ_ERROR, position);
+    return true;
+  }
+
+  Paced_Print out(console);
+  Telemetry_Frame frame(out);
+
+  frame.begin(DOWNLOAD_BLOCK);
+  put_le32(frame, position);
+  frame.write(buffer + skip, length - skip);
+  frame.end();
+
+  position = base + length;
+  return true;
+}
+
+void Download_Server::send_end(uint8_t status, uint32_t value)
+{
+  Paced_Print out(console);
+  Telemetry_Frame frame(out);
+
+  frame.begin(DOWNLOAD_END);
+  frame.write(status);
+  put_le32(frame, value);
+  frame.end();
+}
+
+// The frames in the TX ring go out at the old rate first
+void Download_Server::set_baud(unsigned long baud)
+{
+  if (baud == this->baud)
+    return;
+
+  console.flush();
+  console_begin(baud);
+  this->baud = baud;
+}
+
+// Wire time of `bytes` at 10 bits a byte, with a millisecond to spare
+bool Download_Server::fits(unsigned long budget_ms, uint16_t bytes)
+{
+  return (uint32_t)bytes * 10000UL / baud + 1 <= budget_ms;
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * @file    download.h
+ * @brief   Log download over the serial console while the pod samples.
+ *
+ *          The host sends command lines, the pod answers in the frames of
+ *          telemetry.h (0x00 | COBS(version | type | payload | crc16) | 0x00):
+ *
+ *            B              'A' baud: the console moves to DOWNLOAD_BAUD
+ *                           after this frame, until Q or DOWNLOAD_IDLE_MS
+ *                           without a command or a frame
+ *            L              'F' size name for every file of the root
+ *                           directory, then 'E' 0 count
+ *            R name offset [length]
+ *                           'B' offset data for the file from offset on,
+ *                           up to length bytes, a frame per sector, then
+ *                           'E' status end
+ *            Q              ends the session, the console goes back to
+ *                           CONSOLE_BAUD
+ *
+ *          Numbers are little-endian uint32, the status of 'E' a uint8
+ *          (DOWNLOAD_OK ...). A file is sent up to its size when R came; a
+ *          frame that fails its CRC or leaves a gap is fetched again with
+ *          R from the last good offset, which is also how a broken
+ *          transfer resumes. The size of a binary log is where its data
+ *          ended at its last sync, the preallocation after it is left out;
+ *          its header changes as it grows.
+ *
+ *          Frames go out from the idle part of the cycle, one sector at a
+ *          time and only when it fits before the next sample is due, and
+ *          the sample text is muted while a session is open. Sectors of a
+ *          contiguous file (a preallocated binary log, mostly) are read
+ *          straight from the card, others through the file.
+ *
+ *          tools/xpod_download.cpp mirrors the card into a directory.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _DOWNLOAD_H
+#define _DOWNLOAD_H
+
+#include <Arduino.h>
+#include <SdFat.h>
+
+#define DOWNLOAD_SESSION      'A'
+#define DOWNLOAD_FILE         'F'
+#define DOWNLOAD_BLOCK        'B'
+#define DOWNLOAD_END          'E'
+
+#define DOWNLOAD_OK           0
+#define DOWNLOAD_NO_FILE      1
+#define DOWNLOAD_READ_ERROR   2
+
+// A block frame is a sector and its offset, COBS adds a byte per 254
+#define DOWNLOAD_BLOCK_SIZE   512
+#define DOWNLOAD_FRAME_BOUND  (DOWNLOAD_BLOCK_SIZE + 16)
+#define DOWNLOAD_MAX_COMMAND  64
+
+class Download_Server
+{
+  public:
+    // `buffer` of DOWNLOAD_BLOCK_SIZE bytes is only used inside service()
+    Download_Server(SdFat &sd, Stream &console, uint8_t *buffer);
+
+    // Takes a character of a command line, false if it starts none
+    bool receive(char c);
+
+    // Sends the next frame if it goes out within `budget_ms`, true if it
+    // did
+    bool service(unsigned long budget_ms);
+
+    // True from the first command to Q, or until nothing was received or
+    // sent for DOWNLOAD_IDLE_MS
+    bool active();
+
+  private:
+    void command();
+    void list();
+    void read(const char *name, uint32_t offset, uint32_t length);
+    bool send_entry();
+    bool send_block();
+    void send_end(uint8_t status, uint32_t value);
+    void set_baud(unsigned long baud);
+    bool fits(unsigned long budget_ms, uint16_t bytes);
+
+    SdFat &sd;
+    Stream &console;
+    uint8_t *buffer;
+
+    char line[DOWNLOAD_MAX_COMMAND];
+    uint8_t line_len;
+    bool discard;
+
+    uint8_t state;
+    SdBaseFile dir;
+    SdFile file;
+    uint32_t entries;
+    uint32_t position;
+    uint32_t size;
+    uint32_t first_sector;
+    bool contiguous;
+
+    unsigned long baud;
+    bool session;
+    unsigned long last_activity;
+};
+
+#endif  //_DOWNLOAD_H
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * @file    fixed_point.cpp
+ * @brief   Integer-only number to text conversion for log columns.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <SdFat.h>
+#include "common/FmtNumber.h"
+#include "fixed_point.h"
+
+static const uint32_t fixed_scale[FIXED_MAX_DECIMALS + 1] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000
+};
+
+// Largest integer part that still fits in an int32_t once scaled
+static const uint32_t fixed_limit[FIXED_MAX_DECIMALS + 1] = {
+  2147483519, 214748363, 21474835, 2147482, 214747, 21473, 2146
+};
+
+// Writes value / 10^decimals to buf, which holds FIXED_MAX_CHARS bytes
+size_t fmt_fixed(char *buf, int32_t value, uint8_t decimals)
+{
+  char digits[10];
+  char *end = digits + sizeof(digits);
+  char *out = buf;
+  uint32_t mag = value < 0 ? -(uint32_t)value : value;
+
+  if (decimals > FIXED_MAX_DECIMALS)
+    decimals = FIXED_MAX_DECIMALS;
+
+  char *str = fmtBase10(end, mag);
+  uint8_t len = end - str;
+
+  if (value < 0)
+    *out++ = '-';
+
+  if (len > decimals)
+  {
+    memcpy(out, str, len - decimals);
+    out += len - decimals;
+    str += len - decimals;
+    len = decimals;
+  }
+  else
+  {
+    *out++ = '0';
+  }
+
+  if (decimals)
+  {
+    *out++ = '.';
+    for (uint8_t pad = decimals - len; pad; pad--)
+      *out++ = '0';
+    memcpy(out, str, len);
+    out += len;
+  }
+
+  *out = '\0';
+
+  return out - buf;
+}
+
+size_t fmt_unsigned(char *buf, uint32_t value)
+{
+  char digits[10];
+  char *end = digits + sizeof(digits);
+  char *str = fmtBase10(end, value);
+  uint8_t len = end - str;
+
+  memcpy(buf, str, len);
+  buf[len] = '\0';
+
+  return len;
+}
+
+// Rounds value * 10^decimals, false when it does not fit in 32 bits.
+// Only the fraction is scaled in float, so the integer part loses no digits.
+bool to_fixed(float value, uint8_t decimals, int32_t &fixed)
+{
+  if (decimals > FIXED_MAX_DECIMALS)
+    decimals = FIXED_MAX_DECIMALS;
+
+  float mag = fabs(value);
+
+  // Also false for NaN, every comparison with it fails
+  if (!(mag < fixed_limit[decimals]))
+    return false;
+
+  uint32_t whole = (uint32_t)mag;
+  uint32_t frac = (uint32_t)((mag - whole) * fixed_scale[decimals] + 0.5);
+  int32_t scaled = whole * fixed_scale[decimals] + frac;
+
+  fixed = value < 0 ? -scaled : scaled;
+
+  return true;
+}
+
+size_t print_fixed(Print &out, int32_t value, uint8_t decimals)
+{
+  char buf[FIXED_MAX_CHARS];
+
+  return out.write(buf, fmt_fixed(buf, value, decimals));
+}
+
+// Same text as Print::print(value, decimals) for values that fit
+size_t print_float(Print &out, float value, uint8_t decimals)
+{
+  int32_t fixed;
+
+  if (isnan(value))
+    return out.print(F("nan"));
+  if (isinf(value))
+    return out.print(F("inf"));
+  // Beyond 32 bits of fixed point Print's float digits take over, up to
+  // its own "ovf"
+  if (!to_fixed(value, decimals, fixed))
+    return out.print(value, decimals);
+
+  // -0.001 at 2 decimals still prints its sign, as Print does
+  if (fixed == 0 && value < 0)
+    out.print('-');
+
+  return print_fixed(out, fixed, decimals);
+}
+
+size_t print_int(Print &out, int32_t value)
+{
+  return print_fixed(out, value, 0);
+}
+
+size_t print_uint(Print &out, uint32_t value)
+{
+  char buf[FIXED_MAX_CHARS];
+
+  return out.write(buf, fmt_unsigned(buf, value));
+}
@@ -0,0 +1,31 @@
+/*******************************************************************************
+ * @file    fixed_point.h
+ * @brief   Integer-only number to text conversion for log columns.
+ *
+ *          A reading is scaled once to an integer with a fixed number of
+ *          decimals, e.g. 23.456 C at 2 decimals is 2346, and printed with
+ *          SdFat's fmtBase10(). Print::print(float) instead runs a soft-float
+ *          multiply and subtract for every digit.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _FIXED_POINT_H
+#define _FIXED_POINT_H
+
+#include <Arduino.h>
+
+#define FIXED_MAX_DECIMALS    6
+// Sign, 10 digits, point, leading fraction zeros and the '\0'
+#define FIXED_MAX_CHARS       (1 + 10 + 1 + FIXED_MAX_DECIMALS + 1)
+
+size_t fmt_fixed(char *buf, int32_t value, uint8_t decimals);
+size_t fmt_unsigned(char *buf, uint32_t value);
+bool to_fixed(float value, uint8_t decimals, int32_t &fixed);
+
+size_t print_fixed(Print &out, int32_t value, uint8_t decimals);
+size_t print_float(Print &out, float value, uint8_t decimals);
+size_t print_int(Print &out, int32_t value);
+size_t print_uint(Print &out, uint32_t value);
+
+#endif  //_FIXED_POINT_H
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * @file    format_bench.cpp
+ * @brief   Microbenchmark of the log column formatters.
+ *
+ *          Formats a set of typical column values into a sink that drops
+ *          the text, once with Print::print() and once with the fixed-point
+ *          formatter, and reports CPU cycles per column for both.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "format_bench.h"
+#include "fixed_point.h"
+
+// Counts the bytes, so only the formatting is timed
+class Null_Print : public Print
+{
+  public:
+    Null_Print() : count(0) {}
+    size_t write(uint8_t c) { count++; return 1; }
+    size_t write(const uint8_t *data, size_t size) { count += size; return size; }
+    using Print::write;
+
+    uint32_t count;
+};
+
+// Figaro volts, BME temperature, pressure and humidity, OPC sp/sfr/PM
+static const float bench_floats[] = {
+  1.2345, 0.0871, 23.45, 1013.25, 45.67, 5.20, 2.71, 12.34, -999.0, 0.0
+};
+
+// ADS raw counts, CO2 ppm, QUAD counts, PMS counts
+static const long bench_ints[] = {
+  12345, 64537, 415, -3021, 123456, 0, 17, 2048, -999, 30000
+};
+
+#define BENCH_COUNT(a)  (sizeof(a) / sizeof((a)[0]))
+
+static void report(Print &out, const __FlashStringHelper *name, uint32_t us, uint32_t columns, uint32_t bytes)
+{
+  out.print(name);
+  out.print(F(": "));
+  out.print(us * (F_CPU / 1000000UL) / columns);
+  out.print(F(" cycles/column, "));
+  out.print(bytes);
+  out.println(F(" bytes"));
+}
+
+void run_format_bench(Print &out)
+{
+  Null_Print sink;
+  uint32_t start;
+  uint32_t floats = FORMAT_BENCH_ROUNDS * BENCH_COUNT(bench_floats);
+  uint32_t ints = FORMAT_BENCH_ROUNDS * BENCH_COUNT(bench_ints);
+
+  out.println(F("Column formatting benchmark"));
+
+  sink.count = 0;
+  start = micros();
+  for (uint8_t r = 0; r < FORMAT_BENCH_ROUNDS; r++)
+    for (uint8_t i = 0; i < BENCH_COUNT(bench_floats); i++)
+      sink.print(bench_floats[i], 2);
+  report(out, F("print(float)  "), micros() - start, floats, sink.count);
+
+  sink.count = 0;
+  start = micros();
+  for (uint8_t r = 0; r < FORMAT_BENCH_ROUNDS; r++)
+    for (uint8_t i = 0; i < BENCH_COUNT(bench_floats); i++)
+      print_float(sink, bench_floats[i], 2);
+  report(out, F("print_float() "), micros() - start, floats, sink.count);
+
+  sink.count = 0;
+  start = micros();
+  for (uint8_t r = 0; r < FORMAT_BENCH_ROUNDS; r++)
+    for (uint8_t i = 0; i < BENCH_COUNT(bench_ints); i++)
+      sink.print(bench_ints[i]);
+  report(out, F("print(long)   "), micros() - start, ints, sink.count);
+
+  sink.count = 0;
+  start = micros();
+  for (uint8_t r = 0; r < FORMAT_BENCH_ROUNDS; r++)
+    for (uint8_t i = 0; i < BENCH_COUNT(bench_ints); i++)
+      print_int(sink, bench_ints[i]);
+  report(out, F("print_int()   "), micros() - start, ints, sink.count);
+}
@@ -0,0 +1,17 @@
+/*******************************************************************************
+ * @file    format_bench.h
+ * @brief   Microbenchmark of the log column formatters.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _FORMAT_BENCH_H
+#define _FORMAT_BENCH_H
+
+#include <Arduino.h>
+
+#define FORMAT_BENCH_ROUNDS   50
+
+void run_format_bench(Print &out);
+
+#endif  //_FORMAT_BENCH_H
@@ -6,103 +6,99 @@
  * @date 	  May 25, 2023
  ******************************************************************************/
 #include "gps_module.h"
+#include "fixed_point.h"
 
-#include <SoftwareSerial.h>
-#define ARDUINO_GPS_RX 9 // GPS TX, Arduino RX pin
-#define ARDUINO_GPS_TX 8 // GPS RX, Arduino TX pin
+const char GPS_Module::name[] PROGMEM = "GPS";
+const char GPS_Module::header[] PROGMEM =
+  "Latitude,Longitude,feet,degree,mph,sat_val(gps),time,date";
 
-SoftwareSerial ssGPS(ARDUINO_GPS_TX, ARDUINO_GPS_RX);
-
-GPS_Module::GPS_Module()
+GPS_Module::GPS_Module() : ssGPS(ARDUINO_GPS_TX, ARDUINO_GPS_RX)
 {
   gps_status = false;
 }
 
-int GPS_Module::begin()
+bool GPS_Module::begin()
 {
   ssGPS.begin(GPS_BAUDRATE);
 
+  // No NMEA text, the registry reports the failure
   if (millis() > 5000 && tinyGps.charsProcessed() < 10)
-  {
-    Serial.println("No GPS module detected: check wiring.");
     return gps_status;
-  }
   gps_status = true;
   return gps_status;
 }
 
-String GPS_Module::get_gps_info_serial()
+int8_t GPS_Module::warm()
 {
-  String gps_data;
+  return 1;
+}
 
-  if (!gps_status)
-    return "\0";
-  // Print latitude, longitude, altitude in feet, course, speed, date, time,
-  // and the number of visible satellites.
-  char c = Serial.read();
+void GPS_Module::start()
+{
+}
+
+// Feeds whatever NMEA text arrived since the last cycle to the parser
+bool GPS_Module::poll()
+{
   while (ssGPS.available() > 0)
     tinyGps.encode(ssGPS.read());
-  if (tinyGps.location.isValid())
-  {
-    gps_data+= ("LAT:" + String(tinyGps.location.lat()));
-    gps_data+=("Long:" + String(tinyGps.location.lng()));
-  }
-  else
-  {
-    Serial.println("INVALID LOCATION");
-  }
-  gps_data+=("Alt:"+ String(tinyGps.altitude.feet()));
-  gps_data+=("Course:"+String(tinyGps.course.deg()));
-  gps_data+=("Speed:"+ String(tinyGps.speed.mph()));
-  gps_data+=("Sats:"+ String(tinyGps.satellites.value())); //Check what this does
-  delay(100);
-  
-  return gps_data;
 
+  return true;
 }
-String GPS_Module::get_gps_info_sd()
+
+void GPS_Module::abort()
 {
-  String gps_data;
+}
 
-  if (!gps_status)
-    return "\0";
-  // Print latitude, longitude, altitude in feet, course, speed, date, time,
-  // and the number of visible satellites.
-  char c = Serial.read();
-  while (ssGPS.available() > 0)
-    tinyGps.encode(ssGPS.read());
-  if (tinyGps.location.isValid())
-  {
-    gps_data+= (String(tinyGps.location.lat())+",");
-    gps_data+=(String(tinyGps.location.lng())+",");
+bool GPS_Module::collect(gps_sample_t &sample)
+{
+  gps_sample_t *gps = &sample;
 
-  gps_data+=(String(tinyGps.altitude.feet())+",");
-  gps_data+=(String(tinyGps.course.deg())+",");
-  gps_data+=(String(tinyGps.speed.mph())+",");
-  gps_data+=(String(tinyGps.satellites.value())+","); //Check what this does
-  delay(100);
-  }
-  return gps_data;
+  gps->status = gps_status;
+  gps->location_valid = tinyGps.location.isValid();
+  gps->lat = tinyGps.location.lat();
+  gps->lng = tinyGps.location.lng();
+  gps->alt_ft = tinyGps.altitude.feet();
+  gps->course_deg = tinyGps.course.deg();
+  gps->speed_mph = tinyGps.speed.mph();
+  gps->satellites = tinyGps.satellites.value();
+
+  gps->time_valid = tinyGps.time.isValid();
+  gps->hour = tinyGps.time.hour();
+  gps->minute = tinyGps.time.minute();
+  gps->second = tinyGps.time.second();
 
+  gps->date_valid = tinyGps.date.isValid();
+  gps->day = tinyGps.date.day();
+  gps->month = tinyGps.date.month();
+  gps->year = tinyGps.date.year();
+
+  return gps_status;
 }
 
-String GPS_Module::get_gps_dtinfo(){
-  char TimeDate[]  = "00:00:00,00/00/2000";  //Double check on what time it displays
-  if (tinyGps.time.isValid()) {
-        TimeDate[0]  = tinyGps.time.hour()   / 10 + 48;
-        TimeDate[1]  = tinyGps.time.hour()   % 10 + 48;
-        TimeDate[3]  = tinyGps.time.minute() / 10 + 48;
-        TimeDate[4]  = tinyGps.time.minute() % 10 + 48;
-        TimeDate[6] = tinyGps.time.second() / 10 + 48;
-        TimeDate[7] = tinyGps.time.second() % 10 + 48;
+void GPS_Module::read4print(const gps_sample_t &sample, Print &out)
+{
+  if (!sample.status)
+    return;
+  // Print latitude, longitude, altitude in feet, course, speed, date, time,
+  // and the number of visible satellites.
+  if (sample.location_valid)
+  {
+    out.print(F("LAT:"));
+    print_float(out, sample.lat, 2);
+    out.print(F("Long:"));
+    print_float(out, sample.lng, 2);
   }
-  if (tinyGps.date.isValid()){
-        TimeDate[9]  = tinyGps.date.day()    / 10 + 48;
-        TimeDate[10]  = tinyGps.date.day()    % 10 + 48;
-        TimeDate[12]  = tinyGps.date.month()  / 10 + 48;
-        TimeDate[13]  = tinyGps.date.month()  % 10 + 48;
-        TimeDate[15] =(tinyGps.date.year()   / 10) % 10 + 48;
-        TimeDate[16] = tinyGps.date.year()   % 10 + 48;
+  else
+  {
+    out.print(F("INVALID LOCATION,"));
   }
-  return TimeDate;
+  out.print(F("Alt:"));
+  print_float(out, sample.alt_ft, 2);
+  out.print(F("Course:"));
+  print_float(out, sample.course_deg, 2);
+  out.print(F("Speed:"));
+  print_float(out, sample.speed_mph, 2);
+  out.print(F("Sats:"));
+  print_uint(out, sample.satellites); //Check what this does
 }
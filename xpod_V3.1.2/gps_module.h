@@ -10,21 +10,102 @@
 
 #include <Arduino.h>
 #include <TinyGPSPlus.h>
+#include <SoftwareSerial.h>
 
 #define GPS_BAUDRATE  (9600) 
+#define GPS_BUDGET_MS (100)
+#define ARDUINO_GPS_RX 9 // GPS TX, Arduino RX pin
+#define ARDUINO_GPS_TX 8 // GPS RX, Arduino TX pin
+
+struct gps_sample_t
+{
+    bool status;
+    bool location_valid;
+    double lat;
+    double lng;
+    double alt_ft;
+    double course_deg;
+    double speed_mph;
+    uint32_t satellites;
+    bool time_valid;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    bool date_valid;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+};
 
 class GPS_Module {
   public:
+    typedef gps_sample_t sample_type;
+
+    static const uint8_t column_count = 8;
+    static const uint16_t budget_ms = GPS_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     GPS_Module();
-    int begin();
-    String get_gps_info();
-    String get_gps_dtinfo();
-    String get_gps_info_sd();
-    String get_gps_info_serial();
+    bool begin();
+    int8_t warm();
+    void start();
+    bool poll();
+    bool collect(gps_sample_t &sample);
+    void abort();
+    void read4print(const gps_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const gps_sample_t &sample, Sink &sink);
   private:
 
     bool gps_status;
+    SoftwareSerial ssGPS;
     TinyGPSPlus tinyGps;
 };
 
+template <class Sink>
+void GPS_Module::columns(const gps_sample_t &sample, Sink &sink)
+{
+  char time_str[] = "00:00:00";
+  char date_str[] = "00/00/2000";
+
+  if (sample.status && sample.location_valid)
+  {
+    sink.put_float(sample.lat, 2);
+    sink.put_float(sample.lng, 2);
+    sink.put_float(sample.alt_ft, 2);
+    sink.put_float(sample.course_deg, 2);
+    sink.put_float(sample.speed_mph, 2);
+    sink.put_uint(sample.satellites);
+  }
+  else
+  {
+    for (uint8_t i = 0; i < 6; i++)
+      sink.skip();
+  }
+
+  if (sample.time_valid)
+  {
+    time_str[0] = sample.hour / 10 + '0';
+    time_str[1] = sample.hour % 10 + '0';
+    time_str[3] = sample.minute / 10 + '0';
+    time_str[4] = sample.minute % 10 + '0';
+    time_str[6] = sample.second / 10 + '0';
+    time_str[7] = sample.second % 10 + '0';
+  }
+  if (sample.date_valid)
+  {
+    date_str[0] = sample.day / 10 + '0';
+    date_str[1] = sample.day % 10 + '0';
+    date_str[3] = sample.month / 10 + '0';
+    date_str[4] = sample.month % 10 + '0';
+    date_str[8] = (sample.year / 10) % 10 + '0';
+    date_str[9] = sample.year % 10 + '0';
+  }
+
+  sink.put_str(time_str);
+  sink.put_str(date_str);
+}
+
 #endif 
\ No newline at end of file
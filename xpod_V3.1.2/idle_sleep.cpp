@@ -0,0 +1,31 @@
+/*******************************************************************************
+ * @file    idle_sleep.cpp
+ * @brief   Sleeps through the idle part of a cycle.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "idle_sleep.h"
+
+void Idle_Sleep::sleep()
+{
+  unsigned long from = micros();
+
+  wdt_reset();
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+
+  slept += micros() - from;
+}
+
+uint32_t Idle_Sleep::take_slept_us()
+{
+  uint32_t value = slept;
+
+  slept = 0;
+  return value;
+}
@@ -0,0 +1,39 @@
+/*******************************************************************************
+ * @file    idle_sleep.h
+ * @brief   Sleeps through the idle part of a cycle.
+ *
+ *          SLEEP_MODE_IDLE only stops the CPU clock: Timer0 (millis()), the
+ *          UART receivers and the external interrupts keep running and
+ *          wake it, so the pacing, the console and the RTC SQW and wind
+ *          interrupts work as before. The deeper modes stop Timer0 or the
+ *          UART clock and are of no use here.
+ *
+ *          Timer0 overflows every 1.024 ms, a sleep never lasts longer. An
+ *          interrupt that comes between the caller's check and sleep_cpu()
+ *          therefore costs at most that. The watchdog is reset on every
+ *          wake-up, a loop period longer than its timeout is safe.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _IDLE_SLEEP_H
+#define _IDLE_SLEEP_H
+
+#include <Arduino.h>
+
+class Idle_Sleep
+{
+  public:
+    Idle_Sleep() : slept(0) {}
+
+    // Until the next interrupt
+    void sleep();
+
+    // Microseconds spent asleep since the last call
+    uint32_t take_slept_us();
+
+  private:
+    uint32_t slept;
+};
+
+#endif  //_IDLE_SLEEP_H
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * @file    line_buffer.cpp
+ * @brief   Print that formats into a fixed, caller owned char buffer.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "line_buffer.h"
+
+Line_Buffer::Line_Buffer(char *buffer, uint16_t size)
+{
+  this->buffer = buffer;
+  this->size = size;
+  clear();
+}
+
+size_t Line_Buffer::write(uint8_t c)
+{
+  // One byte is kept for the terminating '\0'
+  if (len + 1 >= size)
+  {
+    overflow = true;
+    return 0;
+  }
+
+  buffer[len++] = c;
+  buffer[len] = '\0';
+
+  return 1;
+}
+
+size_t Line_Buffer::write(const uint8_t *data, size_t count)
+{
+  size_t room = size - 1 - len;
+
+  if (count > room)
+  {
+    overflow = true;
+    count = room;
+  }
+
+  memcpy(buffer + len, data, count);
+  len += count;
+  buffer[len] = '\0';
+
+  return count;
+}
+
+void Line_Buffer::clear()
+{
+  len = 0;
+  overflow = false;
+  if (size)
+    buffer[0] = '\0';
+}
+
+const char *Line_Buffer::c_str()
+{
+  return buffer;
+}
+
+uint16_t Line_Buffer::length()
+{
+  return len;
+}
+
+bool Line_Buffer::overflowed()
+{
+  return overflow;
+}
@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * @file    line_buffer.h
+ * @brief   Print that formats into a fixed, caller owned char buffer.
+ *
+ *          Replaces String concatenation on the sampling path: a line is
+ *          built in static storage and written out with a single write(),
+ *          nothing is allocated on the heap. Text that does not fit is
+ *          dropped and reported by overflowed().
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _LINE_BUFFER_H
+#define _LINE_BUFFER_H
+
+#include <Arduino.h>
+
+#define LINE_BUFFER_SIZE      512
+
+class Line_Buffer : public Print
+{
+  public:
+    Line_Buffer(char *buffer, uint16_t size);
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *data, size_t size);
+    using Print::write;
+
+    void clear();
+    const char *c_str();
+    uint16_t length();
+    bool overflowed();
+
+  private:
+    char *buffer;
+    uint16_t size;
+    uint16_t len;
+    bool overflow;
+};
+
+#endif  //_LINE_BUFFER_H
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * @file    log_index.cpp
+ * @brief   Sparse time index next to each daily CSV log.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "log_index.h"
+#include "xpod_node.h"
+
+// The log's name with .idx in place of its extension
+bool Log_Index::index_name(const char *log_name, char *name, uint8_t size)
+{
+  const char *dot = strrchr(log_name, '.');
+  uint8_t stem = dot ? dot - log_name : strlen(log_name);
+
+  if (stem + 5 > size)
+    return false;
+
+  memcpy(name, log_name, stem);
+  strcpy(name + stem, ".idx");
+  return true;
+}
+
+bool Log_Index::read_entry(SdBaseFile &index, uint32_t i, log_index_entry_t &entry)
+{
+  return index.seekSet(i * sizeof(entry)) &&
+         index.read(&entry, sizeof(entry)) == (int)sizeof(entry);
+}
+
+bool Log_Index::open(const char *log_name, uint32_t log_size)
+{
+  char name[32];
+  log_index_entry_t entry;
+
+  last_time = 0;
+  if (!index_name(log_name, name, sizeof(name)) ||
+      !file.open(name, O_CREAT | O_APPEND | O_RDWR))
+    return false;
+
+  // Entries are in offset order, the ones past the log go from the end.
+  // A torn entry goes with them.
+  uint32_t entries = file.fileSize() / sizeof(entry);
+
+  while (entries > 0)
+  {
+    if (!read_entry(file, entries - 1, entry))
+      break;
+    if (entry.offset < log_size)
+    {
+      last_time = entry.time;
+      break;
+    }
+    entries--;
+  }
+
+  if (file.fileSize() != entries * sizeof(entry))
+    file.truncate(entries * sizeof(entry));
+  return file.seekSet(file.fileSize());
+}
+
+bool Log_Index::add(uint32_t time, uint32_t offset, uint32_t seq)
+{
+  if (!file.isOpen() || time < last_time ||
+      (last_time != 0 && time / LOG_INDEX_SECONDS == last_time / LOG_INDEX_SECONDS))
+    return true;
+
+  log_index_entry_t entry = {time, offset, seq};
+
+  last_time = time;
+  return file.write(&entry, sizeof(entry)) == sizeof(entry);
+}
+
+bool Log_Index::sync()
+{
+  return !file.isOpen() || file.sync();
+}
+
+void Log_Index::close()
+{
+  file.close();
+}
+
+bool Log_Index::find(const char *log_name, uint32_t time, log_index_entry_t &entry)
+{
+  char name[32];
+  SdFile index;
+
+  if (!index_name(log_name, name, sizeof(name)) || !index.open(name, O_RDONLY))
+    return false;
+
+  // The first entry after `time`, the one in front of it is the answer
+  uint32_t low = 0;
+  uint32_t high = index.fileSize() / sizeof(entry);
+  bool ok = high > 0;
+
+  while (ok && low < high)
+  {
+    uint32_t middle = low + (high - low) / 2;
+
+    ok = read_entry(index, middle, entry);
+    if (entry.time <= time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  ok = ok && read_entry(index, low > 0 ? low - 1 : 0, entry);
+  index.close();
+  return ok;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * @file    log_index.h
+ * @brief   Sparse time index next to each daily CSV log.
+ *
+ *          OPOD12_2026_10_18.txt gets OPOD12_2026_10_18.idx, an array of
+ *          log_index_entry_t: the time, the byte offset of the record (of
+ *          the line break in front of it) and its sequence number. The
+ *          first record of every LOG_INDEX_SECONDS period has an entry, a
+ *          day is about 17 KB of index. Times only increase within a file,
+ *          a record timed before the last entry gets none.
+ *
+ *          To read a range, find() the entry at or before its start, seek
+ *          the log to its offset and read records until the end of the
+ *          range; at most one period's records are read for nothing.
+ *          tools/xpod_extract.cpp does it on the card's files.
+ *
+ *          The index trails the log: open() drops the entries a reset
+ *          left pointing past the end of the log.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _LOG_INDEX_H
+#define _LOG_INDEX_H
+
+#include <Arduino.h>
+#include <SdFat.h>
+
+// Little-endian, as written by the AVR
+struct log_index_entry_t
+{
+    uint32_t time;
+    uint32_t offset;
+    uint32_t seq;
+};
+
+class Log_Index
+{
+  public:
+    // Opens the index of the log file `log_name`, which is `log_size`
+    // bytes long
+    bool open(const char *log_name, uint32_t log_size);
+
+    // Adds an entry if `time` starts a new period
+    bool add(uint32_t time, uint32_t offset, uint32_t seq);
+
+    bool sync();
+    void close();
+
+    // The last entry at or before `time` of the index of `log_name`, the
+    // first entry when all are later. False without entries.
+    static bool find(const char *log_name, uint32_t time, log_index_entry_t &entry);
+
+  private:
+    static bool index_name(const char *log_name, char *name, uint8_t size);
+    static bool read_entry(SdBaseFile &index, uint32_t i, log_index_entry_t &entry);
+
+    SdFile file;
+    uint32_t last_time;
+};
+
+#endif  //_LOG_INDEX_H
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * @file    log_record.cpp
+ * @brief   Sequence numbers and CRCs of the SD log records.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <avr/eeprom.h>
+
+#include "log_record.h"
+#include "crc16.h"
+#include "xpod_node.h"
+
+static const char seq_columns[] = ",Seq,CRC";
+
+void Log_Sequence::begin()
+{
+  mark = eeprom_read_dword((const uint32_t *)LOG_SEQ_EEPROM_ADDR);
+
+  // Erased cells read all ones
+  if (mark == 0xFFFFFFFFUL)
+    mark = 0;
+  seq = mark;
+}
+
+uint32_t Log_Sequence::next()
+{
+  // The mark reaches the EEPROM before a number past it is used
+  if (seq >= mark)
+  {
+    mark = seq + LOG_SEQ_BLOCK;
+    eeprom_update_dword((uint32_t *)LOG_SEQ_EEPROM_ADDR, mark);
+  }
+
+  return seq++;
+}
+
+static char hex_digit(uint8_t value)
+{
+  return value < 10 ? '0' + value : 'A' + value - 10;
+}
+
+void seal_record(Line_Buffer &line, uint16_t start, uint32_t seq)
+{
+  line.print(',');
+  line.print(seq);
+  line.print(',');
+
+  uint16_t crc = crc16(line.c_str() + start, line.length() - start);
+
+  for (int8_t shift = 12; shift >= 0; shift -= 4)
+    line.print(hex_digit((crc >> shift) & 0x0F));
+}
+
+bool check_record(const char *text, uint16_t length, uint32_t &seq)
+{
+  // ",<seq>,XXXX" is 7 characters at least
+  if (length < 7 || text[length - 5] != ',')
+    return false;
+
+  uint16_t crc = 0;
+  for (uint16_t i = length - 4; i < length; i++)
+  {
+    char c = text[i];
+
+    if (c >= '0' && c <= '9')
+      crc = (crc << 4) | (c - '0');
+    else if (c >= 'A' && c <= 'F')
+      crc = (crc << 4) | (c - 'A' + 10);
+    else
+      return false;
+  }
+
+  if (crc16(text, length - 4) != crc)
+    return false;
+
+  // The number between the last two commas
+  uint16_t i = length - 5;
+  uint32_t multiplier = 1;
+
+  seq = 0;
+  while (i > 0 && text[i - 1] >= '0' && text[i - 1] <= '9')
+  {
+    seq += (text[--i] - '0') * multiplier;
+    multiplier *= 10;
+  }
+
+  return i > 0 && i < length - 5 && text[i - 1] == ',';
+}
+
+// True if the file's header line ends in the Seq and CRC columns, a file
+// from an older firmware is left as it is
+static bool sealed_log(SdBaseFile &file, char *buffer, uint16_t size)
+{
+  uint8_t columns = sizeof(seq_columns) - 1;
+  uint32_t end = 0;
+  int n;
+
+  // The header can be longer than the buffer
+  if (!file.seekSet(0))
+    return false;
+  while ((n = file.read(buffer, size)) > 0)
+  {
+    char *cr = (char *)memchr(buffer, '\r', n);
+
+    if (cr)
+    {
+      end += cr - buffer;
+      break;
+    }
+    end += n;
+  }
+
+  return end >= columns && file.seekSet(end - columns) &&
+         file.read(buffer, columns) == columns && memcmp(buffer, seq_columns, columns) == 0;
+}
+
+uint8_t recover_tail(SdBaseFile &file, char *buffer, uint16_t size)
+{
+  uint8_t dropped = 0;
+  // A log of unsealed lines is left as it is, it is still appended to
+  bool sealed = sealed_log(file, buffer, size);
+
+  while (sealed && dropped < LOG_TAIL_MAX_RECORDS)
+  {
+    uint64_t file_size = file.fileSize();
+    uint16_t n = file_size < size ? file_size : size;
+    uint32_t seq;
+
+    if (!file.seekSet(file_size - n) || file.read(buffer, n) != n)
+      break;
+
+    // The last record starts after the last line break, none is left
+    // once only the header is
+    int16_t i = n - 2;
+    while (i >= 0 && !(buffer[i] == '\r' && buffer[i + 1] == '\n'))
+      i--;
+
+    if (i < 0 || check_record(buffer + i + 2, n - i - 2, seq))
+      break;
+
+    if (!file.truncate(file_size - n + i))
+      break;
+    dropped++;
+  }
+
+  file.seekSet(file.fileSize());
+  return dropped;
+}
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * @file    log_record.h
+ * @brief   Sequence numbers and CRCs of the SD log records.
+ *
+ *          A CSV record ends in two more columns, Seq and CRC:
+ *
+ *            <columns>,<seq>,<crc>
+ *
+ *          crc is the CRC-16 of crc16.h over the text from the first column
+ *          up to and including the comma in front of it, as 4 upper case
+ *          hex digits. A record that was cut short by a reset fails it.
+ *
+ *          Sequence numbers keep counting across files and resets. The
+ *          EEPROM holds a mark ahead of the last number handed out, and a
+ *          boot starts at the mark, so the numbers after a reset skip ahead
+ *          and never repeat. The mark moves on every LOG_SEQ_BLOCK records.
+ *
+ *          tools/xpod_logcheck.cpp validates the records of a log and drops
+ *          duplicates.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _LOG_RECORD_H
+#define _LOG_RECORD_H
+
+#include <Arduino.h>
+#include <SdFat.h>
+
+#include "line_buffer.h"
+
+// Records dropped from the end of a file at most, a reset tears the last one
+#define LOG_TAIL_MAX_RECORDS  8
+
+class Log_Sequence
+{
+  public:
+    // Starts from the EEPROM mark
+    void begin();
+
+    // The next sequence number, moves the mark when it is reached
+    uint32_t next();
+
+  private:
+    uint32_t seq;
+    uint32_t mark;
+};
+
+// Appends the Seq and CRC columns to the record in `line`, the record
+// starts `start` characters in (after its line break)
+void seal_record(Line_Buffer &line, uint16_t start, uint32_t seq);
+
+// True if the record text (no line break) has a valid CRC, and its seq
+bool check_record(const char *text, uint16_t length, uint32_t &seq);
+
+// Truncates the CSV log after its last valid record and leaves the file at
+// its end, either way. `buffer` has to hold the longest record. Returns the
+// number of records dropped.
+uint8_t recover_tail(SdBaseFile &file, char *buffer, uint16_t size);
+
+#endif  //_LOG_RECORD_H
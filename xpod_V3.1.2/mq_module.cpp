@@ -9,10 +9,26 @@
  ******************************************************************************/
 #include <Arduino.h>
 #include "mq_module.h"
+#include "fixed_point.h"
+#include "xpod_config.h"
+
+const char MQ_Module::name[] PROGMEM = "MQ131";
+#if READ_JUST_RAW
+const char MQ_Module::header[] PROGMEM = "MQ131(raw)";
+#else
+const char MQ_Module::header[] PROGMEM = "MQ131(ppm),MQ131(raw)";
+#endif
 
 MQ_Module::MQ_Module()
 {
   heater_R0 = 0;
+  R0_sum = 0;
+  calibrations = 0;
+  raw_data = 0;
+  ppm = 0;
+  taken = 0;
+  conv_start = 0;
+  state = ADS_CONV_DONE;
   status = false;
 }
 
@@ -23,56 +39,119 @@ bool MQ_Module::begin()
   else
     status = true;
 
+  R0_sum = 0;
+  calibrations = 0;
+
+  return status;
+}
+
+int8_t MQ_Module::warm()
+{
 #if !READ_JUST_RAW
-  float calcR0 = 0;
-  for(int i = 1; i<=10; i++)
+  if (calibrations < MQ_CALIBRATIONS)
   {
-    calcR0 += this->calibrate();
-  }
+    R0_sum += this->calibrate();
+    if (++calibrations < MQ_CALIBRATIONS)
+      return 0;
 
-  heater_R0 = calcR0 / 10;
+    heater_R0 = R0_sum / MQ_CALIBRATIONS;
+  }
 #endif
 
-  return status;
+  return 1;
 }
 
+void MQ_Module::start()
+{
+  taken = 0;
+  adc_sum = 0;
+  state = status ? ADS_CONV_PENDING : ADS_CONV_DONE;
+
+  poll();
+}
 
-String MQ_Module::read4sd()
+bool MQ_Module::poll()
 {
-  String mq_data;
+  if (state == ADS_CONV_PENDING)
+  {
+    if (!ads_chip_claim(MQ_I2C_ADDR))
+      return false;
 
-  if (!status)
-    return "";
+    conv_start = micros();
+    ads_module.startADCReading(MUX_BY_CHANNEL[MQ_I2C_CHL], false);
+    state = ADS_CONV_BUSY;
+    return false;
+  }
 
-#if READ_JUST_RAW
-  mq_data = String(ads_module.readADC_SingleEnded(MQ_I2C_CHL));
-#else
-  mq_data = String(this->read()) + "," + String(raw_data);
-#endif
+  if (state == ADS_CONV_DONE)
+    return true;
+
+  if (micros() - conv_start < MQ_CONV_US || !ads_module.conversionComplete())
+    return false;
+
+  adc_sum += ads_module.getLastConversionResults();
+
+  if (++taken < xpod_config.mq_samples)
+  {
+    conv_start = micros();
+    ads_module.startADCReading(MUX_BY_CHANNEL[MQ_I2C_CHL], false);
+    return false;
+  }
 
-  return mq_data;
+  state = ADS_CONV_DONE;
+  ads_chip_release(MQ_I2C_ADDR);
+  return true;
 }
 
-String MQ_Module::read4print()
+void MQ_Module::abort()
 {
-  String mq_data;
+  if (state == ADS_CONV_BUSY)
+    ads_chip_release(MQ_I2C_ADDR);
+  state = ADS_CONV_DONE;
+}
 
-  if (!status)
-    return ",";
+uint32_t MQ_Module::conversion_ms()
+{
+  return (xpod_config.mq_samples * MQ_CONV_US * 11 / 10 + 999) / 1000;
+}
 
-#if READ_JUST_RAW 
-  mq_data = "MQ: " + String(ads_module.readADC_SingleEnded(MQ_I2C_CHL));
-#else
-  mq_data = "MQ: " + String(this->read()) + "," + String(raw_data);
+bool MQ_Module::collect(mq_sample_t &sample)
+{
+  if (taken)
+  {
+    float avg = (float)adc_sum / taken;
+
+    raw_data = avg;
+#if !READ_JUST_RAW
+    ppm = to_ppm(to_volts(avg));
 #endif
+  }
+
+  sample.status = status;
+  sample.raw = raw_data;
+  sample.ppm = ppm;
+  return status;
+}
 
-  return mq_data;
+void MQ_Module::read4print(const mq_sample_t &sample, Print &out)
+{
+  if (!sample.status)
+  {
+    out.print(',');
+    return;
+  }
+
+  out.print(F("MQ: "));
+#if !READ_JUST_RAW
+  print_float(out, sample.ppm, 2);
+  out.print(',');
+#endif
+  print_uint(out, sample.raw);
 }
 
-float MQ_Module::read()
+float MQ_Module::to_ppm(float sensor_volt)
 {
   float rs_calc, ratio, PPM;
-  float sensor_volt = this->update();
 
   //More explained in: https://jayconsystems.com/blog/understanding-a-gas-sensor
   rs_calc = ((VOLT_RESOLUTION * O3_EXP_REG_RL) / sensor_volt) - O3_EXP_REG_RL; //Get value of RS in a gas
@@ -138,21 +217,22 @@ float MQ_Module::calibrate()
   return R0;
 }
 
+// mq_samples conversions as in a cycle, within MQ_BUDGET_MS like them
 float MQ_Module::update()
 {
-  int retries = 2;
   float avg = 0.0;
-  uint32_t adc = 0;
 
-  for (int i = 0; i < retries; i++)
-  {
+  for (uint8_t i = 0; i < xpod_config.mq_samples; i++)
     avg += ads_module.readADC_SingleEnded(MQ_I2C_CHL);
-    delay(20);
-  }
 
-  avg = avg / retries;
+  avg = avg / xpod_config.mq_samples;
 
   raw_data = avg;
 
-  return ((avg * VOLT_RESOLUTION) / ((pow(2, ADC_RESOLUTION) - 1)));
+  return to_volts(avg);
+}
+
+float MQ_Module::to_volts(float adc)
+{
+  return ((adc * VOLT_RESOLUTION) / ((pow(2, ADC_RESOLUTION) - 1)));
 }
@@ -11,6 +11,7 @@
 #define _MQ_Module_H
 
 #include <Adafruit_ADS1X15.h>
+#include "ads_module.h"
 
 #define READ_JUST_RAW     1
 
@@ -23,25 +24,81 @@
 #define REG_METHOD        1
 #define MQ_I2C_ADDR    0x4B
 #define MQ_I2C_CHL     1
+#define MQ_SAMPLES     2
+#define MQ_BUDGET_MS   200
+// A conversion at the ADS1115's default 128 SPS
+#define MQ_CONV_US     (1000000UL / 128 + ADS_WAKEUP_US)
+#define MQ_CALIBRATIONS 10
+
+struct mq_sample_t
+{
+    bool status;
+    uint16_t raw;
+    float ppm;
+};
 
 class MQ_Module
 {
   public:
+    typedef mq_sample_t sample_type;
+
+    static const uint8_t column_count = READ_JUST_RAW ? 1 : 2;
+    static const uint16_t budget_ms = MQ_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     MQ_Module();
     bool begin();
+    // One of the MQ_CALIBRATIONS R0 readings per call
+    int8_t warm();
 
-    float read();
-    String read4sd();
-    String read4print();
+    void start();
+    bool poll();
+    bool collect(mq_sample_t &sample);
+    void abort();
+    // mq_samples conversions at the ADS1115's default 128 SPS
+    static uint32_t conversion_ms();
+
+    void read4print(const mq_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const mq_sample_t &sample, Sink &sink);
 
   private:
     float calibrate();
     float update();
+    float to_volts(float adc);
+    float to_ppm(float sensor_volt);
 
     Adafruit_ADS1115 ads_module;
     float heater_R0;
+    float R0_sum;
+    uint8_t calibrations;
     uint16_t raw_data;
+    float ppm;
     bool status;
+
+    // Acquisition state of the current cycle, the chip is shared with E2V
+    ads_conv_state_e state;
+    uint8_t taken;
+    int32_t adc_sum;
+    unsigned long conv_start;
 };
 
-#endif  //_MQ_Module_H
\ No newline at end of file
+template <class Sink>
+void MQ_Module::columns(const mq_sample_t &sample, Sink &sink)
+{
+  if (!sample.status)
+  {
+    for (uint8_t i = 0; i < column_count; i++)
+      sink.skip();
+    return;
+  }
+
+#if !READ_JUST_RAW
+  sink.put_float(sample.ppm, 2);
+#endif
+  sink.put_uint(sample.raw);
+}
+
+#endif  //_MQ_Module_H
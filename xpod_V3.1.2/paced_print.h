@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * @file    paced_print.h
+ * @brief   Print that waits for room in the console's TX buffer.
+ *
+ *          A frame longer than the TX ring can not go out under
+ *          CONSOLE_TX_DROP: its bytes are dropped once the ring is full.
+ *          Paced_Print hands them over in pieces of what fits and waits
+ *          for the rest, a block can outgrow the ring itself
+ *          (HardwareSerial holds 63 bytes).
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _PACED_PRINT_H
+#define _PACED_PRINT_H
+
+#include <Arduino.h>
+
+class Paced_Print : public Print
+{
+  public:
+    Paced_Print(Stream &out) : out(out) {}
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+
+    size_t write(const uint8_t *data, size_t size)
+    {
+      size_t sent = 0;
+
+      while (sent < size)
+      {
+        int room = out.availableForWrite();
+
+        if (room <= 0)
+        {
+          delayMicroseconds(20);
+          continue;
+        }
+        if ((size_t)room > size - sent)
+          room = size - sent;
+        sent += out.write(data + sent, room);
+      }
+      return sent;
+    }
+    using Print::write;
+
+  private:
+    Stream &out;
+};
+
+#endif  //_PACED_PRINT_H
@@ -7,10 +7,18 @@
  ******************************************************************************/
 #include <Arduino.h>
 #include "pms_module.h"
+#include "fixed_point.h"
+
+const char PMS_Module::name[] PROGMEM = "PMS5003";
+const char PMS_Module::header[] PROGMEM =
+  "Pm10_env,Pm25_env,Pm100_env,Pm_03um,Pm_05um,Pm_10um,Pm_25um,Pm_50um,Pm_100um";
 
 PMS_Module::PMS_Module()
 {
   status = false;
+  fresh = false;
+  begin_ms = 0;
+  memset(&data, 0, sizeof(data));
 }
 
 bool PMS_Module::begin()
@@ -22,58 +30,101 @@ bool PMS_Module::begin()
   else
     status = true;
 
+  begin_ms = millis();
   return status;
 }
 
-String PMS_Module::read4sd()
+int8_t PMS_Module::warm()
+{
+  if (PMS_SERIAL.available())
+    return 1;
+
+  return millis() - begin_ms < PMS_WARM_MS ? 0 : -1;
+}
+
+// A frame is streamed every second, two per 2 s cycle overrun the 63 bytes
+// the RX buffer holds and the second is cut short. The whole frames that came
+// in are taken here, the newest is the reading, and a cut one is dropped.
+void PMS_Module::start()
 {
-  String pms_data_str;
-  PM25_AQI_Data data;
-  int read_tries = 20;
-
-  
-  while(!pms_sensor.read(&data) && read_tries) {
-    read_tries--;
-    delay(10);
+  PM25_AQI_Data frame;
+  bool overrun = PMS_SERIAL.available() >= SERIAL_RX_BUFFER_SIZE - 1;
+
+  fresh = false;
+  if (!status)
+    return;
+
+  while (pms_sensor.read(&frame))
+  {
+    data = frame;
+    fresh = true;
   }
 
+  if (overrun)
+  {
+    while (PMS_SERIAL.available())
+      PMS_SERIAL.read();
+  }
+}
+
+bool PMS_Module::poll()
+{
+  // Nothing came in since the last cycle, take the first complete frame
+  PM25_AQI_Data frame;
+
+  if (!status || fresh)
+    return true;
 
-  pms_data_str = String(data.pm10_env) + ",";
-  pms_data_str += String(data.pm25_env) + ",";
-  pms_data_str += String(data.pm100_env) + ",";
+  // read() fills the frame before checking the checksum
+  if (pms_sensor.read(&frame))
+  {
+    data = frame;
+    return true;
+  }
 
-  pms_data_str += String(data.particles_03um) + ",";
-  pms_data_str += String(data.particles_05um) + ",";
-  pms_data_str += String(data.particles_10um) + ",";
-  pms_data_str += String(data.particles_25um) + ",";
-  pms_data_str += String(data.particles_50um) + ",";
-  pms_data_str += String(data.particles_100um) + ",";
-  delay(100);
-  return pms_data_str;
+  return false;
 }
 
-String PMS_Module::read4print()
+void PMS_Module::abort()
 {
-  String pms_data_str;
-  PM25_AQI_Data data;
-  int read_tries = 3;
+}
 
+bool PMS_Module::collect(pms_sample_t &sample)
+{
+  sample.pm10_env = data.pm10_env;
+  sample.pm25_env = data.pm25_env;
+  sample.pm100_env = data.pm100_env;
+  sample.particles_03um = data.particles_03um;
+  sample.particles_05um = data.particles_05um;
+  sample.particles_10um = data.particles_10um;
+  sample.particles_25um = data.particles_25um;
+  sample.particles_50um = data.particles_50um;
+  sample.particles_100um = data.particles_100um;
+  return status;
+}
+
+void PMS_Module::read4print(const pms_sample_t &sample, Print &out)
+{
   if (!status)
-    return "";
+    return;
 
-    while(!pms_sensor.read(&data) && read_tries) {
-    read_tries--;
-  }
-  pms_data_str = "PM10_ENV:" + String(data.pm10_env) + ",";
-  pms_data_str += "PM10_ENV:" + String(data.pm25_env) + ",";
-  pms_data_str += "PM10_ENV:" + String(data.pm100_env) + ",";
-
-  pms_data_str += "PM_03um:" + String(data.particles_03um) + ",";
-  pms_data_str += "PM_05um:" + String(data.particles_05um) + ",";
-  pms_data_str += "PM_10um:" + String(data.particles_10um) + ",";
-  pms_data_str += "PM_25um:" + String(data.particles_25um) + ",";
-  pms_data_str += "PM_30um:" + String(data.particles_50um) + ",";
-  pms_data_str += "PM_100um:" + String(data.particles_100um);
-  delay(100);
-  return pms_data_str;
+  out.print(F("PM10_ENV:"));
+  print_uint(out, sample.pm10_env);
+  out.print(F(",PM10_ENV:"));
+  print_uint(out, sample.pm25_env);
+  out.print(F(",PM10_ENV:"));
+  print_uint(out, sample.pm100_env);
+
+  out.print(F(",PM_03um:"));
+  print_uint(out, sample.particles_03um);
+  out.print(F(",PM_05um:"));
+  print_uint(out, sample.particles_05um);
+  out.print(F(",PM_10um:"));
+  print_uint(out, sample.particles_10um);
+  out.print(F(",PM_25um:"));
+  print_uint(out, sample.particles_25um);
+  out.print(F(",PM_30um:"));
+  print_uint(out, sample.particles_50um);
+  out.print(F(",PM_100um:"));
+  print_uint(out, sample.particles_100um);
 }
@@ -12,18 +12,69 @@
 
 #define PMS_SERIAL       (Serial1)
 #define PMS_SERIAL_BR    (9600)
+#define PMS_BUDGET_MS    (200)
+#define PMS_WARM_MS      (5000) // first frame due after begin()
+
+struct pms_sample_t
+{
+    uint16_t pm10_env;
+    uint16_t pm25_env;
+    uint16_t pm100_env;
+    uint16_t particles_03um;
+    uint16_t particles_05um;
+    uint16_t particles_10um;
+    uint16_t particles_25um;
+    uint16_t particles_50um;
+    uint16_t particles_100um;
+};
 
 class PMS_Module
 {
   public:
+    typedef pms_sample_t sample_type;
+
+    static const uint8_t column_count = 9;
+    static const uint16_t budget_ms = PMS_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     PMS_Module();
     bool begin();
-    String read4sd();
-    String read4print();
+    // Ready once the stream started
+    int8_t warm();
+
+    void start();
+    bool poll();
+    bool collect(pms_sample_t &sample);
+    void abort();
+
+    void read4print(const pms_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const pms_sample_t &sample, Sink &sink);
 
   private:
     Adafruit_PM25AQI pms_sensor;
+    PM25_AQI_Data data;
     bool status;
+    // A frame was waiting at start()
+    bool fresh;
+    unsigned long begin_ms;
 };
 
-#endif  //_PMS_MODULE_H
\ No newline at end of file
+template <class Sink>
+void PMS_Module::columns(const pms_sample_t &sample, Sink &sink)
+{
+  sink.put_uint(sample.pm10_env);
+  sink.put_uint(sample.pm25_env);
+  sink.put_uint(sample.pm100_env);
+
+  sink.put_uint(sample.particles_03um);
+  sink.put_uint(sample.particles_05um);
+  sink.put_uint(sample.particles_10um);
+  sink.put_uint(sample.particles_25um);
+  sink.put_uint(sample.particles_50um);
+  sink.put_uint(sample.particles_100um);
+}
+
+#endif  //_PMS_MODULE_H
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * @file    profiler.cpp
+ * @brief   Per-phase timing statistics of the sample loop.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "profiler.h"
+
+static const char phase_cycle[] PROGMEM = "cycle";
+static const char phase_rtc[] PROGMEM = "rtc";
+static const char phase_serial[] PROGMEM = "serial";
+static const char phase_sd_open[] PROGMEM = "sd_open";
+static const char phase_sd_write[] PROGMEM = "sd_write";
+static const char phase_sd_sync[] PROGMEM = "sd_sync";
+static const char phase_sleep[] PROGMEM = "sleep";
+static const char phase_energy[] PROGMEM = "energy_uj";
+static const char phase_unknown[] PROGMEM = "?";
+
+static const char *const phase_names[PROFILE_SENSORS] = {
+  phase_cycle, phase_rtc, phase_serial, phase_sd_open, phase_sd_write, phase_sd_sync,
+  phase_sleep, phase_energy
+};
+
+Loop_Profiler::Loop_Profiler()
+{
+  module_name = NULL;
+  phase_count = PROFILE_SENSORS;
+  memset(phase_stats, 0, sizeof(phase_stats));
+}
+
+bool Loop_Profiler::begin(uint8_t phase_count, phase_name_f module_name)
+{
+  if (phase_count > PROFILER_MAX_PHASES || phase_count < PROFILE_SENSORS)
+    return false;
+
+  this->phase_count = phase_count;
+  this->module_name = module_name;
+  reset();
+
+  return true;
+}
+
+void Loop_Profiler::record(uint8_t phase, uint32_t elapsed_us)
+{
+  if (phase >= phase_count)
+    return;
+
+  phase_stats_t *stats = &phase_stats[phase];
+
+  stats->last = elapsed_us;
+  if (stats->count == 0 || elapsed_us < stats->min)
+    stats->min = elapsed_us;
+  if (elapsed_us > stats->max)
+    stats->max = elapsed_us;
+  stats->sum += elapsed_us;
+  stats->count++;
+}
+
+// Starts a new window, the last durations are kept
+void Loop_Profiler::reset()
+{
+  for (uint8_t i = 0; i < PROFILER_MAX_PHASES; i++)
+  {
+    phase_stats[i].min = 0;
+    phase_stats[i].max = 0;
+    phase_stats[i].sum = 0;
+    phase_stats[i].count = 0;
+  }
+}
+
+uint8_t Loop_Profiler::phases()
+{
+  return phase_count;
+}
+
+uint16_t Loop_Profiler::cycles()
+{
+  return phase_stats[PROFILE_CYCLE].count;
+}
+
+const phase_stats_t &Loop_Profiler::stats(uint8_t phase)
+{
+  return phase_stats[phase];
+}
+
+uint32_t Loop_Profiler::mean(uint8_t phase)
+{
+  if (phase_stats[phase].count == 0)
+    return 0;
+
+  return phase_stats[phase].sum / phase_stats[phase].count;
+}
+
+const char *Loop_Profiler::name(uint8_t phase)
+{
+  if (phase < PROFILE_SENSORS)
+    return phase_names[phase];
+
+  return module_name ? module_name(phase - PROFILE_SENSORS) : phase_unknown;
+}
+
+void Loop_Profiler::print_row(Print &out, uint8_t phase)
+{
+  out.print((const __FlashStringHelper *)name(phase));
+  out.print(',');
+  out.print(phase_stats[phase].last);
+  out.print(',');
+  out.print(phase_stats[phase].min);
+  out.print(',');
+  out.print(phase_stats[phase].max);
+  out.print(',');
+  out.print(mean(phase));
+  out.print(',');
+  out.println(phase_stats[phase].count);
+}
+
+// The energy is no time, it gets a table of its own after the phases
+void Loop_Profiler::print(Print &out)
+{
+  out.println(F("phase,last_us,min_us,max_us,mean_us,n"));
+  for (uint8_t i = 0; i < phase_count; i++)
+  {
+    if (i != PROFILE_ENERGY)
+      print_row(out, i);
+  }
+
+  out.println(F("phase,last_uj,min_uj,max_uj,mean_uj,n"));
+  print_row(out, PROFILE_ENERGY);
+}
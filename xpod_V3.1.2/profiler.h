@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * @file    profiler.h
+ * @brief   Per-phase timing statistics of the sample loop.
+ *
+ *          Each phase keeps the last, min, max and mean of its micros()
+ *          durations over a window of cycles. The window is written to the
+ *          diagnostics log and can be dumped on the serial port.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <Arduino.h>
+
+#define PROFILER_MAX_PHASES   18
+
+// Fixed phases, the sensor modules follow from PROFILE_SENSORS on in the
+// order of the sensor registry. PROFILE_SLEEP and PROFILE_ENERGY cover the
+// whole previous cycle, idle included; the energy is in uJ, not us.
+enum profile_phase_e
+{
+    PROFILE_CYCLE = 0,
+    PROFILE_RTC,
+    PROFILE_SERIAL,
+    PROFILE_SD_OPEN,
+    PROFILE_SD_WRITE,
+    PROFILE_SD_SYNC,
+    PROFILE_SLEEP,
+    PROFILE_ENERGY,
+    PROFILE_SENSORS
+};
+
+struct phase_stats_t
+{
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint16_t count;
+};
+
+// Returns the PROGMEM name of a module phase, index 0 is PROFILE_SENSORS
+typedef const char *(*phase_name_f)(uint8_t module);
+
+class Loop_Profiler
+{
+  public:
+    Loop_Profiler();
+    bool begin(uint8_t phase_count, phase_name_f module_name);
+
+    void record(uint8_t phase, uint32_t elapsed_us);
+    void reset();
+
+    uint8_t phases();
+    uint16_t cycles();
+    const phase_stats_t &stats(uint8_t phase);
+    uint32_t mean(uint8_t phase);
+    const char *name(uint8_t phase);
+
+    // CSV of the time phases in us, then of the energy in uJ
+    void print(Print &out);
+
+  private:
+    void print_row(Print &out, uint8_t phase);
+
+    phase_stats_t phase_stats[PROFILER_MAX_PHASES];
+    phase_name_f module_name;
+    uint8_t phase_count;
+};
+
+#endif  //_PROFILER_H
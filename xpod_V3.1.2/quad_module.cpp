@@ -8,81 +8,140 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "quad_module.h"
+#include "fixed_point.h"
+#include "xpod_config.h"
+
+const char QUAD_Module::name[] PROGMEM = "QUAD";
+const char QUAD_Module::header[] PROGMEM =
+  "Q(A1-C1),Q(A1-C2),Q(A1-C3),Q(A1-C4),Q(A2-C1),Q(A2-C2),Q(A2-C3),Q(A2-C4)";
+
+static const MCP342x::Channel quad_channels[MCP342x::numChannels] = {
+  MCP342x::channel1, MCP342x::channel2, MCP342x::channel3, MCP342x::channel4
+};
 
 QUAD_Module::QUAD_Module()
 {
   status = true;
+
+  for (int i = 0; i < QUAD_CHIP_COUNT * MCP342x::numChannels; i++)
+    values[i] = 0;
 }
 
 bool QUAD_Module::begin()
 {
-  alpha_one = MCP342x(APLHA_ONE_ADDR);
-  alpha_two = MCP342x(APLHA_TWO_ADDR);
+  alpha[0] = MCP342x(APLHA_ONE_ADDR);
+  alpha[1] = MCP342x(APLHA_TWO_ADDR);
 
   MCP342x::generalCallReset();
   delay(1);
 
-  // Wire.requestFrom(APLHA_ONE_ADDR, (uint8_t)1);
+  // Up while either chip ACKs its address, a missing one keeps its zeros
+  status = false;
+  for (uint8_t chip = 0; chip < QUAD_CHIP_COUNT; chip++)
+  {
+    Wire.beginTransmission(alpha[chip].getAddress());
+    if (Wire.endTransmission() == 0)
+      status = true;
+  }
 
-  // if (!Wire.available())
-  //   status = false;
-  
-  // Wire.requestFrom(APLHA_TWO_ADDR, (uint8_t)1);
+  return status;
+}
 
-  // if (!Wire.available())
-  //   status = false;
+// quad_bits of XPOD.CFG
+static const MCP342x::Resolution &resolution()
+{
+  switch (xpod_config.quad_bits)
+  {
+    case 12: return MCP342x::resolution12;
+    case 14: return MCP342x::resolution14;
+    default: return MCP342x::resolution16;
+  }
+}
 
-  return status;
+void QUAD_Module::convert(uint8_t chip)
+{
+  alpha[chip].convert(quad_channels[channel[chip]], MCP342x::oneShot, resolution(), MCP342x::gain1);
+  conv_start[chip] = micros();
+}
+
+int8_t QUAD_Module::warm()
+{
+  return 1;
+}
+
+void QUAD_Module::start()
+{
+  read_count = 0;
+  for (uint8_t chip = 0; chip < QUAD_CHIP_COUNT; chip++)
+  {
+    channel[chip] = 0;
+    convert(chip);
+  }
+}
+
+bool QUAD_Module::poll()
+{
+  bool done = true;
+
+  // Both chips convert in parallel, each walks through its four channels
+  for (uint8_t chip = 0; chip < QUAD_CHIP_COUNT; chip++)
+  {
+    MCP342x::Config conv_status;
+    long value = 0;
+
+    if (channel[chip] >= MCP342x::numChannels)
+      continue;
+
+    done = false;
+
+    unsigned long elapsed = micros() - conv_start[chip];
+    unsigned long conv_time = resolution().getConversionTime();
+
+    // Nothing to ask the chip until the conversion time has passed
+    if (elapsed < conv_time)
+      continue;
+
+    MCP342x::error_t err = alpha[chip].read(value, conv_status);
+
+    if (err == MCP342x::errorNone && conv_status.isReady())
+    {
+      values[chip * MCP342x::numChannels + channel[chip]] = value;
+      read_count++;
+    }
+    else if (elapsed < QUAD_CONV_TIMEOUT * conv_time)
+      continue;
+
+    if (++channel[chip] < MCP342x::numChannels)
+      convert(chip);
+  }
+
+  return done;
 }
 
-String QUAD_Module::read()
+void QUAD_Module::abort()
 {
-  MCP342x::Config status;
-  String quad_data;
-  long value = 0;
-
-  // Initiate a conversion; convertAndRead() will wait until it can be read
-  alpha_one.convertAndRead(MCP342x::channel1, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_one.convertAndRead(MCP342x::channel2, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_one.convertAndRead(MCP342x::channel3, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_one.convertAndRead(MCP342x::channel4, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-
-  alpha_two.convertAndRead(MCP342x::channel1, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_two.convertAndRead(MCP342x::channel2, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_two.convertAndRead(MCP342x::channel3, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value) + ",";
-
-  alpha_two.convertAndRead(MCP342x::channel4, MCP342x::oneShot, MCP342x::resolution16, 
-                          MCP342x::gain1, 1000000, value, status);
-  quad_data += String(value);
-    
-  // //Read ADCs on-board and on-Quadstat
-  // for (int i = 1; i <= 16; i++) 
-  // {
-  //   if (i <= 4) 
-  //     quad_data += alpha_one.GetValue(i) + ",";
-  //   else if (i <= 8) 
-  //     quad_data += alpha_two.GetValue(i - 4) + ",";
-  // }
-
-  return quad_data;
-}
\ No newline at end of file
+}
+
+uint32_t QUAD_Module::conversion_ms()
+{
+  return (MCP342x::numChannels * resolution().getConversionTime() + 999) / 1000;
+}
+
+// False when no channel converted this cycle
+bool QUAD_Module::collect(quad_sample_t &sample)
+{
+  for (int i = 0; i < QUAD_CHIP_COUNT * MCP342x::numChannels; i++)
+    sample.values[i] = values[i];
+
+  return read_count > 0;
+}
+
+void QUAD_Module::read4print(const quad_sample_t &sample, Print &out)
+{
+  for (int i = 0; i < QUAD_CHIP_COUNT * MCP342x::numChannels; i++)
+  {
+    if (i)
+      out.print(',');
+    print_int(out, sample.values[i]);
+  }
+}
@@ -16,17 +16,61 @@
 #define APLHA_ONE_ADDR        (0x69)
 #define APLHA_TWO_ADDR        (0x6E)
 
+#define QUAD_CHIP_COUNT       2
+// A channel is given up after this many conversion times
+#define QUAD_CONV_TIMEOUT     3
+// Default of quad_bits in XPOD.CFG
+#define QUAD_BITS             16
+#define QUAD_BUDGET_MS        1000
+
+struct quad_sample_t
+{
+    long values[QUAD_CHIP_COUNT * MCP342x::numChannels];
+};
+
 class QUAD_Module
 {
   public:
+    typedef quad_sample_t sample_type;
+
+    static const uint8_t column_count = QUAD_CHIP_COUNT * MCP342x::numChannels;
+    static const uint16_t budget_ms = QUAD_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
     QUAD_Module();
     bool begin();
+    int8_t warm();
 
-    String read();
+    void start();
+    bool poll();
+    bool collect(quad_sample_t &sample);
+    void abort();
+    // Both chips walk their channels in parallel at quad_bits
+    static uint32_t conversion_ms();
+
+    void read4print(const quad_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const quad_sample_t &sample, Sink &sink);
   private:
-    MCP342x alpha_one;
-    MCP342x alpha_two;
+    void convert(uint8_t chip);
+
+    MCP342x alpha[QUAD_CHIP_COUNT];
     bool status;
+
+    // Acquisition state of the current cycle, one channel at a time per chip
+    uint8_t channel[QUAD_CHIP_COUNT];
+    unsigned long conv_start[QUAD_CHIP_COUNT];
+    uint8_t read_count;
+    long values[QUAD_CHIP_COUNT * MCP342x::numChannels];
 };
 
-#endif  //_QUAD_Module_H
\ No newline at end of file
+template <class Sink>
+void QUAD_Module::columns(const quad_sample_t &sample, Sink &sink)
+{
+  for (uint8_t i = 0; i < column_count; i++)
+    sink.put_int(sample.values[i]);
+}
+
+#endif  //_QUAD_Module_H
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * @file    ram_monitor.cpp
+ * @brief   Free RAM between the heap and the stack, and its low-water mark.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "ram_monitor.h"
+
+#ifdef __AVR__
+#include <FreeStack.h>
+
+extern char __heap_start;
+#endif
+
+RAM_Monitor::RAM_Monitor()
+{
+  min_free = 0xFFFF;
+  max_heap = 0;
+}
+
+void RAM_Monitor::begin()
+{
+#ifdef __AVR__
+  FillStack();
+  update();
+  min_free = free_now();
+#endif
+}
+
+void RAM_Monitor::update()
+{
+#ifdef __AVR__
+  uint16_t heap = __brkval ? __brkval - &__heap_start : 0;
+
+  if (heap > max_heap)
+    max_heap = heap;
+#endif
+}
+
+void RAM_Monitor::scan()
+{
+#ifdef __AVR__
+  uint16_t unused = UnusedStack();
+
+  update();
+  if (unused < min_free)
+    min_free = unused;
+#endif
+}
+
+bool RAM_Monitor::measured() const
+{
+#ifdef __AVR__
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint16_t RAM_Monitor::free_now() const
+{
+#ifdef __AVR__
+  return FreeStack();
+#else
+  return 0;
+#endif
+}
+
+void RAM_Monitor::print(Print &out) const
+{
+  if (!measured())
+    return;
+
+  out.print(F("ram_free_now,"));
+  out.println(free_now());
+  out.print(F("ram_free_min,"));
+  out.println(min_free);
+  out.print(F("ram_heap_max,"));
+  out.println(max_heap);
+}
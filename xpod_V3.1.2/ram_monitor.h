@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * @file    ram_monitor.h
+ * @brief   Free RAM between the heap and the stack, and its low-water mark.
+ *
+ *          begin() paints the gap between the heap top and the stack
+ *          pointer with SdFat's FillStack() at boot. scan() counts the
+ *          bytes the stack never reached (UnusedStack()), so the deepest
+ *          stack use of any call chain or interrupt since boot is caught,
+ *          not only where the monitor happens to look. update() is cheap
+ *          and follows the heap top (__brkval) every cycle.
+ *
+ *          The paint can only be trusted from the heap top up: the heap
+ *          grows into it, so malloc() after begin() makes the free bytes
+ *          read lower, never higher.
+ *
+ *          Only AVR has the symbols; elsewhere nothing is measured.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _RAM_MONITOR_H
+#define _RAM_MONITOR_H
+
+#include <Arduino.h>
+
+class RAM_Monitor
+{
+  public:
+    RAM_Monitor();
+
+    // First thing in setup(), before the deep call chains of the drivers
+    void begin();
+    // Every cycle: the heap top
+    void update();
+    // Walks the painted gap up to the deepest stack use, a few
+    // milliseconds with the Mega's 8 KB
+    void scan();
+
+    // False where the numbers mean nothing (the host build)
+    bool measured() const;
+
+    // Bytes between heap and stack right now
+    uint16_t free_now() const;
+    // Fewest bytes that were ever left between the heap and the stack,
+    // as of the last scan()
+    uint16_t free_min() const { return min_free; }
+    // Highest heap use since boot
+    uint16_t heap_max() const { return max_heap; }
+
+    // A name,value line for each number
+    void print(Print &out) const;
+
+  private:
+    uint16_t min_free;
+    uint16_t max_heap;
+};
+
+#endif  //_RAM_MONITOR_H
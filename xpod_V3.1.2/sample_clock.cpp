@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * @file    sample_clock.cpp
+ * @brief   Fixed sample cadence paced by the DS3231 1 Hz square wave.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <avr/wdt.h>
+#include "sample_clock.h"
+
+volatile uint32_t Sample_Clock::sqw_ticks = 0;
+
+Sample_Clock::Sample_Clock()
+{
+  slot_tick = 0;
+  overrun_count = 0;
+  fault_count = 0;
+  fault_tick = 0;
+  period = 1;
+  started = false;
+  faulted = false;
+  status = false;
+}
+
+bool Sample_Clock::begin(RTC_DS3231 &rtc, uint8_t sqw_pin, uint8_t period_s)
+{
+  int irq = digitalPinToInterrupt(sqw_pin);
+
+  if (irq < 0 || period_s == 0)
+    return false;
+
+  period = period_s;
+
+  // SQW is open drain, the falling edge marks the start of each second
+  pinMode(sqw_pin, INPUT_PULLUP);
+  rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+  attachInterrupt(irq, sqw_isr, FALLING);
+
+  status = true;
+
+  return status;
+}
+
+void Sample_Clock::sqw_isr()
+{
+  sqw_ticks++;
+}
+
+uint32_t Sample_Clock::ticks()
+{
+  uint32_t val;
+
+  noInterrupts();
+  val = sqw_ticks;
+  interrupts();
+
+  return val;
+}
+
+bool Sample_Clock::wait(void (*idle)())
+{
+  if (!status)
+    return false;
+
+  // Back to SQW pacing once the signal returns, on a fresh slot
+  if (faulted)
+  {
+    if (ticks() == fault_tick)
+      return false;
+    faulted = false;
+    started = false;
+  }
+
+  uint32_t next = slot_tick + period;
+  int32_t late = (int32_t)(ticks() - next);
+
+  // The first cycle after boot is not aligned to any slot yet
+  if (!started)
+  {
+    next = ticks() + 1;
+    late = -1;
+    started = true;
+  }
+
+  // The previous cycle ran past the end of its slot, skip ahead to the
+  // first boundary that has not passed yet
+  if (late >= 0)
+  {
+    uint32_t skipped = (uint32_t)late / period + 1;
+
+    overrun_count += skipped;
+    next += skipped * period;
+  }
+
+  unsigned long deadline_ms = millis() + (next - ticks() + SQW_TIMEOUT_PERIODS * period) * 1000UL;
+
+  while ((int32_t)(ticks() - next) < 0)
+  {
+    if ((long)(millis() - deadline_ms) >= 0)
+    {
+      fault_count++;
+      fault_tick = ticks();
+      faulted = true;
+      return false;
+    }
+
+    wdt_reset();
+    if (idle)
+      idle();
+  }
+
+  slot_tick = next;
+
+  return true;
+}
+
+uint32_t Sample_Clock::overruns()
+{
+  return overrun_count;
+}
+
+uint32_t Sample_Clock::faults()
+{
+  return fault_count;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * @file    sample_clock.h
+ * @brief   Fixed sample cadence paced by the DS3231 1 Hz square wave.
+ *
+ *          The RTC's SQW output drives an external interrupt that counts
+ *          seconds. Cycles start on slot boundaries every period seconds.
+ *          A cycle that is still running when its slot ends is an overrun:
+ *          the slot it finishes in is skipped and the next cycle starts on
+ *          the following boundary, so the cadence never drifts.
+ *
+ *          A tick that is SQW_TIMEOUT_PERIODS periods late is a fault: the
+ *          SQW signal stopped (wiring, a dead RTC). wait() then returns
+ *          false, so the loop falls back to millis() pacing, until ticks
+ *          come in again.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SAMPLE_CLOCK_H
+#define _SAMPLE_CLOCK_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+// Periods past the expected tick before the SQW signal counts as lost
+#define SQW_TIMEOUT_PERIODS   2
+
+class Sample_Clock
+{
+  public:
+    Sample_Clock();
+    bool begin(RTC_DS3231 &rtc, uint8_t sqw_pin, uint8_t period_s);
+    // `idle`, if given, runs over and over while it waits. False when
+    // there is no SQW pacing, or no more since the signal was lost.
+    bool wait(void (*idle)() = NULL);
+    uint32_t overruns();
+    // Times the SQW signal was lost
+    uint32_t faults();
+
+  private:
+    static void sqw_isr();
+    static uint32_t ticks();
+
+    static volatile uint32_t sqw_ticks;
+
+    uint32_t slot_tick;
+    uint32_t overrun_count;
+    uint32_t fault_count;
+    // Tick count when the signal was lost
+    uint32_t fault_tick;
+    uint8_t period;
+    bool started;
+    bool faulted;
+    bool status;
+};
+
+#endif  //_SAMPLE_CLOCK_H
@@ -0,0 +1,480 @@
+/*******************************************************************************
+ * @file    sensor_registry.h
+ * @brief   Compile-time registry of the sensor modules of a pod.
+ *
+ *          Sensor_Registry<A, B, C> is a list of module types resolved by
+ *          the compiler: begin/acquire/format calls are generated for each
+ *          module in order, without virtual calls or hand-written #if
+ *          chains, and the list fixes the column layout of a log line.
+ *
+ *          A module type provides:
+ *            typedef ... sample_type;          its part of the sample record
+ *            static const uint8_t column_count;
+ *            static const uint16_t budget_ms;  time allowed per acquisition
+ *            static const char name[] PROGMEM;   short label for messages
+ *            static const char header[] PROGMEM; comma separated column names
+ *            bool begin();                     quick, may leave work to warm()
+ *            int8_t warm();                    a bounded step of the rest:
+ *                                              > 0 ready, 0 not yet, < 0 failed
+ *            void start();                     kick off conversions
+ *            bool poll();                      true once results are ready
+ *            bool collect(sample_type &sample); false if the reading failed
+ *            void abort();                     out of budget, drop the cycle
+ *            void read4print(const sample_type &sample, Print &out);
+ *            template <class Sink>
+ *            static void columns(const sample_type &sample, Sink &sink);
+ *
+ *          A module that is not done within its budget is aborted and its
+ *          sample keeps the previous values, with its bit (registry order)
+ *          set in the stale mask of the sample.
+ *
+ *          Each module has a health state. It is OK while its readings
+ *          come in, DEGRADED after a failed reading or an abort, WARMING
+ *          until warm() reports it ready, and OFFLINE when begin() or warm()
+ *          failed or HEALTH_OFFLINE_FAILURES cycles in a row failed. A
+ *          warming or offline module is not started or polled and its
+ *          columns are empty; warm_up() steps the warming ones between
+ *          cycles, so a slow sensor does not hold up setup() or the others.
+ *          probe() calls an offline module's begin() again, first after
+ *          HEALTH_RETRY_MIN_MS and then at twice the previous interval, up
+ *          to HEALTH_RETRY_MAX_MS, until a reading succeeds. The health mask
+ *          of the sample has the bit of every module that is not OK, the
+ *          offline mask those whose columns are empty: WARMING and OFFLINE
+ *          ones and those that begin() was told to leave out (DISABLED).
+ *
+ *          Each module's acquisition time, from its start() to the poll()
+ *          that finished it, is kept for the loop profiler.
+ *
+ *          Enable<FLAG, M>::type yields M, or Disabled<M> when FLAG is 0.
+ *          A disabled module has no object, no sample storage and no code,
+ *          it only keeps its empty columns and header names so that the
+ *          layout of the log does not depend on the build.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SENSOR_REGISTRY_H
+#define _SENSOR_REGISTRY_H
+
+#include <Arduino.h>
+
+#include "xpod_node.h"
+
+enum
+{
+  HEALTH_OK,
+  HEALTH_DEGRADED,
+  // From here on the module is not sampled and its columns are empty
+  HEALTH_WARMING,
+  HEALTH_OFFLINE,
+  // Left out by the module mask of begin(), never probed
+  HEALTH_DISABLED
+};
+
+template <class M>
+struct Disabled
+{
+};
+
+template <bool enabled, class M>
+struct Enable
+{
+    typedef M type;
+};
+
+template <class M>
+struct Enable<false, M>
+{
+    typedef Disabled<M> type;
+};
+
+// Sample storage, one node per enabled module. Disabled modules add nothing.
+struct Sample_End
+{
+    uint16_t stale;
+    uint16_t health;
+    uint16_t offline;
+};
+
+// The columns of an offline module, every value of it left empty
+template <class Sink>
+class Empty_Columns
+{
+  public:
+    Empty_Columns(Sink &sink) : sink(sink) {}
+
+    void put_int(long value) { sink.skip(); }
+    void put_uint(unsigned long value) { sink.skip(); }
+    void put_float(float value, uint8_t decimals) { sink.skip(); }
+    void put_fixed(long value, uint8_t decimals) { sink.skip(); }
+    // Text stays text, a summary does not count it
+    void put_str(const char *value) { sink.put_str(""); }
+    void skip() { sink.skip(); }
+    void disabled(uint8_t columns) { sink.disabled(columns); }
+
+  private:
+    Sink &sink;
+};
+
+template <class M, class Next>
+struct Sample_Node : Next
+{
+    typename M::sample_type value;
+};
+
+template <class... M>
+class Sensor_Registry;
+
+template <>
+class Sensor_Registry<>
+{
+  public:
+    typedef Sample_End sample_type;
+
+    static const uint8_t column_count = 0;
+    static const uint8_t enabled_column_count = 0;
+    static const uint8_t module_count = 0;
+
+    bool begin(Print *log, uint16_t mask = 0xFFFF, uint8_t index = 0) { return true; }
+    void start() {}
+    bool poll(sample_type &sample, uint8_t index = 0) { return true; }
+    void probe(Print *log) {}
+    void warm_up(Print *log) {}
+    void print(Print &out, const sample_type &sample, uint8_t index = 0) {}
+
+    template <class Profiler>
+    void report(Profiler &profiler, uint8_t phase) {}
+
+    template <class Sink>
+    static void columns(const sample_type &sample, Sink &sink, uint8_t index = 0) {}
+
+    static void header(Print &out) {}
+
+    static const char *name_of(uint8_t index) { return NULL; }
+};
+
+template <class M, class... Rest>
+class Sensor_Registry<M, Rest...> : public Sensor_Registry<Rest...>
+{
+    typedef Sensor_Registry<Rest...> next_type;
+
+  public:
+    typedef Sample_Node<M, typename next_type::sample_type> sample_type;
+
+    static const uint8_t column_count = M::column_count + next_type::column_count;
+    static const uint8_t enabled_column_count = M::column_count + next_type::enabled_column_count;
+    static const uint8_t module_count = 1 + next_type::module_count;
+
+    // Modules without their bit in `mask` are not begun and stay DISABLED
+    bool begin(Print *log, uint16_t mask = 0xFFFF, uint8_t index = 0)
+    {
+      failures = 0;
+      retry_ms = HEALTH_RETRY_MIN_MS;
+      if (!(mask & (1 << index)))
+      {
+        health = HEALTH_DISABLED;
+        return next_type::begin(log, mask, index + 1);
+      }
+
+      int8_t state = begin_module();
+
+      health = state > 0 ? HEALTH_OK : HEALTH_WARMING;
+      if (state < 0)
+      {
+        go_offline();
+        report_failure(log);
+      }
+
+      return next_type::begin(log, mask, index + 1) && state >= 0;
+    }
+
+    void start()
+    {
+      elapsed_us = 0;
+      done = false;
+      if (health < HEALTH_WARMING)
+      {
+        start_us = micros();
+        module.start();
+      }
+      next_type::start();
+    }
+
+    bool poll(sample_type &sample, uint8_t index = 0)
+    {
+      if (!done)
+      {
+        uint16_t bit = 1 << index;
+
+        if (health >= HEALTH_WARMING)
+        {
+          sample.stale &= ~bit;
+          done = true;
+        }
+        else if (module.poll())
+        {
+          update(module.collect(sample.value));
+          sample.stale &= ~bit;
+          done = true;
+        }
+        else if (micros() - start_us >= M::budget_ms * 1000UL)
+        {
+          module.abort();
+          update(false);
+          sample.stale |= bit;
+          done = true;
+        }
+
+        if (done)
+        {
+          if (health < HEALTH_WARMING)
+            elapsed_us = micros() - start_us;
+          sample.health = health == HEALTH_OK || health == HEALTH_DISABLED ? sample.health & ~bit
+                                                                          : sample.health | bit;
+          sample.offline = health >= HEALTH_WARMING ? sample.offline | bit : sample.offline & ~bit;
+        }
+      }
+
+      return next_type::poll(sample, index + 1) && done;
+    }
+
+    // Calls begin() of the offline modules whose retry time has come, for
+    // the idle part of a cycle. A module that answers is DEGRADED until
+    // its first good reading, or WARMING before that.
+    void probe(Print *log)
+    {
+      if (health == HEALTH_OFFLINE && millis() - offline_ms >= retry_ms)
+      {
+        int8_t state = begin_module();
+        bool status = state >= 0;
+
+        retry_ms = retry_ms * 2 < HEALTH_RETRY_MAX_MS ? retry_ms * 2 : HEALTH_RETRY_MAX_MS;
+        if (status)
+        {
+          health = state > 0 ? HEALTH_DEGRADED : HEALTH_WARMING;
+          failures = 0;
+        }
+        else
+          offline_ms = millis();
+
+        if (log)
+        {
+          log->print(F("Probe "));
+          log->print((const __FlashStringHelper *)M::name);
+          if (status)
+            log->println(F(": ok"));
+          else
+          {
+            log->print(F(": failed, retry in "));
+            log->print(retry_ms / 1000);
+            log->println(F(" s"));
+          }
+        }
+      }
+
+      next_type::probe(log);
+    }
+
+    // A warm() step of each WARMING module, as often as the idle part of
+    // a cycle allows
+    void warm_up(Print *log)
+    {
+      if (health == HEALTH_WARMING)
+      {
+        int8_t state = module.warm();
+
+        if (state > 0)
+        {
+          health = HEALTH_DEGRADED;
+          if (log)
+          {
+            log->print((const __FlashStringHelper *)M::name);
+            log->println(F(": ready"));
+          }
+        }
+        else if (state < 0)
+        {
+          go_offline();
+          report_failure(log);
+        }
+      }
+
+      next_type::warm_up(log);
+    }
+
+    // Starts every module and polls them round-robin until all are done, so
+    // a cycle lasts as long as the slowest sensor
+    void run(sample_type &sample)
+    {
+      start();
+      while (!poll(sample))
+        ;
+    }
+
+    void print(Print &out, const sample_type &sample, uint8_t index = 0)
+    {
+      if (sample.offline & (1 << index))
+      {
+        out.print((const __FlashStringHelper *)M::name);
+        if (health == HEALTH_DISABLED)
+          out.print(F(":disabled"));
+        else
+          out.print(health == HEALTH_WARMING ? F(":warming up") : F(":offline"));
+      }
+      else
+        module.read4print(sample.value, out);
+      out.print(",");
+      next_type::print(out, sample, index + 1);
+    }
+
+    // Hands the acquisition time of each module to profiler.record(),
+    // starting with phase for the first module
+    template <class Profiler>
+    void report(Profiler &profiler, uint8_t phase)
+    {
+      profiler.record(phase, elapsed_us);
+      next_type::report(profiler, phase + 1);
+    }
+
+    template <class Sink>
+    static void columns(const sample_type &sample, Sink &sink, uint8_t index = 0)
+    {
+      if (sample.offline & (1 << index))
+      {
+        Empty_Columns<Sink> empty(sink);
+
+        M::columns(sample.value, empty);
+      }
+      else
+        M::columns(sample.value, sink);
+      next_type::columns(sample, sink, index + 1);
+    }
+
+    static void header(Print &out)
+    {
+      out.print(",");
+      out.print((const __FlashStringHelper *)M::header);
+      next_type::header(out);
+    }
+
+    // PROGMEM name of the module at index, disabled ones included
+    static const char *name_of(uint8_t index)
+    {
+      return index == 0 ? M::name : next_type::name_of(index - 1);
+    }
+
+    M module;
+
+  private:
+    // begin() and the first warm() step, in warm()'s terms
+    int8_t begin_module()
+    {
+      if (!module.begin())
+        return -1;
+
+      return module.warm();
+    }
+
+    void report_failure(Print *log)
+    {
+      if (log)
+      {
+        log->print(F("Error: Failed to initialize "));
+        log->print((const __FlashStringHelper *)M::name);
+        log->println(F("!"));
+      }
+    }
+
+    // A good reading makes the module OK, a run of failed ones OFFLINE
+    void update(bool valid)
+    {
+      if (valid)
+      {
+        health = HEALTH_OK;
+        failures = 0;
+        retry_ms = HEALTH_RETRY_MIN_MS;
+      }
+      else if (++failures >= HEALTH_OFFLINE_FAILURES)
+        go_offline();
+      else
+        health = HEALTH_DEGRADED;
+    }
+
+    void go_offline()
+    {
+      health = HEALTH_OFFLINE;
+      failures = 0;
+      offline_ms = millis();
+    }
+
+    unsigned long start_us;
+    unsigned long elapsed_us;
+    bool done;
+
+    uint8_t health;
+    uint8_t failures;
+    unsigned long offline_ms;
+    unsigned long retry_ms;
+};
+
+template <class M, class... Rest>
+class Sensor_Registry<Disabled<M>, Rest...> : public Sensor_Registry<Rest...>
+{
+    typedef Sensor_Registry<Rest...> next_type;
+
+  public:
+    typedef typename next_type::sample_type sample_type;
+
+    static const uint8_t column_count = M::column_count + next_type::column_count;
+    static const uint8_t enabled_column_count = next_type::enabled_column_count;
+    static const uint8_t module_count = 1 + next_type::module_count;
+
+    bool begin(Print *log, uint16_t mask = 0xFFFF, uint8_t index = 0)
+    {
+      return next_type::begin(log, mask, index + 1);
+    }
+
+    bool poll(sample_type &sample, uint8_t index = 0)
+    {
+      return next_type::poll(sample, index + 1);
+    }
+
+    void run(sample_type &sample)
+    {
+      next_type::start();
+      while (!poll(sample))
+        ;
+    }
+
+    template <class Profiler>
+    void report(Profiler &profiler, uint8_t phase)
+    {
+      next_type::report(profiler, phase + 1);
+    }
+
+    void print(Print &out, const sample_type &sample, uint8_t index = 0)
+    {
+      next_type::print(out, sample, index + 1);
+    }
+
+    template <class Sink>
+    static void columns(const sample_type &sample, Sink &sink, uint8_t index = 0)
+    {
+      sink.disabled(M::column_count);
+      next_type::columns(sample, sink, index + 1);
+    }
+
+    static void header(Print &out)
+    {
+      out.print(",");
+      out.print((const __FlashStringHelper *)M::header);
+      next_type::header(out);
+    }
+
+    static const char *name_of(uint8_t index)
+    {
+      return index == 0 ? M::name : next_type::name_of(index - 1);
+    }
+};
+
+#endif  //_SENSOR_REGISTRY_H
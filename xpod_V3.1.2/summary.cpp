@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * @file    summary.cpp
+ * @brief   Running per-column statistics of the samples, for the 1-minute
+ *          and hourly summary logs.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "summary.h"
+#include "fixed_point.h"
+
+void Column_Stats::clear()
+{
+  count = 0;
+  decimals = 0;
+  mean = 0;
+  m2 = 0;
+  min = 0;
+  max = 0;
+}
+
+// Welford's update, stable where sum and sum of squares are not
+void Column_Stats::add(float value, uint8_t decimals)
+{
+  if (count == 0 || value < min)
+    min = value;
+  if (count == 0 || value > max)
+    max = value;
+  if (decimals > this->decimals)
+    this->decimals = decimals;
+
+  count++;
+  float delta = value - mean;
+  mean += delta / count;
+  m2 += delta * (value - mean);
+}
+
+void Column_Stats::merge(const Column_Stats &other)
+{
+  if (other.count == 0)
+    return;
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  uint16_t total = count + other.count;
+  float delta = other.mean - mean;
+
+  mean += delta * other.count / total;
+  m2 += other.m2 + delta * delta * ((float)count * other.count / total);
+  min = other.min < min ? other.min : min;
+  max = other.max > max ? other.max : max;
+  if (other.decimals > decimals)
+    decimals = other.decimals;
+  count = total;
+}
+
+void Column_Stats::print(Print &out) const
+{
+  if (count == 0)
+  {
+    out.print(F(",,,"));
+    return;
+  }
+
+  // One more decimal than the readings for the mean and deviation
+  print_float(out, mean, decimals + 1);
+  out.print(',');
+  print_float(out, min, decimals);
+  out.print(',');
+  print_float(out, max, decimals);
+  out.print(',');
+  print_float(out, count > 1 ? sqrt(m2 / (count - 1)) : 0, decimals + 1);
+}
+
+/******************************  Summary header  ******************************/
+Summary_Header::Summary_Header(Print &out, const uint8_t *summarized, uint8_t time_column)
+    : out(out), summarized(summarized), time_column(time_column), column(0), length(0),
+      first(true)
+{
+}
+
+size_t Summary_Header::write(uint8_t c)
+{
+  if (c == ',')
+    end_name();
+  else if (length < sizeof(name))
+    name[length++] = c;
+  return 1;
+}
+
+void Summary_Header::finish()
+{
+  end_name();
+}
+
+// The time column keeps its name, a summarized one becomes four
+void Summary_Header::end_name()
+{
+  static const char suffixes[][6] = {"_mean", "_min", "_max", "_sd"};
+  uint8_t i = column++;
+  bool summary = i < SUMMARY_MAX_LAYOUT && (summarized[i / 8] & (1 << (i % 8)));
+
+  if (i == time_column || summary)
+  {
+    for (uint8_t k = 0; k < (summary ? 4 : 1); k++)
+    {
+      if (!first)
+        out.write(',');
+      first = false;
+      out.write((const uint8_t *)name, length);
+      if (summary)
+        out.print(suffixes[k]);
+    }
+  }
+
+  length = 0;
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * @file    summary.h
+ * @brief   Running per-column statistics of the samples, for the 1-minute
+ *          and hourly summary logs.
+ *
+ *          Sample_Summary is a column sink: sample_columns() feeds it every
+ *          sample, each numeric column of an enabled module goes into its
+ *          own Column_Stats (count, mean, min, max and, by Welford's method,
+ *          the sum of squared deviations). An empty column counts nothing.
+ *          Text, time and disabled columns are not summarized.
+ *
+ *          A longer period is built by merging the shorter ones (Chan et
+ *          al.), the hourly summary never sees the samples.
+ *
+ *          A summary line has the period's start, then mean, min, max and
+ *          standard deviation of each summarized column, then the number of
+ *          samples. print_header() derives its header from the raw log's.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _SUMMARY_H
+#define _SUMMARY_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+// Columns of the raw log line a summary can follow
+#define SUMMARY_MAX_LAYOUT    96
+
+struct Column_Stats
+{
+    uint16_t count;
+    uint8_t decimals;
+    float mean;
+    float m2;
+    float min;
+    float max;
+
+    void clear();
+    void add(float value, uint8_t decimals);
+    void merge(const Column_Stats &other);
+    // mean,min,max,sd or four empty columns
+    void print(Print &out) const;
+};
+
+// Rewrites the raw log's header names as the summary's
+class Summary_Header : public Print
+{
+  public:
+    Summary_Header(Print &out, const uint8_t *summarized, uint8_t time_column);
+
+    size_t write(uint8_t c);
+    using Print::write;
+    // Ends the last name
+    void finish();
+
+  private:
+    void end_name();
+
+    Print &out;
+    const uint8_t *summarized;
+    uint8_t time_column;
+    uint8_t column;
+    char name[32];
+    uint8_t length;
+    bool first;
+};
+
+template <uint8_t N>
+class Sample_Summary
+{
+  public:
+    Sample_Summary() : samples(0), slots(0), slot(0), column(0), time_column(0xFF)
+    {
+      memset(summarized, 0, sizeof(summarized));
+      clear();
+    }
+
+    void clear()
+    {
+      for (uint8_t i = 0; i < N; i++)
+        stats[i].clear();
+      samples = 0;
+    }
+
+    /*  Column sink  */
+    void begin()
+    {
+      slot = 0;
+      column = 0;
+    }
+
+    void put_int(long value) { add(value, 0); }
+    void put_uint(unsigned long value) { add(value, 0); }
+    void put_float(float value, uint8_t decimals) { add(value, decimals); }
+
+    void put_fixed(long value, uint8_t decimals)
+    {
+      float scaled = value;
+
+      for (uint8_t i = 0; i < decimals; i++)
+        scaled /= 10;
+      add(scaled, decimals);
+    }
+
+    void put_str(const char *value) { column++; }
+
+    void put_time(const DateTime &value) { time_column = column++; }
+
+    // A missing reading, the column still has its statistics
+    void skip() { add(NAN, 0); }
+
+    void disabled(uint8_t columns) { column += columns; }
+
+    void end()
+    {
+      slots = slot;
+      samples++;
+    }
+
+    // Adds a shorter period that followed the ones merged so far
+    void merge(const Sample_Summary &other)
+    {
+      for (uint8_t i = 0; i < N; i++)
+        stats[i].merge(other.stats[i]);
+      samples += other.samples;
+      slots = other.slots;
+      memcpy(summarized, other.summarized, sizeof(summarized));
+      time_column = other.time_column;
+    }
+
+    // Header of the summary file, from the raw header that `header` prints
+    void print_header(Print &out, void (*header)(Print &out)) const
+    {
+      Summary_Header names(out, summarized, time_column);
+
+      header(names);
+      names.finish();
+      out.print(F(",Samples"));
+    }
+
+    void print(Print &out, const DateTime &start) const
+    {
+      char timestamp[] = "YYYY-MM-DDThh:mm:ss";
+      DateTime copy = start;
+
+      out.print(copy.toString(timestamp));
+      for (uint8_t i = 0; i < slots; i++)
+      {
+        out.print(',');
+        stats[i].print(out);
+      }
+      out.print(',');
+      out.print(samples);
+    }
+
+    uint16_t samples;
+
+  private:
+    void add(float value, uint8_t decimals)
+    {
+      if (slot < N && column < SUMMARY_MAX_LAYOUT)
+      {
+        if (!isnan(value) && !isinf(value))
+          stats[slot].add(value, decimals);
+        summarized[column / 8] |= 1 << (column % 8);
+        slot++;
+      }
+      column++;
+    }
+
+    Column_Stats stats[N];
+    uint8_t slots;
+    uint8_t summarized[(SUMMARY_MAX_LAYOUT + 7) / 8];
+    uint8_t slot;
+    uint8_t column;
+    uint8_t time_column;
+};
+
+#endif  //_SUMMARY_H
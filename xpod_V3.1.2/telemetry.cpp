@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * @file    telemetry.cpp
+ * @brief   Binary serial frames of the per-cycle sample.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include "telemetry.h"
+#include "crc16.h"
+#include "fixed_point.h"
+#include "line_buffer.h"
+
+Telemetry_Frame::Telemetry_Frame(Print &out) : out(out)
+{
+  block_len = 0;
+  crc = CRC16_INIT;
+}
+
+// A leading delimiter ends whatever text went out before the frame
+void Telemetry_Frame::begin(uint8_t type)
+{
+  out.write((uint8_t)0);
+  block_len = 0;
+  crc = CRC16_INIT;
+
+  write((uint8_t)TELEMETRY_VERSION);
+  write(type);
+}
+
+void Telemetry_Frame::end()
+{
+  uint16_t sum = crc;
+
+  encode(sum & 0xFF);
+  encode(sum >> 8);
+  flush_block();
+  out.write((uint8_t)0);
+}
+
+size_t Telemetry_Frame::write(uint8_t c)
+{
+  crc = crc16_update(crc, c);
+  encode(c);
+
+  return 1;
+}
+
+// A zero closes the block, its position is the code byte
+void Telemetry_Frame::encode(uint8_t c)
+{
+  if (c == 0)
+  {
+    flush_block();
+    return;
+  }
+
+  block[block_len++] = c;
+
+  // A full block has no implied zero, 0xFF says so
+  if (block_len == COBS_BLOCK_SIZE)
+  {
+    out.write((uint8_t)(COBS_BLOCK_SIZE + 1));
+    out.write(block, block_len);
+    block_len = 0;
+  }
+}
+
+void Telemetry_Frame::flush_block()
+{
+  out.write((uint8_t)(block_len + 1));
+  out.write(block, block_len);
+  block_len = 0;
+}
+
+void Telemetry_Frame::put_le(uint8_t tag, uint32_t value)
+{
+  write(tag);
+  write(value & 0xFF);
+  write((value >> 8) & 0xFF);
+  write((value >> 16) & 0xFF);
+  write(value >> 24);
+}
+
+void Telemetry_Frame::put_int(long value)
+{
+  put_le(TELEMETRY_INT, (uint32_t)value);
+}
+
+void Telemetry_Frame::put_uint(unsigned long value)
+{
+  put_le(TELEMETRY_UINT, value);
+}
+
+// nan, inf and out of range values go as the text print_float() gives them
+void Telemetry_Frame::put_float(float value, uint8_t decimals)
+{
+  int32_t fixed;
+
+  if (to_fixed(value, decimals, fixed))
+  {
+    put_fixed(fixed, decimals);
+  }
+  else
+  {
+    char text[FIXED_MAX_CHARS];
+    Line_Buffer buf(text, sizeof(text));
+
+    print_float(buf, value, decimals);
+    put_str(buf.c_str());
+  }
+}
+
+void Telemetry_Frame::put_fixed(long value, uint8_t decimals)
+{
+  put_le(TELEMETRY_FIXED | (decimals & 0x0F), (uint32_t)value);
+}
+
+void Telemetry_Frame::put_str(const char *value)
+{
+  size_t len = strlen(value);
+
+  if (len > 255)
+    len = 255;
+
+  write((uint8_t)TELEMETRY_TEXT);
+  write((uint8_t)len);
+  write((const uint8_t *)value, len);
+}
+
+void Telemetry_Frame::put_time(const DateTime &value)
+{
+  put_le(TELEMETRY_TIME, value.unixtime());
+}
+
+void Telemetry_Frame::skip()
+{
+  write((uint8_t)TELEMETRY_SKIP);
+}
+
+void Telemetry_Frame::disabled(uint8_t columns)
+{
+  for (uint8_t i = 0; i < columns; i++)
+    skip();
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * @file    telemetry.h
+ * @brief   Binary serial frames of the per-cycle sample.
+ *
+ *          The labelled text of read4print() is 5-10x the size of the data.
+ *          In binary mode the console carries one frame per cycle instead:
+ *
+ *            0x00 | COBS( version | type | payload | crc16 ) | 0x00
+ *
+ *          COBS removes every zero from the frame so 0x00 only delimits;
+ *          text on the same port (boot messages, the 'p' dump) ends up in
+ *          a frame that fails its CRC and is skipped. The CRC is
+ *          CRC-16/CCITT-FALSE over version to payload, little-endian like
+ *          every other multi-byte field.
+ *
+ *          A sample frame holds the columns of the SD log in order, each a
+ *          tag byte (type in the high nibble, decimals in the low one) and
+ *          a fixed-width value:
+ *            SKIP    nothing, an empty column
+ *            INT     int32
+ *            UINT    uint32
+ *            FIXED   int32 scaled by 10^decimals
+ *            TIME    uint32 unix time, printed YYYY-MM-DDThh:mm:ss
+ *            TEXT    uint8 length and the characters
+ *          A header frame holds the header line of the SD log as text.
+ *
+ *          tools/xpod_telemetry.cpp turns a capture back into the CSV lines
+ *          the SD card gets.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#define TELEMETRY_VERSION     1
+
+#define TELEMETRY_HEADER      'H'
+#define TELEMETRY_SAMPLE      'S'
+
+#define TELEMETRY_SKIP        0x00
+#define TELEMETRY_INT         0x10
+#define TELEMETRY_UINT        0x20
+#define TELEMETRY_FIXED       0x30
+#define TELEMETRY_TIME        0x40
+#define TELEMETRY_TEXT        0x50
+
+// Longest run of COBS data bytes behind one code byte
+#define COBS_BLOCK_SIZE       254
+
+// Payload bytes go through write(), the put_*() calls are the column sink
+// of csv_writer.h
+class Telemetry_Frame : public Print
+{
+  public:
+    Telemetry_Frame(Print &out);
+
+    void begin(uint8_t type);
+    void end();
+
+    size_t write(uint8_t c);
+    using Print::write;
+
+    void put_int(long value);
+    void put_uint(unsigned long value);
+    void put_float(float value, uint8_t decimals);
+    void put_fixed(long value, uint8_t decimals);
+    void put_str(const char *value);
+    void put_time(const DateTime &value);
+    void skip();
+    void disabled(uint8_t columns);
+
+  private:
+    void put_le(uint8_t tag, uint32_t value);
+    void encode(uint8_t c);
+    void flush_block();
+
+    Print &out;
+    uint8_t block[COBS_BLOCK_SIZE];
+    uint8_t block_len;
+    uint16_t crc;
+};
+
+#endif  //_TELEMETRY_H
@@ -8,6 +8,13 @@
   * @date 	  August 23, 2023
   ******************************************************************************/
 #include "wind_vane.h"
+#include "fixed_point.h"
+
+const char MET_Module::name[] PROGMEM = "MET";
+const char MET_Module::header[] PROGMEM = "Wind_speed,wind_dir";
+
+volatile unsigned long MET_Module::lastWindIRQ = 0;
+volatile byte MET_Module::windClicks = 0;
 
 // Here we're defining the wind vane "object"
 wind_vane::wind_vane()
@@ -25,10 +32,10 @@ float wind_vane::get_direction()
 }
 
 // This translates the directional voltage into a cardinal direction
-String wind_vane::cardinal_direction(float directionVoltage)
+const char *wind_vane::cardinal_direction(float directionVoltage)
 {
   float windVane = directionVoltage;
-	String compass = "";
+	const char *compass;
 	if(windVane > 4.61)       compass = "W";     //W
 	else if(windVane > 4.33)  compass = "NW";    //NW
 	else if(windVane > 4.03)  compass = "WNW";   //WNW
@@ -73,3 +80,77 @@ float wind_vane::degree_direction(float directionVoltage)
 
   return(degrees);
 }
+
+MET_Module::MET_Module()
+{
+  lastWindCheck = 0;
+}
+
+bool MET_Module::begin()
+{
+  attachInterrupt(digitalPinToInterrupt(WIND_SPEED_PIN), wspeedIRQ, FALLING);
+  return true;
+}
+
+void MET_Module::wspeedIRQ()
+{
+  if(millis() - lastWindIRQ > 10)
+  {
+    lastWindIRQ = millis();
+    windClicks++;
+  }
+}
+
+int8_t MET_Module::warm()
+{
+  return 1;
+}
+
+void MET_Module::start()
+{
+}
+
+bool MET_Module::poll()
+{
+  return true;
+}
+
+void MET_Module::abort()
+{
+}
+
+bool MET_Module::collect(met_sample_t &sample)
+{
+  sample.wind_speed = get_wind_speed();
+  sample.wind_dir_volt = windVane.get_direction();
+  sample.wind_dir_degree = windVane.degree_direction(sample.wind_dir_volt);
+  return true;
+}
+
+void MET_Module::read4print(const met_sample_t &sample, Print &out)
+{
+  out.print(F("Wind Speed: "));
+  print_float(out, sample.wind_speed, 2);
+  out.print(F(", Wind Direction: "));
+  print_float(out, sample.wind_dir_degree, 2);
+  out.print(F(" ("));
+  out.print(windVane.cardinal_direction(sample.wind_dir_volt));
+  out.print(')');
+}
+
+//Returns the instataneous wind speed
+float MET_Module::get_wind_speed()
+{
+  float deltaTime = millis() - lastWindCheck; //750ms
+
+  deltaTime /= 1000.0; //Covert to seconds
+
+  float windSpeed = (float)windClicks / deltaTime; //3 / 0.750s = 4
+
+  windClicks = 0; //Reset and start watching for new wind
+  lastWindCheck = millis();
+
+  windSpeed *= 1.492; //4 * 1.492 = 5.968MPH
+
+  return (windSpeed);
+}
@@ -13,16 +13,61 @@
 #include <Arduino.h>
 
 #define WINDVANE_PIN      A15
+#define WIND_SPEED_PIN    3
+#define MET_BUDGET_MS     100
+
+struct met_sample_t
+{
+    float wind_speed;
+    float wind_dir_volt;
+    float wind_dir_degree;
+};
 
 class wind_vane
 {
   public:
     wind_vane();
     float get_direction();
-    String cardinal_direction(float directionVoltage);
+    const char *cardinal_direction(float directionVoltage);
     float degree_direction(float directionVoltage);
   private:
     bool status;
 };
 
+// Wind speed and direction as a sensor module
+class MET_Module
+{
+  public:
+    typedef met_sample_t sample_type;
+
+    static const uint8_t column_count = 2;
+    static const uint16_t budget_ms = MET_BUDGET_MS;
+    static const char name[] PROGMEM;
+    static const char header[] PROGMEM;
+
+    MET_Module();
+    bool begin();
+    int8_t warm();
+    void start();
+    bool poll();
+    bool collect(met_sample_t &sample);
+    void abort();
+    void read4print(const met_sample_t &sample, Print &out);
+
+    template <class Sink>
+    static void columns(const met_sample_t &sample, Sink &sink)
+    {
+      sink.put_float(sample.wind_speed, 2);
+      sink.put_float(sample.wind_dir_degree, 2);
+    }
+  private:
+    static void wspeedIRQ();
+    float get_wind_speed();
+
+    wind_vane windVane;
+    unsigned long lastWindCheck;
+    static volatile unsigned long lastWindIRQ;
+    static volatile byte windClicks;
+};
+
 #endif /* wind_vane.h */
\ No newline at end of file
@@ -17,83 +17,155 @@
 #include <Wire.h>
 #include <SPI.h>
 #include <SdFat.h>
-#include <s300i2c.h>
+#include <RingBuf.h>
 #include <avr/wdt.h>
 
 #include "digipot.h"
-#include "ads_module.h"
-#include "bme_module.h"
+#include "csv_writer.h"
+#include "line_buffer.h"
+#include "profiler.h"
+#include "format_bench.h"
+#include "console_serial.h"
+#include "telemetry.h"
+#include "paced_print.h"
+#include "xpod_sample.h"
+#include "xpod_config.h"
 
-String xpodID = "OPOD12";
+#if BIN_LOG_ENABLED
+#include "bin_log.h"
+Bin_Log bin_log;
+// Set when a day's file could not take the records, see open_log()
+uint8_t log_part = 0;
+#endif
+
+const char xpodID[] = "OPOD12";
 SdFat sd;
 SdFile file;
 
-#if GPS_ENABLED
-#include "gps_module.h"
-GPS_Module gps_module;
-#endif
-
 #if RTC_ENABLED
 #include <RTClib.h>
 RTC_DS3231 rtc;
 DateTime rtc_date_time;
 #endif
 
-#if QUAD_ENABLED
-#include "quad_module.h"
-QUAD_Module quad_module;
-#endif
+#if SQW_PACING_ENABLED
+#include "sample_clock.h"
+Sample_Clock sample_clock;
 
-#if MQ_ENABLED
-#include "mq_module.h"
-MQ_Module mq_module;
+// The interrupt pins all have other drivers, which would fight the DS3231's
+// open-drain SQW output
+#if PMS_ENABLED && (RTC_SQW_PIN == 18 || RTC_SQW_PIN == 19)
+#error "RTC_SQW_PIN is a Serial1 pin, which PMS_SERIAL uses"
+#elif RTC_SQW_PIN == 20 || RTC_SQW_PIN == 21
+#error "RTC_SQW_PIN is an I2C pin"
+#elif MET_ENABLED && RTC_SQW_PIN == WIND_SPEED_PIN
+#error "RTC_SQW_PIN is the wind speed input"
+#elif RTC_SQW_PIN == MOTOR_CTRL_OUT_PIN
+#error "RTC_SQW_PIN is the motor control output"
+#endif
 #endif
 
-#if PMS_ENABLED
-#include "pms_module.h"
-PMS_Module pms_module;
+#if PROFILER_ENABLED
+Loop_Profiler profiler;
 #endif
 
-#if OPC_ENABLED
-#include "OPC.h"
-OPC opc;
-particleData opcData;
+#if RAM_MONITOR_ENABLED
+#include "ram_monitor.h"
+RAM_Monitor ram_monitor;
 #endif
 
-#if MET_ENABLED
-  #include "wind_vane.h"
-  long lastWindCheck = 0;
-  volatile long lastWindIRQ = 0;
-  volatile byte windClicks = 0;
-  wind_vane windVane;
+#if IDLE_SLEEP_ENABLED
+#include "idle_sleep.h"
+Idle_Sleep idle_sleep;
 #endif
 
 /*************  Global Declarations  *************/
-// Modules
-S300I2C co2_sensor(Wire);
-ADS_Module ads_module;
-BME_Module bme_module;
+// Modules, see xpod_sample.h for the list
+xpod_sensors_t sensors;
 
 // Variables
-String fileName;
+char fileName[32];
+xpod_sample_t sample;
 
-/******************  Functions  ******************/
-#if MET_ENABLED
-  void wspeedIRQ()
-  {
-    if(millis() - lastWindIRQ > 10)
-    {
-      lastWindIRQ = millis();
-      windClicks++;
-    }
-  }
+#if SERIAL_LOG_ENABLED && TELEMETRY_ENABLED
+Telemetry_Frame telemetry(CONSOLE);
+#endif
+
+// A log line is formatted here and written to the card in one go
+char line_buf[LINE_BUFFER_SIZE];
+Line_Buffer line(line_buf, sizeof(line_buf));
+
+#define DOWNLOAD_SERVER (DOWNLOAD_ENABLED && SDCARD_LOG_ENABLED && SERIAL_LOG_ENABLED)
+#if DOWNLOAD_SERVER
+#include "download.h"
+// Reads sectors into line_buf, which is free between cycles
+static_assert(LINE_BUFFER_SIZE >= DOWNLOAD_BLOCK_SIZE, "a sector has to fit in line_buf");
+Download_Server download(sd, CONSOLE, (uint8_t *)line_buf);
+#endif
+
+#if SDCARD_LOG_ENABLED
+#include "log_record.h"
+Log_Sequence log_seq;
+
+// Log output waits here until it fills a sector, see drain_log()
+RingBuf<SdFile, LOG_RING_SIZE> log_ring;
+static_assert(LOG_RING_SIZE >= LINE_BUFFER_SIZE + 512, "a record has to fit next to a partial sector");
+
+#if LOG_INDEX_ENABLED && !BIN_LOG_ENABLED
+#include "log_index.h"
+Log_Index log_index;
+#endif
+#endif
+
+#if SUMMARY_ENABLED && SDCARD_LOG_ENABLED && RTC_ENABLED
+#include "summary.h"
+// Time, input voltage and the stale and overrun counts around the modules
+typedef Sample_Summary<xpod_sensors_t::enabled_column_count + 5> xpod_summary_t;
+xpod_summary_t minute_summary, hour_summary;
+#endif
+
+// The IDE generates these, plain C++ builds (see host/) need them spelled out
+void acquire_sample(xpod_sample_t &sample);
+void print_sample(const xpod_sample_t &sample);
+void send_telemetry(const xpod_sample_t &sample);
+void write_header(Print &out);
+void write_log_header(Print &out);
+void report_dropped(uint8_t records);
+uint32_t date_key(const DateTime &date);
+void set_file_name(const DateTime &date);
+bool open_log();
+bool drain_log(bool wait);
+bool reserve_log(size_t size);
+bool sync_log();
+void close_log();
+bool write_record(const xpod_sample_t &sample);
+void log_sample(const xpod_sample_t &sample);
+void write_columns(Print &out, const xpod_sample_t &sample);
+#if SUMMARY_ENABLED && SDCARD_LOG_ENABLED && RTC_ENABLED
+void summarize_sample(const xpod_sample_t &sample);
+void write_summary(const xpod_summary_t &summary, const DateTime &start,
+                   const __FlashStringHelper *suffix);
 #endif
+unsigned long profile(uint8_t phase, unsigned long since);
+void serial_commands();
+bool console_quiet();
+void idle_console();
+void idle_wait();
+void init_tasks();
+void account_cycle(unsigned long start_us);
+void log_profile(const DateTime &timestamp);
+void check_ram();
 
+/******************  Functions  ******************/
 void setup()
 {
+  #if RAM_MONITOR_ENABLED
+    ram_monitor.begin();
+  #endif
+
   #if SERIAL_LOG_ENABLED
-  Serial.begin(9600);
-  Serial.println();
+  console_begin();
+  CONSOLE.println();
   #endif
   
   // In voltage
@@ -114,11 +186,23 @@ void setup()
     digitalWrite(STATUS_HALTED, HIGH);
     if (!sd.begin(SD_CARD_CS_PIN)) {
       #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Card failed, or not present");
+        CONSOLE.println("Error: Card failed, or not present");
       #endif
       digitalWrite(SD_CARD_CS_PIN,HIGH);
       // while(1);
     }
+    log_seq.begin();
+
+    #if CONFIG_FILE_ENABLED
+      if (config_load(CONFIG_FILE_NAME, SERIAL_LOG_ENABLED ? &CONSOLE : NULL,
+                      xpod_sensors_t::name_of, xpod_sensors_t::module_count))
+      {
+        #if SERIAL_LOG_ENABLED
+          CONSOLE.println(F("Settings from " CONFIG_FILE_NAME ":"));
+          config_print(CONSOLE, xpod_sensors_t::name_of, xpod_sensors_t::module_count);
+        #endif
+      }
+    #endif
   #endif
   
   SPI.transfer(0);
@@ -126,303 +210,858 @@ void setup()
     if (!rtc.begin())
     {
       #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize RTC module");
+        CONSOLE.println("Error: Failed to initialize RTC module");
       #endif
     }
     else{
       //rtc.adjust(DateTime(F(__DATE__),F(__TIME__)));    // Only run uncommented once to initialize RTC
       rtc_date_time = rtc.now();
+
+      #if SQW_PACING_ENABLED
+        if (!sample_clock.begin(rtc, RTC_SQW_PIN, xpod_config.sample_period_s))
+        {
+          #if SERIAL_LOG_ENABLED
+            CONSOLE.println("Error: RTC_SQW_PIN is not an interrupt pin, using millis() pacing");
+          #endif
+        }
+      #endif
     }
   #endif
 
-  if (!co2_sensor.begin(CO2_I2C_ADDR))
-  {
-    #if SERIAL_LOG_ENABLED
-      Serial.println("Error: Failed to initialize CO2 sensor!");
-    #endif
-  }
+  // Clocked out between the first cycles by init_tasks(), the ADS1115
+  // module stays warming until they are set
+  initpots();
+  QueuePotLevel(0, 0);
+  QueuePotLevel(1, 0);
+  QueuePotLevel(2, 80);
 
+  sensors.begin(SERIAL_LOG_ENABLED ? &CONSOLE : NULL, xpod_config.module_mask);
 
-  if (!bme_module.begin())
-  {
-    #if SERIAL_LOG_ENABLED
-      Serial.println("Error: Failed to initialize BME sensor!");
-    #endif
-  }
+  #if PROFILER_ENABLED
+    static_assert(PROFILE_SENSORS + xpod_sensors_t::module_count <= PROFILER_MAX_PHASES,
+                  "PROFILER_MAX_PHASES is too small for the sensor list");
+    profiler.begin(PROFILE_SENSORS + xpod_sensors_t::module_count, xpod_sensors_t::name_of);
+  #endif
 
-  if (!ads_module.begin())
-  {
-    #if SERIAL_LOG_ENABLED
-      Serial.println("Error: Failed to initialize one of the ADS1115 module!");
-    #endif
-  }
+  file.close();
+
+  #if FORMAT_BENCH_ENABLED && SERIAL_LOG_ENABLED
+    run_format_bench(CONSOLE);
+  #endif
+
+  // The drivers' begin() calls are the deepest stack so far
+  #if RAM_MONITOR_ENABLED && SERIAL_LOG_ENABLED
+    ram_monitor.scan();
+    ram_monitor.print(CONSOLE);
+  #endif
   
-  #if QUAD_ENABLED
-    if (!quad_module.begin())
+  //delay(10000);
+  wdt_enable(WDTO_8S);
+  //Serial.println("reset");
+}
+
+void loop()
+{
+  wdt_reset();
+  unsigned long startLoop = millis();
+  unsigned long cycle_us = micros();
+  unsigned long phase_us;
+  int motor_ctrl_val;
+
+  #if PROFILER_ENABLED
+    account_cycle(cycle_us);
+  #endif
+
+  acquire_sample(sample);
+
+  #if RAM_MONITOR_ENABLED
+    ram_monitor.update();
+  #endif
+
+  #if SERIAL_LOG_ENABLED
+    phase_us = micros();
+    if (!console_quiet())
     {
-      #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize Quad Stat!");
+      #if TELEMETRY_ENABLED
+        send_telemetry(sample);
+      #else
+        print_sample(sample);
       #endif
     }
+    profile(PROFILE_SERIAL, phase_us);
   #endif
-  
-  #if MQ_ENABLED
-    if (!mq_module.begin())
+
+  #if SDCARD_LOG_ENABLED
+    log_sample(sample);
+  #endif
+
+  #if SUMMARY_ENABLED && SDCARD_LOG_ENABLED && RTC_ENABLED
+    summarize_sample(sample);
+  #endif
+
+  // // Motor control
+  motor_ctrl_val = analogRead(MOTOR_CTRL_IN_PIN);
+  motor_ctrl_val = (((float)motor_ctrl_val / 1024) * 255);
+  //motor_ctrl_val = 200; // use this to hardcode the motor speed; the number ranges from 0-255
+  analogWrite(MOTOR_CTRL_OUT_PIN, motor_ctrl_val);
+
+  digitalWrite(STATUS_RUNNING, LOW);
+  #if SERIAL_LOG_ENABLED && !TELEMETRY_ENABLED
+    if (!console_quiet())
+      CONSOLE.print("\n");
+  #endif
+
+  // Offline sensors whose retry is due
+  #if SERIAL_LOG_ENABLED
+    sensors.probe(console_quiet() ? NULL : &CONSOLE);
+  #else
+    sensors.probe(NULL);
+  #endif
+
+  profile(PROFILE_CYCLE, cycle_us);
+
+  #if PROFILER_ENABLED || DOWNLOAD_SERVER
+    serial_commands();
+  #endif
+
+  // End of a profiler window, in every build so that its sums cannot
+  // overflow
+  #if PROFILER_ENABLED
+    if (profiler.cycles() >= PROFILER_LOG_CYCLES)
     {
-      #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize MQ sensor!");
+      #if RAM_MONITOR_ENABLED
+        check_ram();
       #endif
+      #if DIAG_LOG_ENABLED && SDCARD_LOG_ENABLED
+        log_profile(sample.timestamp);
+      #endif
+      profiler.reset();
     }
   #endif
-  
-  #if PMS_ENABLED
-    if (!pms_module.begin())
+
+  // This all controls how long the loop lasts
+  #if SQW_PACING_ENABLED
+    #if DOWNLOAD_SERVER
+      if (sample_clock.wait(idle_console))
+        return;
+    #else
+      if (sample_clock.wait(idle_wait))
+        return;
+    #endif
+
+    // The SQW signal was lost, millis() pacing until it is back
+    static uint32_t sqw_faults = 0;
+    if (sample_clock.faults() != sqw_faults)
     {
+      sqw_faults = sample_clock.faults();
       #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize PM sensor!");
+        CONSOLE.println(F("Error: No RTC SQW ticks, using millis() pacing"));
       #endif
     }
   #endif
 
-  #if OPC_ENABLED
-    if(!opc.begin()){
-      #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize OPC!");
-      #endif
+  // Pad the cycle up to loop_period_ms, a slow acquisition is not stretched.
+  // A download gets the time that is left.
+  #if DOWNLOAD_SERVER
+    while (millis() - startLoop < xpod_config.loop_period_ms)
+    {
+      serial_commands();
+      if (!download.service(xpod_config.loop_period_ms - (millis() - startLoop)))
+        idle_wait();
     }
+  #else
+    while (millis() - startLoop < xpod_config.loop_period_ms)
+      idle_wait();
   #endif
+}
+
+// Reads every sensor once, the outputs below only format this record
+void acquire_sample(xpod_sample_t &sample)
+{
+  unsigned long phase_us = micros();
+
+  #if RTC_ENABLED
+    sample.timestamp = rtc.now();
+  #endif
+  profile(PROFILE_RTC, phase_us);
+
+  sensors.run(sample.sensors);
+
+  #if PROFILER_ENABLED
+    sensors.report(profiler, PROFILE_SENSORS);
+  #endif
+
+  #if SQW_PACING_ENABLED
+    sample.overruns = sample_clock.overruns();
+  #endif
+
+  sample.in_volt = (analogRead(IN_VOLT_PIN) * 5.02 * 5) / 1023.0; //Follow up with rylee
+}
+
+#if SERIAL_LOG_ENABLED
+void print_sample(const xpod_sample_t &sample)
+{
+  digitalWrite(SD_CARD_CS_PIN,LOW);
+  if(!CONSOLE) {  //check if Serial is available... if not,
+    CONSOLE.end();      // close serial port
+    delay(100);        //wait 100 millis
+    console_begin(); // reenable serial again
+  }
 
-  #if GPS_ENABLED
-    if (!gps_module.begin())
+  #if RTC_ENABLED
+    char timestamp[] = "YYYY-MM-DDThh:mm:ss";
+    CONSOLE.print(sample.timestamp.toString(timestamp));
+    CONSOLE.print(",");
+  #endif 
+
+  CONSOLE.print("Volt:");
+  CONSOLE.print(sample.in_volt);
+  CONSOLE.print(",");
+
+  sensors.print(CONSOLE, sample.sensors);
+
+  // Modules that ran out of time, their values are from an earlier cycle
+  if (sample.sensors.stale)
+  {
+    CONSOLE.print("Stale:");
+    for (uint8_t i = 0; i < xpod_sensors_t::module_count; i++)
     {
-      #if SERIAL_LOG_ENABLED
-        Serial.println("Error: Failed to initialize GPS module!");
-      #endif
+      if (sample.sensors.stale & (1 << i))
+      {
+        CONSOLE.print((const __FlashStringHelper *)xpod_sensors_t::name_of(i));
+        CONSOLE.print(" ");
+      }
     }
-  #endif
+    CONSOLE.print(",");
+  }
+
+  // Modules that failed recently, are warming up or are offline
+  if (sample.sensors.health)
+  {
+    CONSOLE.print("Health:");
+    for (uint8_t i = 0; i < xpod_sensors_t::module_count; i++)
+    {
+      if (sample.sensors.health & (1 << i))
+      {
+        CONSOLE.print((const __FlashStringHelper *)xpod_sensors_t::name_of(i));
+        CONSOLE.print(" ");
+      }
+    }
+    CONSOLE.print(",");
+  }
 
-  #if MET_ENABLED
-    attachInterrupt(digitalPinToInterrupt(3), wspeedIRQ, FALLING);  // attaching wind speed interrupt to pin 3
+  #if SQW_PACING_ENABLED
+    CONSOLE.print("Overruns:");
+    CONSOLE.print(sample.overruns);
   #endif
+}
+#endif  //SERIAL_LOG_ENABLED
 
-  initpots();
-  DownPot(0);
-  DownPot(1);
-  //DownPot(2);
-  SetPotLevel(2, 80);
+#if SERIAL_LOG_ENABLED && TELEMETRY_ENABLED
+// One sample frame per cycle, a header frame at boot and every
+// TELEMETRY_HEADER_CYCLES cycles so a capture can start at any time
+void send_telemetry(const xpod_sample_t &sample)
+{
+  static uint16_t cycles = 0;
 
-  delay(1000);
-  file.close();
-  
-  //delay(10000);
-  wdt_enable(WDTO_8S);
-  //Serial.println("reset");
+  // The header is longer than the TX ring, it and the sample behind it
+  // wait for room instead of being dropped by CONSOLE_TX_DROP
+  if (cycles == 0)
+  {
+    Paced_Print paced(CONSOLE);
+    Telemetry_Frame frame(paced);
+
+    frame.begin(TELEMETRY_HEADER);
+    write_header(frame);
+    frame.end();
+
+    frame.begin(TELEMETRY_SAMPLE);
+    sample_columns(sample, frame);
+    frame.end();
+  }
+  else
+  {
+    telemetry.begin(TELEMETRY_SAMPLE);
+    sample_columns(sample, telemetry);
+    telemetry.end();
+  }
+
+  if (++cycles >= TELEMETRY_HEADER_CYCLES)
+    cycles = 0;
 }
+#endif
 
-void loop()
+// Column names of sample_columns(), written once at the top of each file
+void write_header(Print &out)
 {
-  wdt_reset();
-  unsigned long long int startLoop = millis();
-  int motor_ctrl_val;
-  float in_volt_val;
+  out.print("DateTime,INP_Voltage");
+  xpod_sensors_t::header(out);
+  out.print(",Stale,Health");
 
-  #if OPC_ENABLED
-    opcData = opc.getData();
+  #if SQW_PACING_ENABLED
+    out.print(",Overruns");
   #endif
+}
 
-  in_volt_val = (analogRead(IN_VOLT_PIN) * 5.02 * 5) / 1023.0; //Follow up with rylee
-    #if MET_ENABLED
-      float wind_speed = get_wind_speed();
-      float wind_dir_volt = windVane.get_direction();
-      float wind_dir_degree = windVane.degree_direction(wind_dir_volt);
-      String wind_dir_cardinal = windVane.cardinal_direction(wind_dir_volt);
-    #endif //MET_ENABLED Data Gathering
+#if SDCARD_LOG_ENABLED
+// The SD log has the sequence number and CRC of every record on top
+void write_log_header(Print &out)
+{
+  write_header(out);
+  out.print(F(",Seq,CRC"));
+}
 
+// Torn records a reset left at the end of the day's file
+void report_dropped(uint8_t records)
+{
   #if SERIAL_LOG_ENABLED
-    digitalWrite(SD_CARD_CS_PIN,LOW);
-    if(!Serial) {  //check if Serial is available... if not,
-      Serial.end();      // close serial port
-      delay(100);        //wait 100 millis
-      Serial.begin(9600); // reenable serial again
+    if (records > 0)
+    {
+      CONSOLE.print(F("Log: dropped "));
+      CONSOLE.print(records);
+      CONSOLE.println(F(" partial records"));
     }
+  #endif
+}
 
-    #if RTC_ENABLED
-      rtc_date_time = rtc.now();
-      Serial.print(rtc_date_time.timestamp());
-      Serial.print(",");
-    #endif 
+// Year, month and day packed into one comparable value
+uint32_t date_key(const DateTime &date)
+{
+  return ((uint32_t)date.year() << 9) | (date.month() << 5) | date.day();
+}
 
-    Serial.print("Volt:");
-    Serial.print(in_volt_val);
-    Serial.print(",");
-  
-    Serial.print(ads_module.read4print_raw());
-    Serial.print(",");
-  
-    Serial.print("CO2:");
-    Serial.print(co2_sensor.getCO2ppm());
-    Serial.print(",");
-  
-    Serial.print(bme_module.read4print());
-    Serial.print(",");
+// Names the log file after the day of `date`
+void set_file_name(const DateTime &date)
+{
+  Line_Buffer name(fileName, sizeof(fileName));
+  name.print(xpodID);
+  name.print('_');
+  name.print(date.year());
+  name.print('_');
+  name.print(date.month());
+  name.print('_');
+  name.print(date.day());
 
-    #if QUAD_ENABLED
-      Serial.print(quad_module.read());
-      Serial.print(",");
-    #endif 
+  #if BIN_LOG_ENABLED
+    if (log_part > 0)
+    {
+      name.print('_');
+      name.print(log_part);
+    }
+    name.print(F(".bin"));
+  #else
+    name.print(F(".txt"));
+  #endif
+}
 
-    #if MQ_ENABLED
-      Serial.print(mq_module.read4print());
-      Serial.print(",");
-    #endif
-    
-    #if PMS_ENABLED
-      Serial.print(pms_module.read4print());
-    #endif
+#if BIN_LOG_ENABLED
+// Opens (or creates) the file named in fileName. A file that is not a
+// binary log, or whose columns differ from this build's, leaves the rest
+// of the day to the next part.
+bool open_log()
+{
+  if (!file.open(fileName, O_CREAT | O_RDWR))
+    return false;
 
-    #if OPC_ENABLED
-      Serial.print(opc.read4print(opcData));
-    #endif
+  if (bin_log.begin(file, write_log_header, BIN_LOG_KEYFRAME_RECORDS))
+  {
+    report_dropped(bin_log.dropped);
+    return true;
+  }
 
-    #if GPS_ENABLED
-      Serial.print(gps_module.get_gps_info_serial());
-      Serial.print(",");
-    #endif 
-      
-    #if MET_ENABLED
-      Serial.print("Wind Speed: " + String(wind_speed));
-      Serial.print(", ");
-      Serial.print("Wind Direction: " + String(wind_dir_degree) + " (" + wind_dir_cardinal + ")");
-      Serial.print(", ");
-    #endif
+  file.close();
+  log_part++;
+  set_file_name(sample.timestamp);
+  return false;
+}
 
-  #endif  //SERIAL_LOG_ENABLED
-  bme_module.read4print(); // This is necessary to make the bme read for sd logging for some reason
+bool sync_log()
+{
+  return log_ring.sync() && bin_log.sync(file);
+}
 
-  #if SDCARD_LOG_ENABLED
-    digitalWrite(STATUS_RUNNING, HIGH);
-    digitalWrite(SD_CARD_CS_PIN,LOW);
+void close_log()
+{
+  if (file.isOpen())
+  {
+    log_ring.sync();
+    bin_log.close(file);
+  }
+}
+
+// Formats the sample as a record in `line` and appends it
+bool write_record(const xpod_sample_t &sample)
+{
+  Bin_Record record(bin_log, line);
 
-    DateTime now = rtc.now();
-    fileName = xpodID + "_" + String(now.year()) + "_" + String(now.month()) + "_" + String(now.day()) + ".txt";
-    char fileNameArray[fileName.length()+1];
-    fileName.toCharArray(fileNameArray, sizeof(fileNameArray)); //Well damn, that function is nice.
-    file.open(fileNameArray, O_CREAT | O_APPEND | O_WRITE);
+  sample_columns(sample, record);
+  if (record.end())
+    return reserve_log(BIN_LOG_RECORD_BOUND(line.length())) &&
+           bin_log.append(file, log_ring, (const uint8_t *)line.c_str(), line.length(),
+                          log_seq.next());
 
-    if (file)
-    {
-      #if RTC_ENABLED
-        rtc_date_time = rtc.now();
-        file.print("\r\n");
-        file.print(rtc_date_time.timestamp());
-        file.print(",");
-      #endif
-    
-        file.print(in_volt_val);
-        file.print(",");
-    
-        file.print(ads_module.read4sd_raw());
-        file.print(",");
-    
-        file.print(co2_sensor.getCO2ppm());
-        file.print(",");
-    
-        file.print(bme_module.read4sd());
-        file.print(",");
-    
-      #if QUAD_ENABLED
-        file.print(quad_module.read());
-        file.print(",");
-      #else
-        file.print(",,,,,,,,");
-      #endif
-    
-      #if MET_ENABLED
-        file.print(String(wind_speed));
-        file.print(",");
-        file.print(String(wind_dir_degree));
-        file.print(",");
-      #else
-        file.print(",,");
-      #endif
+  #if SERIAL_LOG_ENABLED
+    CONSOLE.println("Error: columns differ from the binary log, starting a new part");
+  #endif
+  close_log();
+  log_part++;
+  set_file_name(sample.timestamp);
+  return false;
+}
+#else
+// Opens (or creates) the file named in fileName, an existing one loses
+// what a reset left of its last record
+bool open_log()
+{
+  if (!file.open(fileName, O_CREAT | O_APPEND | O_RDWR))
+    return false;
 
-      #if MQ_ENABLED
-        file.print(mq_module.read4sd());
-        file.print(",");
-      #else
-        file.print(",");
-      #endif
-    
-      #if PMS_ENABLED
-        file.print(pms_module.read4sd());
-      #else
-        file.print(",,,,,,,,,");
-      #endif
+  if (file.fileSize() == 0)
+    write_log_header(file);
+  else
+    report_dropped(recover_tail(file, line_buf, sizeof(line_buf)));
 
-      #if OPC_ENABLED
-        file.print(opc.read4sd(opcData));
-      #else
-        file.print(",,,,,");
-      #endif
-    
-      #if GPS_ENABLED
-        file.print(gps_module.get_gps_info_sd());
-        file.print(gps_module.get_gps_dtinfo());
-        file.print(",");
-      #else
-        // file.print(",,,,,,,,");
-      #endif
-    
-      file.close();
+  #if LOG_INDEX_ENABLED
+    // The log is kept without it
+    log_index.open(fileName, file.fileSize());
+  #endif
+  return true;
+}
+
+// The index follows the log to the card
+bool sync_log()
+{
+  bool ok = log_ring.sync() && file.sync();
+
+  #if LOG_INDEX_ENABLED
+    ok = log_index.sync() && ok;
+  #endif
+  return ok;
+}
+
+void close_log()
+{
+  log_ring.sync();
+  file.close();
+  #if LOG_INDEX_ENABLED
+    log_index.close();
+  #endif
+}
+
+// Formats the sample as a CSV line in `line` and appends it
+bool write_record(const xpod_sample_t &sample)
+{
+  uint32_t seq = log_seq.next();
+
+  #if LOG_INDEX_ENABLED
+    // Where the record starts, past what still waits in log_ring
+    uint32_t offset = file.curPosition() + log_ring.bytesUsed();
+  #endif
+
+  line.print("\r\n");
+  write_columns(line, sample);
+  seal_record(line, 2, seq);
+  if (!reserve_log(line.length()) ||
+      log_ring.write(line.c_str(), line.length()) != line.length())
+    return false;
+
+  #if LOG_INDEX_ENABLED
+    log_index.add(sample.timestamp.unixtime(), offset, seq);
+  #endif
+  return true;
+}
+#endif //BIN_LOG_ENABLED
+
+// Moves log_ring to the card a sector at a time, up to its last whole
+// sector. The first write after a sync() only fills the sector the sync
+// left partial, the ones after it are aligned. Without `wait` it stops
+// while the card is still busy with the previous sector.
+bool drain_log(bool wait)
+{
+  for (;;)
+  {
+    size_t n = 512 - (file.curPosition() & 511);
+
+    if (log_ring.bytesUsed() < n || (!wait && file.isBusy()))
+      return true;
+    if (log_ring.writeOut(n) != n)
+      return false;
+  }
+}
+
+// Makes room for `size` bytes in log_ring, waiting for the card if need be
+bool reserve_log(size_t size)
+{
+  return log_ring.bytesFree() >= size || drain_log(true);
+}
+
+// The day's file stays open, records reach the card with sync() every
+// SD_SYNC_RECORDS records or SD_SYNC_INTERVAL_MS, and right away when the
+// supply sags. A new day or a failed write reopens the file.
+void log_sample(const xpod_sample_t &sample)
+{
+  static uint32_t log_date = 0;
+  static uint16_t unsynced = 0;
+  static unsigned long last_sync = 0;
+  unsigned long phase_us = micros();
+  uint32_t date = date_key(sample.timestamp);
+  bool ok = false;
+
+  digitalWrite(STATUS_RUNNING, HIGH);
+  digitalWrite(SD_CARD_CS_PIN,LOW);
+
+  // The name only changes with the date of the cycle's own timestamp,
+  // close() syncs what is left of the previous day
+  if (date != log_date)
+  {
+    close_log();
+    #if BIN_LOG_ENABLED
+      log_part = 0;
+    #endif
+    set_file_name(sample.timestamp);
+    log_date = date;
+  }
+
+  // A record that does not fit the binary log's layout closes the part, it
+  // goes to the next one instead
+  for (uint8_t attempt = 0; !ok && attempt < 2; attempt++)
+  {
+    if (!file.isOpen())
+    {
+      if (open_log())
+      {
+        log_ring.begin(&file);
+        unsynced = 0;
+        last_sync = millis();
+      }
+      phase_us = profile(PROFILE_SD_OPEN, phase_us);
     }
-    else
+
+    if (!file.isOpen())
     {
       #if SERIAL_LOG_ENABLED
-        Serial.println("Failed to open SD CARD");
+        CONSOLE.println("Failed to open SD CARD");
       #endif
       digitalWrite(SD_CARD_CS_PIN,HIGH);
       // while(1);
+      return;
     }
-  #endif //SDCARD_LOG_ENABLED
 
-  // // Motor control
-  motor_ctrl_val = analogRead(MOTOR_CTRL_IN_PIN);
-  motor_ctrl_val = (((float)motor_ctrl_val / 1024) * 255);
-  //motor_ctrl_val = 200; // use this to hardcode the motor speed; the number ranges from 0-255
-  analogWrite(MOTOR_CTRL_OUT_PIN, motor_ctrl_val);
-  delay(2000);
-
-  // // Status indication
-
-  // // This all controls how long the loop lasts
-  // if((SAMPLE_TIME * 1000) - (millis() - startLoop) >= 0){
-  //   int n = floor(((SAMPLE_TIME * 1000.0) - (millis() - startLoop)) / 6000.0);
-  //   for(int i = 0; i < n; i++){  
-  //     wdt_reset();
-  //     delay(6000);
-  //   }
-  //   wdt_reset();
-  //   delay((SAMPLE_TIME * 1000) - (millis() - startLoop));
-  // }else{
-  //   delay(100);
-  // }
-  digitalWrite(STATUS_RUNNING, LOW);
-  Serial.print("\n");
+    line.clear();
+    ok = write_record(sample) && drain_log(false);
+    phase_us = profile(PROFILE_SD_WRITE, phase_us);
+
+    if (file.isOpen())
+      break;
+  }
+
+  #if SERIAL_LOG_ENABLED
+    if (line.overflowed())
+      CONSOLE.println("Error: log line longer than LINE_BUFFER_SIZE");
+  #endif
+
+  if (ok && (++unsynced >= SD_SYNC_RECORDS || millis() - last_sync >= SD_SYNC_INTERVAL_MS ||
+             sample.in_volt < POWER_FAIL_VOLTS))
+  {
+    ok = sync_log();
+    unsynced = 0;
+    last_sync = millis();
+    profile(PROFILE_SD_SYNC, phase_us);
+  }
+
+  if (!ok)
+  {
+    #if SERIAL_LOG_ENABLED
+      CONSOLE.println("Error: SD write failed, reopening the log");
+    #endif
+    close_log();
+  }
+}
+
+void write_columns(Print &out, const xpod_sample_t &sample)
+{
+  CSV_Writer csv(out);
+
+  sample_columns(sample, csv);
+}
+#endif //SDCARD_LOG_ENABLED
+
+#if SUMMARY_ENABLED && SDCARD_LOG_ENABLED && RTC_ENABLED
+// Adds the sample to the current minute. A sample in a new minute first
+// closes the previous one: its line is written and it goes into the hour,
+// the same for the hour when that changed too.
+void summarize_sample(const xpod_sample_t &sample)
+{
+  static uint32_t minute = 0;
+  static DateTime minute_start, hour_start;
+  uint32_t now = sample.timestamp.unixtime() / 60;
+
+  if (now != minute)
+  {
+    if (minute_summary.samples > 0)
+    {
+      write_summary(minute_summary, minute_start, F("_1min"));
+      hour_summary.merge(minute_summary);
+      minute_summary.clear();
+    }
+
+    if (now / 60 != minute / 60 && hour_summary.samples > 0)
+    {
+      write_summary(hour_summary, hour_start, F("_1h"));
+      hour_summary.clear();
+    }
+
+    if (hour_summary.samples == 0)
+      hour_start = DateTime(now / 60 * 3600);
+    minute_start = DateTime(now * 60);
+    minute = now;
+  }
+
+  minute_summary.begin();
+  sample_columns(sample, minute_summary);
+  minute_summary.end();
+}
+
+// Appends a line to the summary file of the period's day, a file without
+// its header gets it first
+void write_summary(const xpod_summary_t &summary, const DateTime &start,
+                   const __FlashStringHelper *suffix)
+{
+  char summaryName[sizeof(fileName)];
+  Line_Buffer name(summaryName, sizeof(summaryName));
+  SdFile out;
+
+  name.print(xpodID);
+  name.print('_');
+  name.print(start.year());
+  name.print('_');
+  name.print(start.month());
+  name.print('_');
+  name.print(start.day());
+  name.print(suffix);
+  name.print(F(".txt"));
+
+  if (!out.open(summaryName, O_CREAT | O_APPEND | O_WRITE))
+    return;
+
+  if (out.fileSize() == 0)
+    summary.print_header(out, write_header);
+
+  // A line is longer than line_buf, SdFat's sector cache takes it
+  out.print("\r\n");
+  summary.print(out, start);
+  out.close();
+}
+#endif
+
+// Records the time since `since` for a loop phase and returns micros()
+unsigned long profile(uint8_t phase, unsigned long since)
+{
+  unsigned long now = micros();
+
+  #if PROFILER_ENABLED
+    profiler.record(phase, now - since);
+  #endif
+
+  return now;
+}
+
+#if PROFILER_ENABLED || DOWNLOAD_SERVER
+// Commands on the serial port: 'p' dumps the phase timings, the download
+// commands are lines (download.h)
+void serial_commands()
+{
+  while (CONSOLE.available() > 0)
+  {
+    char c = CONSOLE.read();
+
+    #if DOWNLOAD_SERVER
+      if (download.receive(c))
+        continue;
+    #endif
+
+    #if PROFILER_ENABLED
+      if (c == 'p')
+      {
+        profiler.print(CONSOLE);
+        #if CONSOLE_UART_ENABLED
+          CONSOLE.print(F("console_dropped,"));
+          CONSOLE.println(Console.dropped());
+        #endif
+        #if RAM_MONITOR_ENABLED
+          ram_monitor.scan();
+          ram_monitor.print(CONSOLE);
+        #endif
+      }
+    #endif
+  }
+}
+#endif
+
+// The sample output stays off the console while a download runs
+bool console_quiet()
+{
+  #if DOWNLOAD_SERVER
+    return download.active();
+  #else
+    return false;
+  #endif
+}
+
+#if DOWNLOAD_SERVER
+// Runs while Sample_Clock waits for the next slot. The slot's end is not
+// known here, a frame (46 ms at 115200 baud) can make the cycle that late.
+void idle_console()
+{
+  serial_commands();
+  if (!download.service(100))
+    idle_wait();
+}
+#endif
+
+// A millisecond at most: the init tasks, then asleep until the next
+// interrupt, or delay(1)
+void idle_wait()
+{
+  init_tasks();
+
+  #if IDLE_SLEEP_ENABLED
+    idle_sleep.sleep();
+  #else
+    wdt_reset();
+    delay(1);
+  #endif
+}
+
+// What setup() left to do: the digital pots and the sensors that are warming
+// up, a bounded step of each per call
+void init_tasks()
+{
+  ServicePots();
+
+  #if SERIAL_LOG_ENABLED
+    sensors.warm_up(console_quiet() ? NULL : &CONSOLE);
+  #else
+    sensors.warm_up(NULL);
+  #endif
 }
-#if MET_ENABLED
-//Returns the instataneous wind speed
-float get_wind_speed(){
-  float deltaTime = millis() - lastWindCheck; //750ms
 
-  deltaTime /= 1000.0; //Covert to seconds
+#if PROFILER_ENABLED
+// Time asleep and energy of the cycle that ended at `start_us`, the idle
+// part included
+void account_cycle(unsigned long start_us)
+{
+  static unsigned long last_start_us;
+  static bool started = false;
+  uint32_t slept_us = 0;
+
+  #if IDLE_SLEEP_ENABLED
+    slept_us = idle_sleep.take_slept_us();
+  #endif
+
+  if (started)
+  {
+    uint32_t active_us = (start_us - last_start_us) - slept_us;
 
-  float windSpeed = (float)windClicks / deltaTime; //3 / 0.750s = 4
+    profiler.record(PROFILE_SLEEP, slept_us);
+    profiler.record(PROFILE_ENERGY, (active_us / 1000) * POWER_ACTIVE_MW +
+                                    (slept_us / 1000) * POWER_IDLE_MW);
+  }
+
+  last_start_us = start_us;
+  started = true;
+}
+
+#if RAM_MONITOR_ENABLED
+// High-water scan of the stack, the console warns when it came close to the
+// heap
+void check_ram()
+{
+  ram_monitor.scan();
+
+  #if SERIAL_LOG_ENABLED
+    if (ram_monitor.measured() && ram_monitor.free_min() < RAM_LOW_BYTES && !console_quiet())
+    {
+      CONSOLE.print(F("Warning: RAM low, "));
+      CONSOLE.print(ram_monitor.free_min());
+      CONSOLE.println(F(" bytes free at the deepest stack"));
+    }
+  #endif
+}
+#endif
+
+#if DIAG_LOG_ENABLED && SDCARD_LOG_ENABLED
+// One line per profiler window: last, min, max and mean of every phase, then
+// the RAM low-water mark
+void log_profile(const DateTime &timestamp)
+{
+  static const char stat_names[][6] = {"_last", "_min", "_max", "_mean"};
+  char diagName[sizeof(fileName)];
+  Line_Buffer name(diagName, sizeof(diagName));
+  SdFile diag;
 
-  windClicks = 0; //Reset and start watching for new wind
-  lastWindCheck = millis();
+  name.print(xpodID);
+  name.print(F("_diag.txt"));
 
-  windSpeed *= 1.492; //4 * 1.492 = 5.968MPH
+  if (!diag.open(diagName, O_CREAT | O_APPEND | O_WRITE))
+    return;
+
+  if (diag.fileSize() == 0)
+  {
+    diag.print("DateTime,cycles");
+    for (uint8_t i = 0; i < profiler.phases(); i++)
+    {
+      for (uint8_t j = 0; j < 4; j++)
+      {
+        diag.print(',');
+        diag.print((const __FlashStringHelper *)profiler.name(i));
+        diag.print(stat_names[j]);
+      }
+    }
+
+    #if RAM_MONITOR_ENABLED
+      diag.print(",ram_free_min,ram_heap_max");
+    #endif
+  }
+
+  // Written straight to the file like the header; 4 stats a phase
+  // soon outgrow the shared line buffer
+  diag.print("\r\n");
+
+  CSV_Writer csv(diag);
+
+  #if RTC_ENABLED
+    char ts[] = "YYYY-MM-DDThh:mm:ss";
+    csv.put_str(timestamp.toString(ts));
+  #else
+    csv.skip();
+  #endif
+  csv.put_uint(profiler.cycles());
+
+  for (uint8_t i = 0; i < profiler.phases(); i++)
+  {
+    const phase_stats_t &stats = profiler.stats(i);
+
+    csv.put_uint(stats.last);
+    csv.put_uint(stats.min);
+    csv.put_uint(stats.max);
+    csv.put_uint(profiler.mean(i));
+  }
+
+  #if RAM_MONITOR_ENABLED
+    if (ram_monitor.measured())
+    {
+      csv.put_uint(ram_monitor.free_min());
+      csv.put_uint(ram_monitor.heap_max());
+    }
+    else
+    {
+      csv.skip();
+      csv.skip();
+    }
+  #endif
 
-  return (windSpeed);
+  diag.close();
 }
 #endif
+#endif  //PROFILER_ENABLED
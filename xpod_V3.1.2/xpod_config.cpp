@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * @file    xpod_config.cpp
+ * @brief   Sampling settings of a deployment, read from the SD card at boot.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#include <stddef.h>
+#include <SdFat.h>
+
+#include "xpod_config.h"
+#include "xpod_node.h"
+#include "ads_module.h"
+#include "bme_module.h"
+#include "quad_module.h"
+#include "mq_module.h"
+
+// Longest line, comment included
+#define CONFIG_MAX_LINE       64
+
+xpod_config_t xpod_config = {
+  LOOP_PERIOD_MS,
+  SAMPLE_PERIOD_S,
+  0xFFFF,
+  ADS_FIGARO_SAMPLES,
+  ADS_HEATER_SAMPLES,
+  ADS_RATE_SPS,
+  QUAD_BITS,
+  BME_OS_TEMP,
+  BME_OS_HUM,
+  BME_OS_PRES,
+  BME_FILTER,
+  MQ_SAMPLES
+};
+
+static const char disabled_key[] PROGMEM = "disabled_modules";
+
+// A setting is a number in [min, max], or one of `allowed` when it has any
+struct config_key_t
+{
+    const char *name;
+    uint8_t offset;
+    uint8_t size;
+    uint16_t min;
+    uint16_t max;
+    const uint16_t *allowed;
+    uint8_t allowed_count;
+};
+
+static const uint16_t quad_resolutions[] PROGMEM = {12, 14, 16};
+static const uint16_t bme_oversampling[] PROGMEM = {0, 1, 2, 4, 8, 16};
+static const uint16_t bme_filters[] PROGMEM = {0, 1, 3, 7, 15, 31, 63, 127};
+
+static const char key_loop_period[] PROGMEM = "loop_period_ms";
+static const char key_sample_period[] PROGMEM = "sample_period_s";
+static const char key_figaro_samples[] PROGMEM = "ads_figaro_samples";
+static const char key_heater_samples[] PROGMEM = "ads_heater_samples";
+static const char key_ads_rate[] PROGMEM = "ads_rate_sps";
+static const char key_quad_bits[] PROGMEM = "quad_bits";
+static const char key_os_temp[] PROGMEM = "bme_os_temp";
+static const char key_os_hum[] PROGMEM = "bme_os_hum";
+static const char key_os_pres[] PROGMEM = "bme_os_pres";
+static const char key_filter[] PROGMEM = "bme_filter";
+static const char key_mq_samples[] PROGMEM = "mq_samples";
+
+#define FIELD(field) offsetof(xpod_config_t, field), sizeof(((xpod_config_t *)0)->field)
+#define ALLOWED(list) list, sizeof(list) / sizeof(list[0])
+
+static const config_key_t keys[] PROGMEM = {
+  {key_loop_period, FIELD(loop_period_ms), 100, 60000, NULL, 0},
+  {key_sample_period, FIELD(sample_period_s), 1, 60, NULL, 0},
+  {key_figaro_samples, FIELD(ads_figaro_samples), 1, 100, NULL, 0},
+  {key_heater_samples, FIELD(ads_heater_samples), 1, 100, NULL, 0},
+  {key_ads_rate, FIELD(ads_rate_sps), 0, 0, ALLOWED(ads_rates)},
+  {key_quad_bits, FIELD(quad_bits), 0, 0, ALLOWED(quad_resolutions)},
+  {key_os_temp, FIELD(bme_os_temp), 0, 0, ALLOWED(bme_oversampling)},
+  {key_os_hum, FIELD(bme_os_hum), 0, 0, ALLOWED(bme_oversampling)},
+  {key_os_pres, FIELD(bme_os_pres), 0, 0, ALLOWED(bme_oversampling)},
+  {key_filter, FIELD(bme_filter), 0, 0, ALLOWED(bme_filters)},
+  {key_mq_samples, FIELD(mq_samples), 1, 100, NULL, 0},
+};
+
+#define KEY_COUNT             (sizeof(keys) / sizeof(keys[0]))
+
+static char *trim(char *text)
+{
+  char *end;
+
+  while (*text == ' ' || *text == '\t')
+    text++;
+  end = text + strlen(text);
+  while (end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n'))
+    end--;
+  *end = '\0';
+
+  return text;
+}
+
+static bool valid(const config_key_t &key, uint16_t value)
+{
+  if (!key.allowed)
+    return value >= key.min && value <= key.max;
+
+  for (uint8_t i = 0; i < key.allowed_count; i++)
+  {
+    if (pgm_read_word(&key.allowed[i]) == value)
+      return true;
+  }
+  return false;
+}
+
+// Names separated by commas or blanks, every one has to be a module
+static bool parse_modules(char *value, module_name_f module_name, uint8_t module_count)
+{
+  uint16_t mask = 0xFFFF;
+
+  for (char *name = strtok(value, ", \t"); name; name = strtok(NULL, ", \t"))
+  {
+    uint8_t i = 0;
+
+    while (i < module_count && strcmp_P(name, module_name(i)) != 0)
+      i++;
+    if (i == module_count)
+      return false;
+    mask &= ~(1 << i);
+  }
+
+  xpod_config.module_mask = mask;
+  return true;
+}
+
+static bool parse_line(char *line, module_name_f module_name, uint8_t module_count)
+{
+  char *comment = strchr(line, '#');
+  char *equals;
+  char *key;
+  char *value;
+
+  if (comment)
+    *comment = '\0';
+  line = trim(line);
+  if (*line == '\0')
+    return true;
+
+  equals = strchr(line, '=');
+  if (!equals)
+    return false;
+  *equals = '\0';
+  key = trim(line);
+  value = trim(equals + 1);
+
+  if (strcmp_P(key, disabled_key) == 0)
+    return parse_modules(value, module_name, module_count);
+
+  for (uint8_t i = 0; i < KEY_COUNT; i++)
+  {
+    config_key_t entry;
+    char *end;
+    unsigned long number;
+
+    memcpy_P(&entry, &keys[i], sizeof(entry));
+    if (strcmp_P(key, entry.name) != 0)
+      continue;
+
+    number = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || number > 0xFFFF || !valid(entry, number))
+      return false;
+
+    uint8_t *field = (uint8_t *)&xpod_config + entry.offset;
+
+    if (entry.size == 1)
+      *field = number;
+    else
+    {
+      uint16_t word = number;
+      memcpy(field, &word, sizeof(word));
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// Name of a module whose conversions no longer fit its budget, NULL if none
+static const char *over_budget()
+{
+  if (ADS_Module::conversion_ms() > ADS_Module::budget_ms)
+    return ADS_Module::name;
+#if QUAD_ENABLED
+  if (QUAD_Module::conversion_ms() > QUAD_Module::budget_ms)
+    return QUAD_Module::name;
+#endif
+#if MQ_ENABLED
+  if (MQ_Module::conversion_ms() > MQ_Module::budget_ms)
+    return MQ_Module::name;
+#endif
+  return NULL;
+}
+
+bool config_load(const char *path, Print *log, module_name_f module_name,
+                 uint8_t module_count)
+{
+  SdFile file;
+  char line[CONFIG_MAX_LINE];
+  uint16_t number = 0;
+  int length;
+
+  if (!file.open(path, O_RDONLY))
+    return false;
+
+  while ((length = file.fgets(line, sizeof(line))) > 0)
+  {
+    bool whole = line[length - 1] == '\n' || !file.available();
+    xpod_config_t before = xpod_config;
+    const char *over = NULL;
+
+    number++;
+    // The rest of a line that did not fit
+    while (!whole && (length = file.fgets(line, sizeof(line))) > 0)
+      whole = line[length - 1] == '\n';
+
+    if (whole && parse_line(line, module_name, module_count) && !(over = over_budget()))
+      continue;
+
+    xpod_config = before;
+    if (log)
+    {
+      log->print(F("Error: "));
+      log->print(path);
+      log->print(F(" line "));
+      log->print(number);
+      log->print(F(" ignored"));
+      if (over)
+      {
+        log->print(F(", "));
+        log->print((const __FlashStringHelper *)over);
+        log->print(F(" would overrun its budget"));
+      }
+      log->println();
+    }
+  }
+
+  file.close();
+  return true;
+}
+
+void config_print(Print &out, module_name_f module_name, uint8_t module_count)
+{
+  for (uint8_t i = 0; i < KEY_COUNT; i++)
+  {
+    config_key_t entry;
+    const uint8_t *field;
+    uint16_t value;
+
+    memcpy_P(&entry, &keys[i], sizeof(entry));
+    field = (const uint8_t *)&xpod_config + entry.offset;
+    if (entry.size == 1)
+      value = *field;
+    else
+      memcpy(&value, field, sizeof(value));
+
+    out.print((const __FlashStringHelper *)entry.name);
+    out.print(F(" = "));
+    out.println(value);
+  }
+
+  out.print((const __FlashStringHelper *)disabled_key);
+  out.print(F(" ="));
+  for (uint8_t i = 0; i < module_count; i++)
+  {
+    if (!(xpod_config.module_mask & (1 << i)))
+    {
+      out.print(' ');
+      out.print((const __FlashStringHelper *)module_name(i));
+    }
+  }
+  out.println();
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * @file    xpod_config.h
+ * @brief   Sampling settings of a deployment, read from the SD card at boot.
+ *
+ *          xpod_config starts out with the compile-time defaults of
+ *          xpod_node.h and the module headers. config_load() overrides them
+ *          from CONFIG_FILE_NAME, a text file of `key = value` lines:
+ *
+ *            # 4 s cycles, faster ADCs and no particle counter
+ *            loop_period_ms = 4000
+ *            ads_rate_sps = 250
+ *            quad_bits = 14
+ *            disabled_modules = PMS5003
+ *
+ *          Keys (defaults in parentheses):
+ *            loop_period_ms      cycle length, millis() pacing (LOOP_PERIOD_MS)
+ *            sample_period_s     cycle length, SQW pacing (SAMPLE_PERIOD_S)
+ *            disabled_modules    module names as in the console, comma
+ *                                separated; their columns stay empty
+ *            ads_figaro_samples  conversions averaged per Figaro channel
+ *            ads_heater_samples  conversions averaged per heater channel
+ *            ads_rate_sps        ADS1115 data rate, 8 16 32 64 128 250 475 860
+ *            quad_bits           MCP3424 resolution, 12 14 16
+ *            bme_os_temp         BME680 oversampling, 0 1 2 4 8 16
+ *            bme_os_hum
+ *            bme_os_pres
+ *            bme_filter          BME680 IIR filter, 0 1 3 7 15 31 63 127
+ *            mq_samples          conversions averaged for the MQ131
+ *
+ *          Text after '#' is a comment. A line that is not understood is
+ *          reported on the log and leaves its setting alone; a missing
+ *          file leaves them all. The module budgets stay compile-time: a
+ *          line after which the ADS1115, MCP3424 or MQ131 conversions would
+ *          no longer fit in their budget is reported and ignored too, so
+ *          fewer samples have to come before the slower rate they allow.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _XPOD_CONFIG_H
+#define _XPOD_CONFIG_H
+
+#include <Arduino.h>
+
+// PROGMEM name of the module at index, as Sensor_Registry::name_of()
+typedef const char *(*module_name_f)(uint8_t index);
+
+struct xpod_config_t
+{
+    uint16_t loop_period_ms;
+    uint8_t sample_period_s;
+    // Bit per module in registry order, a clear bit is never started
+    uint16_t module_mask;
+
+    uint8_t ads_figaro_samples;
+    uint8_t ads_heater_samples;
+    uint16_t ads_rate_sps;
+    uint8_t quad_bits;
+    uint8_t bme_os_temp;
+    uint8_t bme_os_hum;
+    uint8_t bme_os_pres;
+    uint8_t bme_filter;
+    uint8_t mq_samples;
+} __attribute__((packed));
+
+extern xpod_config_t xpod_config;
+
+// Reads `path` from the card's working directory into xpod_config, false
+// when there is no such file. Problems go to `log` when it is not NULL.
+bool config_load(const char *path, Print *log, module_name_f module_name,
+                 uint8_t module_count);
+
+// The settings as `key = value` lines, the format config_load() reads
+void config_print(Print &out, module_name_f module_name, uint8_t module_count);
+
+#endif  //_XPOD_CONFIG_H
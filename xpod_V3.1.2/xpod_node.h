@@ -29,10 +29,123 @@
 
 #define MOTOR_CTRL_IN_PIN     A14
 #define MOTOR_CTRL_OUT_PIN    2
-#define CO2_I2C_ADDR          0x31
 #define IN_VOLT_PIN           A0
 #define SD_CARD_CS_PIN        53
 
+// Serial console. CONSOLE_UART_ENABLED replaces Serial with the interrupt
+// driven TX ring of console_serial.h, CONSOLE_TX_POLICY is CONSOLE_TX_DROP
+// or CONSOLE_TX_BLOCK for a full ring.
+#define CONSOLE_UART_ENABLED  1
+#define CONSOLE_BAUD          115200
+#define CONSOLE_TX_POLICY     CONSOLE_TX_DROP
+
+// Log download over the console (download.h), the transfer runs at
+// DOWNLOAD_BAUD and ends DOWNLOAD_IDLE_MS after the host's last command.
+// 250000, 500000 and 1000000 are exact at 16 MHz.
+#define DOWNLOAD_ENABLED      1
+#define DOWNLOAD_BAUD         1000000UL
+#define DOWNLOAD_IDLE_MS      10000UL
+
+// Binary sample frames on the console in place of the labelled text, see
+// telemetry.h. The header frame repeats every TELEMETRY_HEADER_CYCLES cycles.
+#define TELEMETRY_ENABLED     0
+#define TELEMETRY_HEADER_CYCLES 60
+
+#define LOOP_PERIOD_MS        2000
+
+// Sampling settings read from CONFIG_FILE_NAME on the card at boot, see
+// xpod_config.h. LOOP_PERIOD_MS, SAMPLE_PERIOD_S and the oversampling of the
+// module headers are their defaults.
+#define CONFIG_FILE_ENABLED   1
+#define CONFIG_FILE_NAME      "XPOD.CFG"
+
+// A sensor is taken offline after HEALTH_OFFLINE_FAILURES failed cycles in a
+// row or a failed begin(), and its begin() is retried after
+// HEALTH_RETRY_MIN_MS, doubling each time up to HEALTH_RETRY_MAX_MS
+#define HEALTH_OFFLINE_FAILURES 5
+#define HEALTH_RETRY_MIN_MS   10000UL
+#define HEALTH_RETRY_MAX_MS   300000UL
+
+// The daily log file stays open. Its records are flushed to the card every
+// SD_SYNC_RECORDS records or SD_SYNC_INTERVAL_MS, whichever comes first, and
+// on every record while the input voltage is below POWER_FAIL_VOLTS.
+#define SD_SYNC_RECORDS       15
+#define SD_SYNC_INTERVAL_MS   30000UL
+#define POWER_FAIL_VOLTS      10.5
+
+// Log output is buffered in RAM and written in whole 512 byte sectors while
+// the card is idle; a sync, a new day or a write error flush the rest.
+#define LOG_RING_SIZE         1024
+
+// Log records carry a sequence number that survives resets, see
+// log_record.h. The EEPROM mark at LOG_SEQ_EEPROM_ADDR moves every
+// LOG_SEQ_BLOCK records.
+#define LOG_SEQ_EEPROM_ADDR   0
+#define LOG_SEQ_BLOCK         1024UL
+
+// Binary records instead of CSV lines in the daily log (bin_log.h). The
+// file is preallocated for a day of records of BIN_LOG_PREALLOC_RECORD
+// bytes at the cycle length of XPOD.CFG when it is created; convert it
+// with tools/xpod_binlog. Records are delta coded against the previous one
+// with a full keyframe every BIN_LOG_KEYFRAME_RECORDS, 0 stores them all in
+// full.
+#define BIN_LOG_ENABLED       0
+#define BIN_LOG_PREALLOC_RECORD 256UL
+#define BIN_LOG_KEYFRAME_RECORDS 60
+
+// Sparse time index of the CSV log in a .idx file next to it (log_index.h),
+// an entry for the first record of every LOG_INDEX_SECONDS. The binary log
+// has none.
+#define LOG_INDEX_ENABLED     1
+#define LOG_INDEX_SECONDS     60
+
+// Mean, min, max and standard deviation of every numeric column over each
+// minute and each hour, in <id>_<date>_1min.txt and _1h.txt next to the
+// daily log. Needs the RTC.
+#define SUMMARY_ENABLED       1
+
+// Pace cycles with the DS3231 1 Hz SQW output instead of millis(). SQW has to
+// be wired to an external interrupt pin (2, 3, 18, 19, 20 or 21 on the Mega)
+// that nothing drives: 18 and 19 are Serial1 (PMS5003), 20 and 21 I2C, 3 the
+// wind speed input and 2 the motor output. The build stops on a conflict,
+// so with both the PMS5003 and the met station there is no pin left.
+#define SQW_PACING_ENABLED    0
+#if !MET_ENABLED
+#define RTC_SQW_PIN           3
+#else
+#define RTC_SQW_PIN           18
+#endif
+#define SAMPLE_PERIOD_S       2
+
+// The rest of each cycle is slept through in SLEEP_MODE_IDLE (idle_sleep.h)
+// instead of spun in delay(). Timer0, the UART receivers and the external
+// interrupts (SQW, wind on pin 3) keep running.
+#define IDLE_SLEEP_ENABLED    1
+
+// Draw of the MCU awake and in idle sleep, for the profiler's energy per
+// cycle. ATmega2560 at 16 MHz and 5 V from the datasheet's typical curves;
+// the board, heaters and fans are not in them, put measured figures here to
+// compare whole-node modes.
+#define POWER_ACTIVE_MW       70
+#define POWER_IDLE_MW         20
+
+// Phase timings of the loop, dumped on serial with 'p' and written every
+// PROFILER_LOG_CYCLES cycles to the diagnostics log when DIAG_LOG_ENABLED
+#define PROFILER_ENABLED      1
+#define DIAG_LOG_ENABLED      1
+#define PROFILER_LOG_CYCLES   30
+
+// Stack painting at boot and a scan for the stack's high-water mark with each
+// profiler window (ram_monitor.h). The fewest free bytes seen go into the
+// profiler's dump and diagnostics log, and the console warns below
+// RAM_LOW_BYTES.
+#define RAM_MONITOR_ENABLED   1
+#define RAM_LOW_BYTES         512
+
+// Prints the cycles per log column of Print::print() and of the fixed-point
+// formatter at boot
+#define FORMAT_BENCH_ENABLED  0
+
 #define STATUS_RUNNING        12
 #define STATUS_ERROR          11
 #define STATUS_HALTED         13
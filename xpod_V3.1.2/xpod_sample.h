@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * @file    xpod_sample.h
+ * @brief   Sensor list and sample record of one cycle.
+ *
+ *          The acquisition stage fills one record per cycle and the serial
+ *          and SD outputs only format from it, so every sensor is read once
+ *          and both outputs hold the same values.
+ *
+ *          The order of xpod_sensors_t is the column order of the log. A
+ *          module switched off in xpod_node.h keeps its (empty) columns.
+ *
+ * @author  Hannigan Lab
+ * @date    Oct 18 2026
+ ******************************************************************************/
+#ifndef _XPOD_SAMPLE_H
+#define _XPOD_SAMPLE_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#include "xpod_node.h"
+#include "sensor_registry.h"
+#include "ads_module.h"
+#include "co2_module.h"
+#include "bme_module.h"
+#include "quad_module.h"
+#include "mq_module.h"
+#include "pms_module.h"
+#include "OPC.h"
+#include "gps_module.h"
+#include "wind_vane.h"
+
+typedef Sensor_Registry<
+    ADS_Module,
+    CO2_Module,
+    BME_Module,
+    Enable<QUAD_ENABLED, QUAD_Module>::type,
+    Enable<MET_ENABLED, MET_Module>::type,
+    Enable<MQ_ENABLED, MQ_Module>::type,
+    Enable<PMS_ENABLED, PMS_Module>::type,
+    Enable<OPC_ENABLED, OPC>::type,
+    Enable<GPS_ENABLED, GPS_Module>::type
+> xpod_sensors_t;
+
+static_assert(xpod_sensors_t::module_count <= 16, "stale and health masks hold 16 modules");
+
+struct xpod_sample_t
+{
+    DateTime timestamp;
+    uint32_t overruns;
+    float in_volt;
+
+    xpod_sensors_t::sample_type sensors;
+};
+
+// Columns of one log line, in the order of the header, into any column sink
+// (CSV_Writer for the card, Telemetry_Frame for the serial frames)
+template <class Sink>
+void sample_columns(const xpod_sample_t &sample, Sink &sink)
+{
+  #if RTC_ENABLED
+    sink.put_time(sample.timestamp);
+  #else
+    sink.skip();
+  #endif
+
+  sink.put_float(sample.in_volt, 2);
+
+  xpod_sensors_t::columns(sample.sensors, sink);
+  sink.put_uint(sample.sensors.stale);
+  sink.put_uint(sample.sensors.health);
+
+  #if SQW_PACING_ENABLED
+    sink.put_uint(sample.overruns);
+  #endif
+}
+
+#endif  //_XPOD_SAMPLE_H